@@ -10,6 +10,9 @@
 #ifndef __VISIODOCUMENT_H__
 #define __VISIODOCUMENT_H__
 
+#include <memory>
+#include <vector>
+
 #include <librevenge/librevenge.h>
 
 #ifdef DLL_EXPORT
@@ -29,6 +32,65 @@
 namespace libvisio
 {
 
+class VSDPages;
+
+class VisioParseOptionsImpl;
+
+// Options of parsing. The fields are reached through accessors only, so that
+// options can be added without breaking the ABI.
+class VisioParseOptions
+{
+public:
+  enum CurveOutput
+  {
+    // Splines of degree 1 to 3 without weights as line, quadratic and cubic Bezier segments
+    CURVES_AS_BEZIER,
+    // Like CURVES_AS_BEZIER, but quadratic segments are raised to cubic ones
+    CURVES_AS_CUBIC_BEZIER,
+    // All splines flattened to line segments
+    CURVES_AS_LINES
+  };
+
+  VSDAPI VisioParseOptions();
+  VSDAPI VisioParseOptions(const VisioParseOptions &other);
+  VSDAPI ~VisioParseOptions();
+  VSDAPI VisioParseOptions &operator=(const VisioParseOptions &other);
+
+  VSDAPI void setCurveTolerance(double tolerance, bool isRelative = false);
+  VSDAPI double getCurveTolerance() const;
+  VSDAPI bool isCurveToleranceRelative() const;
+
+  VSDAPI void setCurveOutput(CurveOutput curveOutput);
+  VSDAPI CurveOutput getCurveOutput() const;
+
+  VSDAPI void setThreadCount(unsigned threadCount);
+  VSDAPI unsigned getThreadCount() const;
+
+private:
+  std::unique_ptr<VisioParseOptionsImpl> m_impl;
+};
+
+class VisioDocumentHandle
+{
+public:
+  VSDAPI ~VisioDocumentHandle();
+
+  VSDAPI bool draw(librevenge::RVNGDrawingInterface *painter) const;
+
+  VSDAPI bool drawPage(librevenge::RVNGDrawingInterface *painter, unsigned index) const;
+
+  VSDAPI unsigned pageCount() const;
+
+private:
+  explicit VisioDocumentHandle(std::unique_ptr<const VSDPages> pages);
+  VisioDocumentHandle(const VisioDocumentHandle &);
+  VisioDocumentHandle &operator=(const VisioDocumentHandle &);
+
+  const std::unique_ptr<const VSDPages> m_pages;
+
+  friend class VisioDocument;
+};
+
 class VisioDocument
 {
 public:
@@ -37,6 +99,16 @@ public:
 
   static VSDAPI bool parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter);
 
+  static VSDAPI bool parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const VisioParseOptions &options);
+
+  static VSDAPI bool parsePages(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const std::vector<unsigned> &pageSelection);
+
+  static VSDAPI bool parsePages(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const std::vector<unsigned> &pageSelection, const VisioParseOptions &options);
+
+  static VSDAPI std::shared_ptr<const VisioDocumentHandle> load(librevenge::RVNGInputStream *input);
+
+  static VSDAPI std::shared_ptr<const VisioDocumentHandle> load(librevenge::RVNGInputStream *input, const VisioParseOptions &options);
+
   static VSDAPI bool parseStencils(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter);
 };
 
@@ -17,6 +17,7 @@
 #include "libvisio_utils.h"
 #include "libvisio_xml.h"
 #include "VSDContentCollector.h"
+#include "VSDRecordingCollector.h"
 #include "VSDStylesCollector.h"
 #include "VSDXMLHelper.h"
 #include "VSDXMLTokenMap.h"
@@ -43,17 +44,48 @@ bool libvisio::VDXParser::parseMain()
     std::vector<std::list<unsigned> > documentPageShapeOrders;
 
     VSDStylesCollector stylesCollector(groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders);
-    m_collector = &stylesCollector;
+    VSDRecordingCollector recordingCollector(&stylesCollector, m_maxRecordSize);
+    if (m_singlePass)
+    {
+      m_recorder = &recordingCollector;
+      m_collector = &recordingCollector;
+    }
+    else
+      m_collector = &stylesCollector;
     m_input->seek(0, librevenge::RVNG_SEEK_SET);
+    if (m_pageSelection.isActive() && !m_extractStencils)
+      scanPages(m_input);
+    m_isFirstPass = true;
     if (!processXmlDocument(m_input))
+    {
+      m_isFirstPass = false;
+      m_recorder = nullptr;
       return false;
+    }
+    m_isFirstPass = false;
+    m_recorder = nullptr;
 
     VSDStyles styles = stylesCollector.getStyleSheets();
     const std::optional<unsigned> varColInd = stylesCollector.getvariationColorIndex();
     const std::optional<unsigned> varStyInd = stylesCollector.getvariationStyleIndex();
 
     VSDContentCollector contentCollector(m_painter, groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders, styles, m_stencils, varColInd, varStyInd);
+    contentCollector.setPageSelection(m_pageSelection);
+    contentCollector.setPagesOutput(m_pagesOutput);
+    contentCollector.setParseOptions(m_parseOptions);
     m_collector = &contentCollector;
+    if (m_singlePass && !recordingCollector.isDiscarded())
+    {
+      const auto createCollector = [&]()
+      {
+        std::unique_ptr<VSDContentCollector> collector(
+          new VSDContentCollector(nullptr, groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders, styles, m_stencils, varColInd, varStyInd));
+        collector->setParseOptions(m_parseOptions);
+        return collector;
+      };
+      return replay(recordingCollector, contentCollector, createCollector);
+    }
+
     m_input->seek(0, librevenge::RVNG_SEEK_SET);
     if (!processXmlDocument(m_input))
       return false;
@@ -62,6 +94,8 @@ bool libvisio::VDXParser::parseMain()
   }
   catch (...)
   {
+    m_isFirstPass = false;
+    m_recorder = nullptr;
     return false;
   }
 }
@@ -98,6 +132,11 @@ void libvisio::VDXParser::processXmlNode(xmlTextReaderPtr reader)
   int tokenId = getElementToken(reader);
   int tokenType = xmlTextReaderNodeType(reader);
   _handleLevelChange((unsigned)getElementDepth(reader));
+  if (XML_READER_TYPE_ELEMENT == tokenType && _isSkeletonScan() && _isContentElement(tokenId))
+  {
+    skipElement(reader);
+    return;
+  }
   switch (tokenId)
   {
   case XML_COLORS:
@@ -72,51 +72,50 @@ void libvisio::VSD5Parser::readPointerInfo(librevenge::RVNGInputStream *input, u
   VSD_DEBUG_MSG(("VSD5Parser::readPointerInfo ptrType %u shift %u pointerCount %i\n", ptrType, shift, pointerCount));
 }
 
-bool libvisio::VSD5Parser::getChunkHeader(librevenge::RVNGInputStream *input)
+bool libvisio::VSD5Parser::getChunkHeader(VSDBinaryReader &input)
 {
-  unsigned char tmpChar = 0;
-  while (!input->isEnd() && !tmpChar)
-    tmpChar = readU8(input);
-
-  if (input->isEnd())
+  input.skipZeroBytes();
+  // A lone trailing byte cannot start a chunk
+  if (input.getRemainingLength() <= 1)
+  {
+    input.seek(input.getSize());
     return false;
-  else
-    input->seek(-1, librevenge::RVNG_SEEK_CUR);
+  }
 
   m_header.chunkType = getUInt(input);
   m_header.id = getUInt(input);
-  m_header.level = readU8(input);
-  m_header.unknown = readU8(input);
+  m_header.level = input.readU8();
+  m_header.unknown = input.readU8();
 
   m_header.trailer = 0;
 
   m_header.list = getUInt(input);
 
-  m_header.dataLength = readU32(input);
+  m_header.dataLength = input.readU32();
 
   return true;
 }
 
-void libvisio::VSD5Parser::handleChunkRecords(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::handleChunkRecords(VSDBinaryReader &input)
 {
-  long startPosition = input->tell();
-  long endPosition = input->tell() + m_header.dataLength;
-  input->seek(endPosition - 4, librevenge::RVNG_SEEK_SET);
-  unsigned numRecords = readU16(input);
+  long startPosition = input.tell();
+  long endPosition = input.tell() + m_header.dataLength;
+  input.seek(endPosition - 4);
+  unsigned numRecords = input.readU16();
   const long headerPosition = endPosition - 4 * (numRecords + 1);
   if (headerPosition <= startPosition) // no records to read
     return;
-  unsigned endOffset = readU16(input);
+  unsigned endOffset = input.readU16();
   if (long(endOffset) > (headerPosition - startPosition))
     endOffset = unsigned(headerPosition - startPosition); // try to read something anyway
   std::map<unsigned, ChunkHeader> records;
-  input->seek(headerPosition, librevenge::RVNG_SEEK_SET);
+  input.seek(headerPosition);
   unsigned i = 0;
   for (i = 0; i < numRecords; ++i)
   {
     ChunkHeader header;
-    header.chunkType = readU16(input);
-    unsigned offset = readU16(input);
+    header.chunkType = input.readU16();
+    unsigned offset = input.readU16();
     unsigned tmpStart = offset;
     while (tmpStart % 4)
       tmpStart++;
@@ -128,17 +127,21 @@ void libvisio::VSD5Parser::handleChunkRecords(librevenge::RVNGInputStream *input
       endOffset = offset;
     }
   }
+  if (!input.isGood())
+    return;
   i = 0;
   for (auto &record : records)
   {
     m_header = record.second;
     m_header.id = i++;
-    input->seek(startPosition + record.first, librevenge::RVNG_SEEK_SET);
+    input.seek(startPosition + record.first);
     handleChunk(input);
+    if (!input.isGood())
+      return;
   }
 }
 
-void libvisio::VSD5Parser::readGeomList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readGeomList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readGeomList\n"));
   if (!m_shape.m_geometries.empty() && m_currentGeometryList && m_currentGeometryList->empty())
@@ -150,91 +153,95 @@ void libvisio::VSD5Parser::readGeomList(librevenge::RVNGInputStream *input)
   handleChunkRecords(input);
 }
 
-void libvisio::VSD5Parser::readList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readList(VSDBinaryReader &input)
 {
   if (!m_isStencilStarted)
     m_collector->collectUnhandledChunk(m_header.id, m_header.level);
   handleChunkRecords(input);
 }
 
-void libvisio::VSD5Parser::readCharList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readCharList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readCharList\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readParaList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readParaList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readParaList\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readShapeList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readShapeList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readShapeList\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readPropList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readPropList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readPropList\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readFieldList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readFieldList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readFieldList\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readNameList2(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readNameList2(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readNameList2\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readTabsDataList(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readTabsDataList(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readTabsDataList\n"));
   readList(input);
 }
 
-void libvisio::VSD5Parser::readLine(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readLine(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double strokeWidth = readDouble(input);
-  unsigned char colourIndex = readU8(input);
+  input.skip(1);
+  double strokeWidth = input.readDouble();
+  unsigned char colourIndex = input.readU8();
   Colour c = _colourFromIndex(colourIndex);
-  unsigned char linePattern = readU8(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double rounding = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  unsigned char startMarker = readU8(input);
-  unsigned char endMarker = readU8(input);
-  unsigned char lineCap = readU8(input);
-
+  unsigned char linePattern = input.readU8();
+  input.skip(1);
+  double rounding = input.readDouble();
+  input.skip(1);
+  unsigned char startMarker = input.readU8();
+  unsigned char endMarker = input.readU8();
+  unsigned char lineCap = input.readU8();
+
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectLineStyle(m_header.level, strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, -1, -1);
   else
     m_shape.m_lineStyle.override(VSDOptionalLineStyle(strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, -1, -1));
 }
 
-void libvisio::VSD5Parser::readParaIX(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readParaIX(VSDBinaryReader &input)
 {
-  unsigned charCount = readU16(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indFirst = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indLeft = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indRight = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spLine = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spBefore = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spAfter = readDouble(input);
-  unsigned char align = readU8(input);
+  unsigned charCount = input.readU16();
+  input.skip(1);
+  double indFirst = input.readDouble();
+  input.skip(1);
+  double indLeft = input.readDouble();
+  input.skip(1);
+  double indRight = input.readDouble();
+  input.skip(1);
+  double spLine = input.readDouble();
+  input.skip(1);
+  double spBefore = input.readDouble();
+  input.skip(1);
+  double spAfter = input.readDouble();
+  unsigned char align = input.readU8();
+  if (!input.isGood())
+    return;
 
   unsigned char bullet(0);
   VSDName bulletStr;
@@ -264,15 +271,15 @@ void libvisio::VSD5Parser::readParaIX(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD5Parser::readCharIX(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readCharIX(VSDBinaryReader &input)
 {
-  unsigned charCount = readU16(input);
-  unsigned fontID = readU16(input);
+  unsigned charCount = input.readU16();
+  unsigned fontID = input.readU16();
   VSDName font;
   std::map<unsigned, VSDName>::const_iterator iter = m_fonts.find(fontID);
   if (iter != m_fonts.end())
     font = iter->second;
-  Colour fontColour = _colourFromIndex(readU8(input));
+  Colour fontColour = _colourFromIndex(input.readU8());
 
   bool bold(false);
   bool italic(false);
@@ -285,24 +292,26 @@ void libvisio::VSD5Parser::readCharIX(librevenge::RVNGInputStream *input)
   bool smallcaps(false);
   bool superscript(false);
   bool subscript(false);
-  unsigned char fontMod = readU8(input);
+  unsigned char fontMod = input.readU8();
   if (fontMod & 1) bold = true;
   if (fontMod & 2) italic = true;
   if (fontMod & 4) underline = true;
   if (fontMod & 8) smallcaps = true;
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) allcaps = true;
   if (fontMod & 2) initcaps = true;
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) superscript = true;
   if (fontMod & 2) subscript = true;
 
-  double scaleWidth = (double)(readU16(input)) / 10000.0;
-  input->seek(2, librevenge::RVNG_SEEK_CUR);
-  double fontSize = readDouble(input);
+  double scaleWidth = (double)(input.readU16()) / 10000.0;
+  input.skip(2);
+  double fontSize = input.readDouble();
+  if (!input.isGood())
+    return;
 
 #if 0
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) doubleunderline = true;
   if (fontMod & 4) strikeout = true;
   if (fontMod & 0x20) doublestrikeout = true;
@@ -328,15 +337,17 @@ void libvisio::VSD5Parser::readCharIX(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD5Parser::readFillAndShadow(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readFillAndShadow(VSDBinaryReader &input)
 {
-  Colour colourFG = _colourFromIndex(readU8(input));
-  Colour colourBG = _colourFromIndex(readU8(input));
-  unsigned char fillPattern = readU8(input);
-  Colour shfgc = _colourFromIndex(readU8(input));
-  input->seek(1, librevenge::RVNG_SEEK_CUR); // Shadow Background Colour skipped
-  unsigned char shadowPattern = readU8(input);
-
+  Colour colourFG = _colourFromIndex(input.readU8());
+  Colour colourBG = _colourFromIndex(input.readU8());
+  unsigned char fillPattern = input.readU8();
+  Colour shfgc = _colourFromIndex(input.readU8());
+  input.skip(1); // Shadow Background Colour skipped
+  unsigned char shadowPattern = input.readU8();
+
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectFillStyle(m_header.level, colourFG, colourBG, fillPattern,
                                   0.0, 0.0, shadowPattern, shfgc);
@@ -361,17 +372,19 @@ void libvisio::VSD5Parser::readFillAndShadow(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD5Parser::readStyleSheet(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readStyleSheet(VSDBinaryReader &input)
 {
-  input->seek(10, librevenge::RVNG_SEEK_CUR);
+  input.skip(10);
   unsigned lineStyle = getUInt(input);
   unsigned fillStyle = getUInt(input);
   unsigned textStyle = getUInt(input);
 
+  if (!input.isGood())
+    return;
   m_collector->collectStyleSheet(m_header.id, m_header.level, lineStyle, fillStyle, textStyle);
 }
 
-void libvisio::VSD5Parser::readShape(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readShape(VSDBinaryReader &input)
 {
   m_currentGeomListCount = 0;
   m_currentGeometryList = nullptr;
@@ -387,20 +400,21 @@ void libvisio::VSD5Parser::readShape(librevenge::RVNGInputStream *input)
   auto fillStyle = MINUS_ONE;
   auto textStyle = MINUS_ONE;
 
-  try
+  // Ids missing from a short record keep their defaults
+  const auto readId = [this, &input](unsigned &id)
   {
-    input->seek(2, librevenge::RVNG_SEEK_CUR);
-    parent = getUInt(input);
-    input->seek(2, librevenge::RVNG_SEEK_CUR);
-    masterPage = getUInt(input);
-    masterShape = getUInt(input);
-    lineStyle = getUInt(input);
-    fillStyle = getUInt(input);
-    textStyle = getUInt(input);
-  }
-  catch (const EndOfStreamException &)
-  {
-  }
+    const unsigned value = getUInt(input);
+    if (input.isGood())
+      id = value;
+  };
+  input.skip(2);
+  readId(parent);
+  input.skip(2);
+  readId(masterPage);
+  readId(masterShape);
+  readId(lineStyle);
+  readId(fillStyle);
+  readId(textStyle);
 
   m_shape.clear();
   const VSDShape *tmpShape = m_stencils.getStencilShape(masterPage, masterShape);
@@ -422,24 +436,25 @@ void libvisio::VSD5Parser::readShape(librevenge::RVNGInputStream *input)
   m_currentShapeID = MINUS_ONE;
 }
 
-void libvisio::VSD5Parser::readPage(librevenge::RVNGInputStream *input)
+unsigned libvisio::VSD5Parser::readBackgroundPageID(VSDBinaryReader &input)
 {
-  unsigned backgroundPageID = getUInt(input);
-  m_collector->collectPage(m_header.id, m_header.level, backgroundPageID, m_isBackgroundPage, m_currentPageName);
+  return getUInt(input);
 }
 
-void libvisio::VSD5Parser::readTextBlock(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readTextBlock(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double leftMargin = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double rightMargin = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double topMargin = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double bottomMargin = readDouble(input);
-  unsigned char verticalAlign = readU8(input);
-  unsigned char colourIndex = readU8(input);
+  input.skip(1);
+  double leftMargin = input.readDouble();
+  input.skip(1);
+  double rightMargin = input.readDouble();
+  input.skip(1);
+  double topMargin = input.readDouble();
+  input.skip(1);
+  double bottomMargin = input.readDouble();
+  unsigned char verticalAlign = input.readU8();
+  unsigned char colourIndex = input.readU8();
+  if (!input.isGood())
+    return;
   bool isBgFilled = !!colourIndex;
   Colour c;
   if (isBgFilled)
@@ -453,72 +468,87 @@ void libvisio::VSD5Parser::readTextBlock(librevenge::RVNGInputStream *input)
                                                                 verticalAlign, isBgFilled, c, 0.0, (unsigned char)0));
 }
 
-void libvisio::VSD5Parser::readTextField(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readTextField(VSDBinaryReader &input)
 {
-  input->seek(3, librevenge::RVNG_SEEK_CUR);
-  unsigned char cellType = readU8(input);
+  input.skip(3);
+  unsigned char cellType = input.readU8();
   if (CELL_TYPE_StringWithoutUnit == cellType)
   {
-    int nameId = readS16(input);
+    int nameId = input.readS16();
+    if (!input.isGood())
+      return;
     m_shape.m_fields.addTextField(m_header.id, m_header.level, nameId, 0xffff);
   }
   else
   {
-    double numericValue = readDouble(input);
+    double numericValue = input.readDouble();
+    if (!input.isGood())
+      return;
     m_shape.m_fields.addNumericField(m_header.id, m_header.level, VSD_FIELD_FORMAT_Unknown, cellType, numericValue, 0xffff);
   }
 }
 
-void libvisio::VSD5Parser::readNameIDX(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readNameIDX(VSDBinaryReader &input)
 {
   VSD_DEBUG_MSG(("VSD5Parser::readNameIDX\n"));
   std::map<unsigned, VSDName> names;
-  unsigned recordCount = readU16(input);
-  if (recordCount > getRemainingLength(input) / 4)
-    recordCount = getRemainingLength(input) / 4;
+  unsigned recordCount = input.readU16();
+  if (recordCount > input.getRemainingLength() / 4)
+    recordCount = input.getRemainingLength() / 4;
   for (unsigned i = 0; i < recordCount; ++i)
   {
-    unsigned nameId = readU16(input);
-    unsigned elementId = readU16(input);
+    unsigned nameId = input.readU16();
+    unsigned elementId = input.readU16();
     std::map<unsigned, VSDName>::const_iterator iter = m_names.find(nameId);
     if (iter != m_names.end())
       names[elementId] = iter->second;
   }
+  if (!input.isGood())
+    return;
   m_namesMapMap[m_header.level] = names;
 }
 
-void libvisio::VSD5Parser::readMisc(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readMisc(VSDBinaryReader &input)
 {
-  unsigned char flags = readU8(input);
+  unsigned char flags = input.readU8();
+  if (!input.isGood())
+    return;
   if (flags & 0x20)
     m_shape.m_misc.m_hideText = true;
   else
     m_shape.m_misc.m_hideText = false;
 }
 
-void libvisio::VSD5Parser::readXForm1D(librevenge::RVNGInputStream *input)
+void libvisio::VSD5Parser::readXForm1D(VSDBinaryReader &input)
 {
+  input.skip(1);
+  double beginX = input.readDouble();
+  input.skip(1);
+  double beginY = input.readDouble();
+  input.skip(1);
+  double endX = input.readDouble();
+  input.skip(1);
+  double endY = input.readDouble();
+
+  if (!input.isGood())
+    return;
   if (!m_shape.m_xform1d)
     m_shape.m_xform1d = std::make_unique<XForm1D>();
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->beginX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->beginY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->endX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->endY = readDouble(input);
+  m_shape.m_xform1d->beginX = beginX;
+  m_shape.m_xform1d->beginY = beginY;
+  m_shape.m_xform1d->endX = endX;
+  m_shape.m_xform1d->endY = endY;
 }
 
-unsigned libvisio::VSD5Parser::getUInt(librevenge::RVNGInputStream *input)
+unsigned libvisio::VSD5Parser::getUInt(VSDBinaryReader &input)
 {
-  int value = readS16(input);
+  int value = input.readS16();
   return (unsigned)value;
 }
 
-int libvisio::VSD5Parser::getInt(librevenge::RVNGInputStream *input)
+int libvisio::VSD5Parser::getInt(VSDBinaryReader &input)
 {
-  return readS16(input);
+  return input.readS16();
 }
 
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -27,47 +27,47 @@ public:
 
 protected:
   void readPointer(librevenge::RVNGInputStream *input, Pointer &ptr) override;
-  bool getChunkHeader(librevenge::RVNGInputStream *input) override;
+  bool getChunkHeader(VSDBinaryReader &input) override;
   void readPointerInfo(librevenge::RVNGInputStream *input, unsigned ptrType, unsigned shift, unsigned &listSize, int &pointerCount) override;
 
-  void readGeomList(librevenge::RVNGInputStream *input) override;
-  void readCharList(librevenge::RVNGInputStream *input) override;
-  void readParaList(librevenge::RVNGInputStream *input) override;
-  void readShapeList(librevenge::RVNGInputStream *input) override;
-  void readPropList(librevenge::RVNGInputStream *input) override;
-  void readFieldList(librevenge::RVNGInputStream *input) override;
-  void readNameList2(librevenge::RVNGInputStream *input) override;
-  void readTabsDataList(librevenge::RVNGInputStream *input) override;
+  void readGeomList(VSDBinaryReader &input) override;
+  void readCharList(VSDBinaryReader &input) override;
+  void readParaList(VSDBinaryReader &input) override;
+  void readShapeList(VSDBinaryReader &input) override;
+  void readPropList(VSDBinaryReader &input) override;
+  void readFieldList(VSDBinaryReader &input) override;
+  void readNameList2(VSDBinaryReader &input) override;
+  void readTabsDataList(VSDBinaryReader &input) override;
 
-  void readLine(librevenge::RVNGInputStream *input) override;
-  void readFillAndShadow(librevenge::RVNGInputStream *input) override;
-  void readTextBlock(librevenge::RVNGInputStream *input) override;
-  void readCharIX(librevenge::RVNGInputStream *input) override;
-  void readParaIX(librevenge::RVNGInputStream *input) override;
-  void readTextField(librevenge::RVNGInputStream *input) override;
+  void readLine(VSDBinaryReader &input) override;
+  void readFillAndShadow(VSDBinaryReader &input) override;
+  void readTextBlock(VSDBinaryReader &input) override;
+  void readCharIX(VSDBinaryReader &input) override;
+  void readParaIX(VSDBinaryReader &input) override;
+  void readTextField(VSDBinaryReader &input) override;
 
-  void readShape(librevenge::RVNGInputStream *input) override;
-  void readPage(librevenge::RVNGInputStream *input) override;
+  void readShape(VSDBinaryReader &input) override;
+  unsigned readBackgroundPageID(VSDBinaryReader &input) override;
 
-  virtual void handleChunkRecords(librevenge::RVNGInputStream *input);
+  virtual void handleChunkRecords(VSDBinaryReader &input);
 
-  void readStyleSheet(librevenge::RVNGInputStream *input) override;
+  void readStyleSheet(VSDBinaryReader &input) override;
 
-  void readNameIDX(librevenge::RVNGInputStream *input) override;
+  void readNameIDX(VSDBinaryReader &input) override;
 
-  void readMisc(librevenge::RVNGInputStream *input) override;
+  void readMisc(VSDBinaryReader &input) override;
 
-  void readXForm1D(librevenge::RVNGInputStream *input) override;
+  void readXForm1D(VSDBinaryReader &input) override;
 
-  unsigned getUInt(librevenge::RVNGInputStream *input) override;
-  int getInt(librevenge::RVNGInputStream *input) override;
+  unsigned getUInt(VSDBinaryReader &input) override;
+  int getInt(VSDBinaryReader &input) override;
 
 private:
   VSD5Parser();
   VSD5Parser(const VSDParser &);
   VSD5Parser &operator=(const VSDParser &);
 
-  void readList(librevenge::RVNGInputStream *input);
+  void readList(VSDBinaryReader &input);
 };
 
 } // namespace libvisio
@@ -14,6 +14,7 @@
 #include <sstream>
 #include <string>
 #include "libvisio_utils.h"
+#include "VSDChunkTypes.h"
 #include "VSDInternalStream.h"
 #include "VSDDocumentStructure.h"
 #include "VSDContentCollector.h"
@@ -26,51 +27,43 @@ libvisio::VSD6Parser::VSD6Parser(librevenge::RVNGInputStream *input, librevenge:
 libvisio::VSD6Parser::~VSD6Parser()
 {}
 
-bool libvisio::VSD6Parser::getChunkHeader(librevenge::RVNGInputStream *input)
+bool libvisio::VSD6Parser::getChunkHeader(VSDBinaryReader &input)
 {
-  unsigned char tmpChar = 0;
-  while (!input->isEnd() && !tmpChar)
-    tmpChar = readU8(input);
-
-  if (input->isEnd())
+  input.skipZeroBytes();
+  // A lone trailing byte cannot start a chunk
+  if (input.getRemainingLength() <= 1)
+  {
+    input.seek(input.getSize());
     return false;
-  else
-    input->seek(-1, librevenge::RVNG_SEEK_CUR);
+  }
+
+  m_header.chunkType = input.readU32();
+  m_header.id = input.readU32();
+  m_header.list = input.readU32();
+  m_header.dataLength = input.readU32();
+  m_header.level = input.readU16();
+  m_header.unknown = input.readU8();
 
-  m_header.chunkType = readU32(input);
-  m_header.id = readU32(input);
-  m_header.list = readU32(input);
+  const unsigned char flags = getChunkTypeFlags(VSD6_CHUNK_TYPES, m_header.chunkType);
 
   // Certain chunk types seem to always have a trailer
   m_header.trailer = 0;
-  if (m_header.list != 0 || m_header.chunkType == 0x76 || m_header.chunkType == 0x73 ||
-      m_header.chunkType == 0x72 || m_header.chunkType == 0x71 || m_header.chunkType == 0x70 ||
-      m_header.chunkType == 0x6f || m_header.chunkType == 0x6e || m_header.chunkType == 0x6d ||
-      m_header.chunkType == 0x6c || m_header.chunkType == 0x6b || m_header.chunkType == 0x6a ||
-      m_header.chunkType == 0x69 || m_header.chunkType == 0x68 || m_header.chunkType == 0x67 ||
-      m_header.chunkType == 0x66 || m_header.chunkType == 0x65 || m_header.chunkType == 0x64 ||
-      m_header.chunkType == 0x2c || m_header.chunkType == 0xd)
+  if (m_header.list != 0 || (flags & CHUNK_TRAILER))
     m_header.trailer += 8; // 8 byte trailer
 
-  m_header.dataLength = readU32(input);
-  m_header.level = readU16(input);
-  m_header.unknown = readU8(input);
-
   // 0x1f (OLE data) and 0xc9 (Name ID) never have trailer
-  if (m_header.chunkType == 0x1f || m_header.chunkType == 0xc9)
-  {
+  if (flags & CHUNK_NO_TRAILER)
     m_header.trailer = 0;
-  }
   return true;
 }
 
-void libvisio::VSD6Parser::readText(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readText(VSDBinaryReader &input)
 {
-  input->seek(8, librevenge::RVNG_SEEK_CUR);
+  input.skip(8);
   librevenge::RVNGBinaryData  textStream;
 
   unsigned long numBytesRead = 0;
-  const unsigned char *tmpBuffer = input->read(m_header.dataLength - 8, numBytesRead);
+  const unsigned char *tmpBuffer = input.read(m_header.dataLength - 8, numBytesRead);
   if (numBytesRead)
   {
     if (m_isStencilStarted)
@@ -85,14 +78,14 @@ void libvisio::VSD6Parser::readText(librevenge::RVNGInputStream *input)
   m_shape.m_textFormat = libvisio::VSD_TEXT_ANSI;
 }
 
-void libvisio::VSD6Parser::readLayerMem(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readLayerMem(VSDBinaryReader &input)
 {
-  input->seek(13, librevenge::RVNG_SEEK_CUR);
-  unsigned textLength = readU8(input);
+  input.skip(13);
+  unsigned textLength = input.readU8();
 
   librevenge::RVNGBinaryData  textStream;
   unsigned long numBytesRead = 0;
-  const unsigned char *tmpBuffer = input->read(textLength, numBytesRead);
+  const unsigned char *tmpBuffer = input.read(textLength, numBytesRead);
   if (numBytesRead)
   {
     textStream.append(tmpBuffer, numBytesRead);
@@ -102,20 +95,20 @@ void libvisio::VSD6Parser::readLayerMem(librevenge::RVNGInputStream *input)
 
 }
 
-void libvisio::VSD6Parser::readCharIX(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readCharIX(VSDBinaryReader &input)
 {
-  unsigned charCount = readU32(input);
-  unsigned fontID = readU16(input);
+  unsigned charCount = input.readU32();
+  unsigned fontID = input.readU16();
   VSDName font;
   std::map<unsigned, VSDName>::const_iterator iter = m_fonts.find(fontID);
   if (iter != m_fonts.end())
     font = iter->second;
-  input->seek(1, librevenge::RVNG_SEEK_CUR);  // Color ID
+  input.skip(1);  // Color ID
   Colour fontColour;            // Font Colour
-  fontColour.r = readU8(input);
-  fontColour.g = readU8(input);
-  fontColour.b = readU8(input);
-  fontColour.a = readU8(input);
+  fontColour.r = input.readU8();
+  fontColour.g = input.readU8();
+  fontColour.b = input.readU8();
+  fontColour.a = input.readU8();
 
   bool bold(false);
   bool italic(false);
@@ -128,27 +121,29 @@ void libvisio::VSD6Parser::readCharIX(librevenge::RVNGInputStream *input)
   bool smallcaps(false);
   bool superscript(false);
   bool subscript(false);
-  unsigned char fontMod = readU8(input);
+  unsigned char fontMod = input.readU8();
   if (fontMod & 1) bold = true;
   if (fontMod & 2) italic = true;
   if (fontMod & 4) underline = true;
   if (fontMod & 8) smallcaps = true;
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) allcaps = true;
   if (fontMod & 2) initcaps = true;
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) superscript = true;
   if (fontMod & 2) subscript = true;
 
-  double scaleWidth = (double)(readU16(input)) / 10000.0;
-  input->seek(2, librevenge::RVNG_SEEK_CUR);
-  double fontSize = readDouble(input);
+  double scaleWidth = (double)(input.readU16()) / 10000.0;
+  input.skip(2);
+  double fontSize = input.readDouble();
 
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) doubleunderline = true;
   if (fontMod & 4) strikeout = true;
   if (fontMod & 0x20) doublestrikeout = true;
 
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectCharIXStyle(m_header.id, m_header.level, charCount, font, fontColour, fontSize,
                                     bold, italic, underline, doubleunderline, strikeout, doublestrikeout,
@@ -169,46 +164,46 @@ void libvisio::VSD6Parser::readCharIX(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD6Parser::readParaIX(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readParaIX(VSDBinaryReader &input)
 {
-  long startPosition = input->tell();
-  unsigned charCount = readU32(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indFirst = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indLeft = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indRight = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spLine = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spBefore = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spAfter = readDouble(input);
-  unsigned char align = readU8(input);
-  unsigned char bullet = readU8(input);
-  input->seek(4, librevenge::RVNG_SEEK_CUR);
-  unsigned flags = readU32(input);
-  input->seek(5, librevenge::RVNG_SEEK_CUR);
-
-  long remainingData = m_header.dataLength - input->tell() + startPosition;
+  long startPosition = input.tell();
+  unsigned charCount = input.readU32();
+  input.skip(1);
+  double indFirst = input.readDouble();
+  input.skip(1);
+  double indLeft = input.readDouble();
+  input.skip(1);
+  double indRight = input.readDouble();
+  input.skip(1);
+  double spLine = input.readDouble();
+  input.skip(1);
+  double spBefore = input.readDouble();
+  input.skip(1);
+  double spAfter = input.readDouble();
+  unsigned char align = input.readU8();
+  unsigned char bullet = input.readU8();
+  input.skip(4);
+  unsigned flags = input.readU32();
+  input.skip(5);
+
+  long remainingData = m_header.dataLength - input.tell() + startPosition;
   unsigned blockLength = 0;
   VSDName bulletStr;
   VSDName bulletFont;
   double bulletFontSize(0.0);
   double textPosAfterBullet(0.0);
 
-  while (remainingData >= 4 && (blockLength = readU32(input)))
+  while (remainingData >= 4 && (blockLength = input.readU32()))
   {
-    long blockEnd = blockLength-4 + input->tell();
-    unsigned char blockType = readU8(input);
-    unsigned char blockIdx = readU8(input);
+    long blockEnd = blockLength-4 + input.tell();
+    unsigned char blockType = input.readU8();
+    unsigned char blockIdx = input.readU8();
     if (blockType == 2 && blockIdx == 8)
     {
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      unsigned long numBytes = readU8(input);
+      input.skip(1);
+      unsigned long numBytes = input.readU8();
       unsigned long numBytesRead = 0;
-      const unsigned char *tmpBuffer = input->read(numBytes, numBytesRead);
+      const unsigned char *tmpBuffer = input.read(numBytes, numBytesRead);
       if (tmpBuffer && numBytesRead)
       {
         librevenge::RVNGBinaryData tmpBulletString(tmpBuffer, numBytesRead);
@@ -218,10 +213,12 @@ void libvisio::VSD6Parser::readParaIX(librevenge::RVNGInputStream *input)
     else if (blockType == 2 && blockIdx == 3)
     {
     };
-    input->seek(blockEnd, librevenge::RVNG_SEEK_SET);
+    input.seek(blockEnd);
     remainingData -= blockLength;
   }
 
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectParaIXStyle(m_header.id, m_header.level, charCount, indFirst, indLeft, indRight,
                                     spLine, spBefore, spAfter, align, bullet, bulletStr, bulletFont,
@@ -242,20 +239,20 @@ void libvisio::VSD6Parser::readParaIX(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD6Parser::readFillAndShadow(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readFillAndShadow(VSDBinaryReader &input)
 {
-  unsigned char colourFGIndex = readU8(input);
+  unsigned char colourFGIndex = input.readU8();
   Colour colourFG;
-  colourFG.r = readU8(input);
-  colourFG.g = readU8(input);
-  colourFG.b = readU8(input);
-  colourFG.a = readU8(input);
-  unsigned char colourBGIndex = readU8(input);
+  colourFG.r = input.readU8();
+  colourFG.g = input.readU8();
+  colourFG.b = input.readU8();
+  colourFG.a = input.readU8();
+  unsigned char colourBGIndex = input.readU8();
   Colour colourBG;
-  colourBG.r = readU8(input);
-  colourBG.g = readU8(input);
-  colourBG.b = readU8(input);
-  colourBG.a = readU8(input);
+  colourBG.r = input.readU8();
+  colourBG.g = input.readU8();
+  colourBG.b = input.readU8();
+  colourBG.a = input.readU8();
   if (!colourFG && !colourBG)
   {
     colourFG = _colourFromIndex(colourFGIndex);
@@ -264,28 +261,30 @@ void libvisio::VSD6Parser::readFillAndShadow(librevenge::RVNGInputStream *input)
   double fillFGTransparency = (double)colourFG.a / 255.0;
   double fillBGTransparency = (double)colourBG.a / 255.0;
 
-  unsigned char fillPattern = readU8(input);
+  unsigned char fillPattern = input.readU8();
 
-  unsigned char shadowFGIndex = readU8(input);
+  unsigned char shadowFGIndex = input.readU8();
   Colour shadowFG;
-  shadowFG.r = readU8(input);
-  shadowFG.g = readU8(input);
-  shadowFG.b = readU8(input);
-  shadowFG.a = readU8(input);
-  unsigned char shadowBGIndex = readU8(input);
+  shadowFG.r = input.readU8();
+  shadowFG.g = input.readU8();
+  shadowFG.b = input.readU8();
+  shadowFG.a = input.readU8();
+  unsigned char shadowBGIndex = input.readU8();
   Colour shadowBG;
-  shadowBG.r = readU8(input);
-  shadowBG.g = readU8(input);
-  shadowBG.b = readU8(input);
-  shadowBG.a = readU8(input);
+  shadowBG.r = input.readU8();
+  shadowBG.g = input.readU8();
+  shadowBG.b = input.readU8();
+  shadowBG.a = input.readU8();
   if (!shadowFG && !shadowBG)
   {
     shadowFG = _colourFromIndex(shadowFGIndex);
     shadowBG = _colourFromIndex(shadowBGIndex);
   }
 
-  unsigned char shadowPattern = readU8(input);
+  unsigned char shadowPattern = input.readU8();
 
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectFillStyle(m_header.level, colourFG, colourBG, fillPattern,
                                   fillFGTransparency, fillBGTransparency, shadowPattern, shadowFG);
@@ -310,10 +309,10 @@ void libvisio::VSD6Parser::readFillAndShadow(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD6Parser::readName(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readName(VSDBinaryReader &input)
 {
   unsigned long numBytesRead = 0;
-  const unsigned char *tmpBuffer = input->read(m_header.dataLength, numBytesRead);
+  const unsigned char *tmpBuffer = input.read(m_header.dataLength, numBytesRead);
   if (numBytesRead)
   {
     librevenge::RVNGBinaryData name(tmpBuffer, numBytesRead);
@@ -321,63 +320,67 @@ void libvisio::VSD6Parser::readName(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD6Parser::readName2(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readName2(VSDBinaryReader &input)
 {
   unsigned char character = 0;
   librevenge::RVNGBinaryData name;
   getInt(input); // skip a dword that seems to be always 1
-  while ((character = readU8(input)))
+  while ((character = input.readU8()))
     name.append(character);
+  if (!input.isGood())
+    return;
   name.append(character);
   m_names[m_header.id] = VSDName(name, libvisio::VSD_TEXT_ANSI);
 }
 
-void libvisio::VSD6Parser::readTextField(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readTextField(VSDBinaryReader &input)
 {
-  unsigned long initialPosition = input->tell();
-  input->seek(7, librevenge::RVNG_SEEK_CUR);
-  unsigned char cellType = readU8(input);
+  unsigned long initialPosition = input.tell();
+  input.skip(7);
+  unsigned char cellType = input.readU8();
   if (cellType == CELL_TYPE_StringWithoutUnit)
   {
-    int nameId = readS32(input);
-    input->seek(6, librevenge::RVNG_SEEK_CUR);
-    int formatStringId = readS32(input);
+    int nameId = input.readS32();
+    input.skip(6);
+    int formatStringId = input.readS32();
+    if (!input.isGood())
+      return;
     m_shape.m_fields.addTextField(m_header.id, m_header.level, nameId, formatStringId);
   }
   else
   {
-    double numericValue = readDouble(input);
-    input->seek(2, librevenge::RVNG_SEEK_CUR);
-    int formatStringId = readS32(input);
+    double numericValue = input.readDouble();
+    input.skip(2);
+    int formatStringId = input.readS32();
 
     unsigned blockIdx = 0;
     unsigned length = 0;
     unsigned short formatNumber = 0;
-    input->seek(initialPosition+0x24, librevenge::RVNG_SEEK_SET);
-    while (blockIdx != 2 && !input->isEnd() && (unsigned long) input->tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
+    input.seek(initialPosition+0x24);
+    while (blockIdx != 2 && !input.isEnd() && (unsigned long) input.tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
     {
-      unsigned long inputPos = input->tell();
-      length = readU32(input);
+      unsigned long inputPos = input.tell();
+      length = input.readU32();
       if (!length)
         break;
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      blockIdx = readU8(input);
+      input.skip(1);
+      blockIdx = input.readU8();
       if (blockIdx != 2)
-        input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+        input.seek(inputPos + length);
       else
       {
-        input->seek(1, librevenge::RVNG_SEEK_CUR);
-        formatNumber = readU16(input);
-        if (0x80 != readU8(input))
+        input.skip(1);
+        formatNumber = input.readU16();
+        if (0x80 != input.readU8())
         {
-          input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+          input.seek(inputPos + length);
           blockIdx = 0;
         }
         else
         {
-          if (0xc2 != readU8(input))
+          if (0xc2 != input.readU8())
           {
-            input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+            input.seek(inputPos + length);
             blockIdx = 0;
           }
           else
@@ -386,7 +389,7 @@ void libvisio::VSD6Parser::readTextField(librevenge::RVNGInputStream *input)
       }
     }
 
-    if (input->isEnd())
+    if (input.isEnd() || !input.isGood())
       return;
 
     if (blockIdx != 2)
@@ -401,34 +404,36 @@ void libvisio::VSD6Parser::readTextField(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSD6Parser::readMisc(librevenge::RVNGInputStream *input)
+void libvisio::VSD6Parser::readMisc(VSDBinaryReader &input)
 {
-  unsigned long initialPosition = input->tell();
-  unsigned char flags = readU8(input);
+  unsigned long initialPosition = input.tell();
+  unsigned char flags = input.readU8();
+  if (!input.isGood())
+    return;
   if (flags & 0x20)
     m_shape.m_misc.m_hideText = true;
   else
     m_shape.m_misc.m_hideText = false;
 
-  input->seek(initialPosition+23, librevenge::RVNG_SEEK_SET);
-  while (!input->isEnd() && (unsigned long) input->tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
+  input.seek(initialPosition+23);
+  while (!input.isEnd() && (unsigned long) input.tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
   {
-    unsigned long inputPos = input->tell();
-    unsigned length = readU32(input);
+    unsigned long inputPos = input.tell();
+    unsigned length = input.readU32();
     if (!length)
       break;
-    unsigned blockType = readU8(input);
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
+    unsigned blockType = input.readU8();
+    input.skip(1);
     if (blockType == 2)
     {
-      if (0x74 == readU8(input))
+      if (0x74 == input.readU8())
       {
-        if (0x6000004e == readU32(input))
+        if (0x6000004e == input.readU32())
         {
-          unsigned shapeId = readU32(input);
-          if (0x7a == readU8(input))
+          unsigned shapeId = input.readU32();
+          if (0x7a == input.readU8())
           {
-            if (0x40000073 == readU32(input))
+            if (0x40000073 == input.readU32())
             {
               if (!m_shape.m_xform1d)
                 m_shape.m_xform1d = std::make_unique<XForm1D>();
@@ -441,7 +446,7 @@ void libvisio::VSD6Parser::readMisc(librevenge::RVNGInputStream *input)
         }
       }
     }
-    input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+    input.seek(inputPos + length);
   }
 }
 
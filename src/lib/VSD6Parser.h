@@ -25,17 +25,17 @@ public:
   explicit VSD6Parser(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter);
   ~VSD6Parser() override;
 protected:
-  bool getChunkHeader(librevenge::RVNGInputStream *input) override;
+  bool getChunkHeader(VSDBinaryReader &input) override;
 private:
-  void readText(librevenge::RVNGInputStream *input) override;
-  void readCharIX(librevenge::RVNGInputStream *input) override;
-  void readParaIX(librevenge::RVNGInputStream *input) override;
-  void readFillAndShadow(librevenge::RVNGInputStream *input) override;
-  void readName(librevenge::RVNGInputStream *input) override;
-  void readName2(librevenge::RVNGInputStream *input) override;
-  void readTextField(librevenge::RVNGInputStream *input) override;
-  void readLayerMem(librevenge::RVNGInputStream *input) override;
-  void readMisc(librevenge::RVNGInputStream *input) override;
+  void readText(VSDBinaryReader &input) override;
+  void readCharIX(VSDBinaryReader &input) override;
+  void readParaIX(VSDBinaryReader &input) override;
+  void readFillAndShadow(VSDBinaryReader &input) override;
+  void readName(VSDBinaryReader &input) override;
+  void readName2(VSDBinaryReader &input) override;
+  void readTextField(VSDBinaryReader &input) override;
+  void readLayerMem(VSDBinaryReader &input) override;
+  void readMisc(VSDBinaryReader &input) override;
 
 
   VSD6Parser();
@@ -0,0 +1,164 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __VSDBINARYREADER_H__
+#define __VSDBINARYREADER_H__
+
+#include <stdint.h>
+#include <string.h>
+
+namespace libvisio
+{
+
+/* Reads little-endian values from a buffer, e.g. the data of
+ * a VSDInternalStream, without going through RVNGInputStream.
+ *
+ * Reading past the end does not throw: the read returns 0, the position
+ * moves to the end and isGood() returns false from then on.
+ */
+class VSDBinaryReader
+{
+public:
+  VSDBinaryReader(const unsigned char *data, unsigned long size)
+    : m_data(data), m_size(data ? size : 0), m_offset(0), m_isGood(true) {}
+
+  bool isGood() const
+  {
+    return m_isGood;
+  }
+  bool isEnd() const
+  {
+    return m_offset >= m_size;
+  }
+  unsigned long tell() const
+  {
+    return m_offset;
+  }
+  unsigned long getSize() const
+  {
+    return m_size;
+  }
+  unsigned long getRemainingLength() const
+  {
+    return m_size - m_offset;
+  }
+
+  // Like VSDInternalStream::seek, positions outside of the buffer are clamped
+  void seek(long offset)
+  {
+    if (offset < 0)
+      m_offset = 0;
+    else if ((unsigned long)offset > m_size)
+      m_offset = m_size;
+    else
+      m_offset = (unsigned long)offset;
+  }
+  void skip(long count)
+  {
+    seek((long)m_offset + count);
+  }
+
+  // Moves to the next non-zero byte or to the end, a word at a time
+  void skipZeroBytes()
+  {
+    const unsigned char *p = m_data + m_offset;
+    const unsigned char *const end = m_data + m_size;
+    uint64_t word = 0;
+    while (end - p >= (long)sizeof(word))
+    {
+      memcpy(&word, p, sizeof(word));
+      if (word)
+        break;
+      p += sizeof(word);
+    }
+    while (p != end && !*p)
+      ++p;
+    m_offset = (unsigned long)(p - m_data);
+  }
+
+  // Returns at most numBytes bytes; a short read is not an error
+  const unsigned char *read(unsigned long numBytes, unsigned long &numBytesRead)
+  {
+    numBytesRead = numBytes < getRemainingLength() ? numBytes : getRemainingLength();
+    if (!numBytesRead)
+      return nullptr;
+    const unsigned char *const p = m_data + m_offset;
+    m_offset += numBytesRead;
+    return p;
+  }
+
+  uint8_t readU8()
+  {
+    if (!_canRead(1))
+      return 0;
+    return m_data[m_offset++];
+  }
+  uint16_t readU16()
+  {
+    if (!_canRead(2))
+      return 0;
+    const unsigned char *const p = m_data + m_offset;
+    m_offset += 2;
+    return (uint16_t)(p[0] | (p[1] << 8));
+  }
+  int16_t readS16()
+  {
+    return (int16_t)readU16();
+  }
+  uint32_t readU32()
+  {
+    if (!_canRead(4))
+      return 0;
+    const unsigned char *const p = m_data + m_offset;
+    m_offset += 4;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+  int32_t readS32()
+  {
+    return (int32_t)readU32();
+  }
+  uint64_t readU64()
+  {
+    if (!_canRead(8))
+      return 0;
+    const unsigned char *const p = m_data + m_offset;
+    m_offset += 8;
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i)
+      value = (value << 8) | p[i];
+    return value;
+  }
+  double readDouble()
+  {
+    const uint64_t u = readU64();
+    double d;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+  }
+
+private:
+  bool _canRead(unsigned long numBytes)
+  {
+    if (m_isGood && numBytes <= getRemainingLength())
+      return true;
+    m_offset = m_size;
+    m_isGood = false;
+    return false;
+  }
+
+  const unsigned char *m_data;
+  unsigned long m_size;
+  unsigned long m_offset;
+  bool m_isGood;
+};
+
+} // namespace libvisio
+
+#endif // __VSDBINARYREADER_H__
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,69 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef VSDCHUNKTYPES_H
+#define VSDCHUNKTYPES_H
+
+#include <array>
+#include <initializer_list>
+
+namespace libvisio
+{
+
+// What the header of a chunk of the type implies about its trailer
+enum ChunkTypeFlags
+{
+  CHUNK_TRAILER = 1,
+  CHUNK_SEPARATOR = 2,
+  CHUNK_NO_TRAILER = 4
+};
+
+typedef std::array<unsigned char, 0x100> ChunkTypeTable;
+
+constexpr ChunkTypeTable makeChunkTypeTable(std::initializer_list<unsigned> trailer,
+                                            std::initializer_list<unsigned> separator,
+                                            std::initializer_list<unsigned> noTrailer)
+{
+  ChunkTypeTable table = {};
+  for (unsigned chunkType : trailer)
+    table[chunkType] |= CHUNK_TRAILER;
+  for (unsigned chunkType : separator)
+    table[chunkType] |= CHUNK_SEPARATOR;
+  for (unsigned chunkType : noTrailer)
+    table[chunkType] |= CHUNK_NO_TRAILER;
+  return table;
+}
+
+// Visio 2000 and later
+constexpr ChunkTypeTable VSD11_CHUNK_TYPES = makeChunkTypeTable(
+{0x2c, 0x65, 0x66, 0x69, 0x6a, 0x6b, 0x70, 0x71},
+{
+  0x64, 0x65, 0x66, 0x69, 0x6a, 0x6b, 0x6f, 0x71,
+  0x92, 0xa9, 0xb4, 0xb6, 0xb9, 0xc7
+},
+{0x1f, 0x2d, 0xc9, 0xd1});
+
+// Visio 5 and 6
+constexpr ChunkTypeTable VSD6_CHUNK_TYPES = makeChunkTypeTable(
+{
+  0x0d, 0x2c, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b,
+  0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x76
+},
+{},
+{0x1f, 0xc9});
+
+inline unsigned char getChunkTypeFlags(const ChunkTypeTable &table, unsigned chunkType)
+{
+  return chunkType < table.size() ? table[chunkType] : 0;
+}
+
+} // namespace libvisio
+
+#endif // VSDCHUNKTYPES_H
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
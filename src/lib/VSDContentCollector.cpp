@@ -13,6 +13,7 @@
 #include <cassert>
 #include <string.h> // for memcpy
 #include <limits>
+#include <utility>
 #include <set>
 #include <stack>
 #include <boost/spirit/include/qi.hpp>
@@ -113,6 +114,174 @@ unsigned computeBMPDataOffset(librevenge::RVNGInputStream *const input, const un
   return off;
 }
 
+const char *getCodePage(const libvisio::TextFormat format)
+{
+  switch (format)
+  {
+  case libvisio::VSD_TEXT_JAPANESE:
+    return "windows-932";
+  case libvisio::VSD_TEXT_KOREAN:
+    return "windows-949";
+  case libvisio::VSD_TEXT_CHINESE_SIMPLIFIED:
+    return "windows-936";
+  case libvisio::VSD_TEXT_CHINESE_TRADITIONAL:
+    return "windows-950";
+  case libvisio::VSD_TEXT_GREEK:
+    return "windows-1253";
+  case libvisio::VSD_TEXT_TURKISH:
+    return "windows-1254";
+  case libvisio::VSD_TEXT_VIETNAMESE:
+    return "windows-1258";
+  case libvisio::VSD_TEXT_HEBREW:
+    return "windows-1255";
+  case libvisio::VSD_TEXT_ARABIC:
+    return "windows-1256";
+  case libvisio::VSD_TEXT_BALTIC:
+    return "windows-1257";
+  case libvisio::VSD_TEXT_RUSSIAN:
+    return "windows-1251";
+  case libvisio::VSD_TEXT_THAI:
+    return "windows-874";
+  case libvisio::VSD_TEXT_CENTRAL_EUROPE:
+    return "windows-1250";
+  default:
+    return "windows-1252";
+  }
+}
+
+// Bytes below 0x7f decode to themselves in all the code pages we use,
+// except for the control codes that windows-932 remaps
+bool isPlainASCII(const std::vector<unsigned char> &characters)
+{
+  for (unsigned char character : characters)
+  {
+    if (character >= 0x7f || character == 0x1a || character == 0x1c)
+      return false;
+  }
+  return true;
+}
+
+#define LIBVISIO_EPSILON 1E-10
+
+#define VSD_NURBS_MIN_SUBDIVISION_DEPTH 2
+#define VSD_NURBS_MAX_SUBDIVISION_DEPTH 10
+
+class NURBSFlattener
+{
+public:
+  NURBSFlattener(unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
+                 const std::vector<double> &knotVector, const std::vector<double> &weights, double tolerance)
+    : m_degree(degree), m_controlPoints(controlPoints), m_knotVector(knotVector), m_weights(weights),
+      m_tolerance(tolerance), m_homogeneous(degree + 1) {}
+
+  /* Approximates the curve by points, one at the start of every knot span
+   * and as many inside it as are needed to keep the polyline within
+   * the tolerance of the curve. The end of the curve is left out.
+   */
+  void flatten(std::vector<std::pair<double, double> > &points)
+  {
+    if (m_controlPoints.size() <= m_degree || m_knotVector.size() < m_controlPoints.size() + m_degree + 1)
+      return;
+    bool hasSpanEnd = false;
+    std::pair<double, double> spanEnd;
+    for (unsigned span = m_degree; span < m_controlPoints.size(); ++span)
+    {
+      const double u0 = m_knotVector[span];
+      const double u1 = m_knotVector[span + 1];
+      if (!(u1 - u0 > LIBVISIO_EPSILON))
+        continue;
+      double x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+      const bool ok0 = evaluate(span, u0, x0, y0);
+      const bool ok1 = evaluate(span, u1, x1, y1);
+      // Knots of too high multiplicity break the curve
+      if (hasSpanEnd && (!ok0 || hypot(x0 - spanEnd.first, y0 - spanEnd.second) > m_tolerance))
+        points.push_back(spanEnd);
+      if (ok0)
+        points.push_back(std::make_pair(x0, y0));
+      if (ok0 && ok1)
+        subdivide(span, u0, x0, y0, u1, x1, y1, 0, points);
+      hasSpanEnd = ok1;
+      spanEnd = std::make_pair(x1, y1);
+    }
+  }
+
+private:
+  // de Boor's algorithm on the homogeneous control points of one knot span
+  bool evaluate(unsigned span, double u, double &x, double &y)
+  {
+    for (unsigned j = 0; j <= m_degree; ++j)
+    {
+      const unsigned i = span - m_degree + j;
+      const double weight = i < m_weights.size() ? m_weights[i] : 0.0;
+      m_homogeneous[j].x = m_controlPoints[i].first * weight;
+      m_homogeneous[j].y = m_controlPoints[i].second * weight;
+      m_homogeneous[j].w = weight;
+    }
+    for (unsigned r = 1; r <= m_degree; ++r)
+    {
+      for (unsigned j = m_degree; j >= r; --j)
+      {
+        const unsigned i = span - m_degree + j;
+        const double denominator = m_knotVector[i + m_degree - r + 1] - m_knotVector[i];
+        const double alpha = denominator > LIBVISIO_EPSILON ? (u - m_knotVector[i]) / denominator : 0.0;
+        m_homogeneous[j].x = (1.0 - alpha) * m_homogeneous[j - 1].x + alpha * m_homogeneous[j].x;
+        m_homogeneous[j].y = (1.0 - alpha) * m_homogeneous[j - 1].y + alpha * m_homogeneous[j].y;
+        m_homogeneous[j].w = (1.0 - alpha) * m_homogeneous[j - 1].w + alpha * m_homogeneous[j].w;
+      }
+    }
+    const HomogeneousPoint &point = m_homogeneous[m_degree];
+    if (fabs(point.w) < LIBVISIO_EPSILON)
+      return false;
+    x = point.x / point.w;
+    y = point.y / point.w;
+    return true;
+  }
+
+  void subdivide(unsigned span, double u0, double x0, double y0, double u1, double x1, double y1,
+                 unsigned depth, std::vector<std::pair<double, double> > &points)
+  {
+    if (depth >= VSD_NURBS_MAX_SUBDIVISION_DEPTH)
+      return;
+    const double u = (u0 + u1) / 2.0;
+    double x = 0.0, y = 0.0;
+    if (!evaluate(span, u, x, y))
+      return;
+    // The quarter points are checked too, so that a sharp turn next to the middle is not missed
+    if (depth >= VSD_NURBS_MIN_SUBDIVISION_DEPTH && isNearChord(x, y, x0, y0, x1, y1))
+    {
+      double xq = 0.0, yq = 0.0;
+      if (evaluate(span, (u0 + u) / 2.0, xq, yq) && isNearChord(xq, yq, x0, y0, x1, y1)
+          && evaluate(span, (u + u1) / 2.0, xq, yq) && isNearChord(xq, yq, x0, y0, x1, y1))
+        return;
+    }
+    subdivide(span, u0, x0, y0, u, x, y, depth + 1, points);
+    points.push_back(std::make_pair(x, y));
+    subdivide(span, u, x, y, u1, x1, y1, depth + 1, points);
+  }
+
+  bool isNearChord(double x, double y, double x0, double y0, double x1, double y1) const
+  {
+    const double chord = hypot(x1 - x0, y1 - y0);
+    const double distance = chord > LIBVISIO_EPSILON
+                            ? fabs((x1 - x0) * (y0 - y) - (x0 - x) * (y1 - y0)) / chord
+                            : hypot(x - x0, y - y0);
+    return distance <= m_tolerance;
+  }
+
+  struct HomogeneousPoint
+  {
+    HomogeneousPoint() : x(0.0), y(0.0), w(0.0) {}
+    double x, y, w;
+  };
+
+  const unsigned m_degree;
+  const std::vector<std::pair<double, double> > &m_controlPoints;
+  const std::vector<double> &m_knotVector;
+  const std::vector<double> &m_weights;
+  const double m_tolerance;
+  std::vector<HomogeneousPoint> m_homogeneous;
+};
+
 } // anonymous namespace
 
 libvisio::VSDContentCollector::VSDContentCollector(
@@ -137,16 +306,32 @@ libvisio::VSDContentCollector::VSDContentCollector(
   m_currentPageNumber(0), m_shapeOutputDrawing(nullptr), m_shapeOutputText(nullptr),
   m_pageOutputDrawing(), m_pageOutputText(), m_documentPageShapeOrders(documentPageShapeOrders),
   m_pageShapeOrder(m_documentPageShapeOrders.begin()), m_isFirstGeometry(true), m_NURBSData(), m_polylineData(),
-  m_currentText(), m_names(), m_stencilNames(), m_fields(), m_stencilFields(), m_fieldIndex(0),
+  m_currentText(), m_names(), m_fields(), m_fieldIndex(0),
   m_charFormats(), m_paraFormats(), m_lineStyle(), m_fillStyle(), m_textBlockStyle(),
   m_defaultCharStyle(), m_defaultParaStyle(), m_currentStyleSheet(0), m_styles(styles),
   m_variationColorIndex(varColInd), m_variationStyleIndex(varStyInd),
+  m_documentVariationColorIndex(varColInd), m_documentVariationStyleIndex(varStyInd),
   m_stencils(stencils), m_stencilShape(nullptr), m_isStencilStarted(false), m_currentGeometryCount(0),
-  m_backgroundPageID(MINUS_ONE), m_currentPageID(0), m_currentPage(), m_pages(), m_layerList(),
+  m_backgroundPageID(MINUS_ONE), m_currentPageID(0), m_currentPage(), m_pages(), m_pagesOutput(nullptr), m_parseOptions(), m_layerList(),
   m_splineControlPoints(), m_splineKnotVector(), m_splineX(0.0), m_splineY(0.0),
   m_splineLastKnot(0.0), m_splineDegree(0), m_splineLevel(0), m_currentShapeLevel(0),
-  m_isBackgroundPage(false), m_currentLayerList(), m_currentLayerMem(), m_tabSets(), m_documentTheme(nullptr), m_currentShapeType()
+  m_isBackgroundPage(false), m_currentLayerList(), m_currentLayerMem(), m_tabSets(), m_documentTheme(nullptr), m_currentShapeType(),
+  m_isShapeTransformValid(false), m_shapeTransform(), m_shapeTransformFlipX(false), m_shapeTransformFlipY(false),
+  m_stencilShapeTemplates(), m_stencilShapeTemplate(), m_converters()
+{
+  m_pages.setStreamingPainter(m_painter);
+}
+
+libvisio::VSDContentCollector::~VSDContentCollector()
 {
+  // Pages were streamed, but the parsing failed before endPages
+  try
+  {
+    m_pages.cancelStreaming();
+  }
+  catch (...)
+  {
+  }
 }
 
 const char *libvisio::VSDContentCollector::_linePropertiesMarkerViewbox(unsigned marker)
@@ -1382,10 +1567,12 @@ void libvisio::VSDContentCollector::_flushCurrentPage()
 void libvisio::VSDContentCollector::collectDocumentTheme(const VSDXTheme *theme)
 {
   if (theme)
+  {
     m_documentTheme = theme;
+    m_stencilShapeTemplates.clear();
+  }
 }
 
-#define LIBVISIO_EPSILON 1E-10
 void libvisio::VSDContentCollector::collectEllipticalArcTo(unsigned /* id */, unsigned level, double x3, double y3, double x2, double y2, double angle, double ecc)
 {
   _handleLevelChange(level);
@@ -1755,44 +1942,13 @@ void libvisio::VSDContentCollector::_handleForeignData(const librevenge::RVNGBin
       m_currentForeignData.append((unsigned char)((dataOff >> 24) & 0xff));
     }
     m_currentForeignData.append(binaryData);
-
-    if (m_foreignType == 1)
-    {
-      switch (m_foreignFormat)
-      {
-      case 0:
-      case 255:
-        m_currentForeignProps.insert("librevenge:mime-type", "image/bmp");
-        break;
-      case 1:
-        m_currentForeignProps.insert("librevenge:mime-type", "image/jpeg");
-        break;
-      case 2:
-        m_currentForeignProps.insert("librevenge:mime-type", "image/gif");
-        break;
-      case 3:
-        m_currentForeignProps.insert("librevenge:mime-type", "image/tiff");
-        break;
-      case 4:
-        m_currentForeignProps.insert("librevenge:mime-type", "image/png");
-        break;
-      }
-    }
-    else if (m_foreignType == 0 || m_foreignType == 4)
-    {
-      const unsigned char *tmpBinData = m_currentForeignData.getDataBuffer();
-      // Check for EMF signature
-      if (m_currentForeignData.size() > 0x2B && tmpBinData[0x28] == 0x20 && tmpBinData[0x29] == 0x45 && tmpBinData[0x2A] == 0x4D && tmpBinData[0x2B] == 0x46)
-        m_currentForeignProps.insert("librevenge:mime-type", "image/emf");
-      else
-        m_currentForeignProps.insert("librevenge:mime-type", "image/wmf");
-    }
   }
   else if (m_foreignType == 2)
-  {
-    m_currentForeignProps.insert("librevenge:mime-type", "object/ole");
     m_currentForeignData.append(binaryData);
-  }
+
+  const librevenge::RVNGString mimeType = _getForeignMimeType();
+  if (!mimeType.empty())
+    m_currentForeignProps.insert("librevenge:mime-type", mimeType);
 
 #if DUMP_BITMAP
   librevenge::RVNGString filename;
@@ -1846,6 +2002,39 @@ void libvisio::VSDContentCollector::_handleForeignData(const librevenge::RVNGBin
 #endif
 }
 
+librevenge::RVNGString libvisio::VSDContentCollector::_getForeignMimeType() const
+{
+  if (m_foreignType == 1)
+  {
+    switch (m_foreignFormat)
+    {
+    case 0:
+    case 255:
+      return "image/bmp";
+    case 1:
+      return "image/jpeg";
+    case 2:
+      return "image/gif";
+    case 3:
+      return "image/tiff";
+    case 4:
+      return "image/png";
+    }
+  }
+  else if (m_foreignType == 0 || m_foreignType == 4)
+  {
+    const unsigned char *tmpBinData = m_currentForeignData.getDataBuffer();
+    // Check for EMF signature
+    if (m_currentForeignData.size() > 0x2B && tmpBinData[0x28] == 0x20 && tmpBinData[0x29] == 0x45 && tmpBinData[0x2A] == 0x4D && tmpBinData[0x2B] == 0x46)
+      return "image/emf";
+    else
+      return "image/wmf";
+  }
+  else if (m_foreignType == 2)
+    return "object/ole";
+  return librevenge::RVNGString();
+}
+
 void libvisio::VSDContentCollector::collectGeometry(unsigned /* id */, unsigned level, bool noFill, bool noLine, bool noShow)
 {
   _handleLevelChange(level);
@@ -2080,7 +2269,20 @@ void libvisio::VSDContentCollector::_generateBezierSegmentsFromNURBS(unsigned de
       _outputLinearBezierSegment(points);
       break;
     case 2:
-      _outputQuadraticBezierSegment(points);
+      if (m_parseOptions.getCurveOutput() == VisioParseOptions::CURVES_AS_CUBIC_BEZIER)
+      {
+        // Degree elevation is exact
+        std::vector<std::pair<double, double> > cubicPoints(4);
+        cubicPoints[0] = points[0];
+        cubicPoints[1].first = points[0].first + 2.0 * (points[1].first - points[0].first) / 3.0;
+        cubicPoints[1].second = points[0].second + 2.0 * (points[1].second - points[0].second) / 3.0;
+        cubicPoints[2].first = points[2].first + 2.0 * (points[1].first - points[2].first) / 3.0;
+        cubicPoints[2].second = points[2].second + 2.0 * (points[1].second - points[2].second) / 3.0;
+        cubicPoints[3] = points[2];
+        _outputCubicBezierSegment(cubicPoints);
+      }
+      else
+        _outputQuadraticBezierSegment(points);
       break;
     case 3:
       _outputCubicBezierSegment(points);
@@ -2105,61 +2307,55 @@ void libvisio::VSDContentCollector::_generateBezierSegmentsFromNURBS(unsigned de
   }
 }
 
-double libvisio::VSDContentCollector::_NURBSBasis(unsigned knot, unsigned degree, double point, const std::vector<double> &knotVector)
+void libvisio::VSDContentCollector::_flattenNURBS(unsigned id, unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
+                                                  const std::vector<double> &knotVector, const std::vector<double> &weights,
+                                                  std::vector<std::pair<double, double> > &points)
 {
-  double basis = 0;
-  if (knotVector.empty())
-    return basis;
-  if (degree == 0)
+  const double tolerance = _getCurveTolerance(controlPoints);
+  if (!m_isStencilStarted || !m_stencilShapeTemplate)
   {
-    if (knotVector[knot] <= point && point < knotVector[knot+1])
-      return 1;
-    else
-      return 0;
+    NURBSFlattener(degree, controlPoints, knotVector, weights, tolerance).flatten(points);
+    return;
   }
-  if (knotVector.size() > knot+degree && fabs(knotVector[knot+degree]-knotVector[knot]) > LIBVISIO_EPSILON)
-    basis = (point-knotVector[knot])/(knotVector[knot+degree]-knotVector[knot]) * _NURBSBasis(knot, degree-1, point, knotVector);
-
-  if (knotVector.size() > knot+degree+1 && fabs(knotVector[knot+degree+1] - knotVector[knot+1]) > LIBVISIO_EPSILON)
-    basis += (knotVector[knot+degree+1]-point)/(knotVector[knot+degree+1]-knotVector[knot+1]) * _NURBSBasis(knot+1, degree-1, point, knotVector);
 
-  return basis;
+  // Instances of a master of the same size share the flattened curves of its geometry
+  StencilShapeTemplate::FlattenedCurve &curve = m_stencilShapeTemplate->flattenedCurves[std::make_pair(m_currentGeometryCount, id)];
+  if (curve.degree != degree || curve.tolerance != tolerance || curve.controlPoints != controlPoints
+      || curve.knotVector != knotVector || curve.weights != weights)
+  {
+    curve.degree = degree;
+    curve.controlPoints = controlPoints;
+    curve.knotVector = knotVector;
+    curve.weights = weights;
+    curve.tolerance = tolerance;
+    curve.points.clear();
+    NURBSFlattener(degree, controlPoints, knotVector, weights, tolerance).flatten(curve.points);
+  }
+  points = curve.points;
 }
 
-#define VSD_NUM_POLYLINES_PER_KNOT 100
-
-void libvisio::VSDContentCollector::_generatePolylineFromNURBS(unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
+void libvisio::VSDContentCollector::_generatePolylineFromNURBS(unsigned id, unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
                                                                const std::vector<double> &knotVector, const std::vector<double> &weights)
 {
   if (m_noShow)
     return;
 
+  std::vector<std::pair<double, double> > points;
+  _flattenNURBS(id, degree, controlPoints, knotVector, weights, points);
+
   if (!m_noFill)
-    m_currentFillGeometry.reserve(VSD_NUM_POLYLINES_PER_KNOT * knotVector.size());
+    m_currentFillGeometry.reserve(m_currentFillGeometry.size() + points.size());
   if (!m_noLine)
-    m_currentLineGeometry.reserve(VSD_NUM_POLYLINES_PER_KNOT * knotVector.size());
+    m_currentLineGeometry.reserve(m_currentLineGeometry.size() + points.size());
 
-  for (size_t i = 0; i < VSD_NUM_POLYLINES_PER_KNOT * knotVector.size(); i++)
+  for (auto &point : points)
   {
     librevenge::RVNGPropertyList node;
 
     node.insert("librevenge:path-action", "L");
-    double x = 0;
-    double y = 0;
-    double denominator = LIBVISIO_EPSILON;
-
-    for (unsigned p = 0; p < controlPoints.size() && p < weights.size(); p++)
-    {
-      double basis = _NURBSBasis(p, degree, (double)i / (VSD_NUM_POLYLINES_PER_KNOT * knotVector.size()), knotVector);
-      x += basis * controlPoints[p].first * weights[p];
-      y += basis * controlPoints[p].second * weights[p];
-      denominator += weights[p] * basis;
-    }
-    x /= denominator;
-    y /= denominator;
-    transformPoint(x, y);
-    node.insert("svg:x", m_scale*x);
-    node.insert("svg:y", m_scale*y);
+    transformPoint(point.first, point.second);
+    node.insert("svg:x", m_scale*point.first);
+    node.insert("svg:y", m_scale*point.second);
 
     if (!m_noFill)
       m_currentFillGeometry.push_back(node);
@@ -2168,6 +2364,26 @@ void libvisio::VSDContentCollector::_generatePolylineFromNURBS(unsigned degree,
   }
 }
 
+double libvisio::VSDContentCollector::_getCurveTolerance(const std::vector<std::pair<double, double> > &controlPoints) const
+{
+  if (!m_parseOptions.isCurveToleranceRelative() || controlPoints.empty())
+    return m_parseOptions.getCurveTolerance();
+
+  // The curve lies within the bounding box of its control points
+  double xmin = controlPoints[0].first;
+  double xmax = xmin;
+  double ymin = controlPoints[0].second;
+  double ymax = ymin;
+  for (const auto &point : controlPoints)
+  {
+    xmin = (std::min)(xmin, point.first);
+    xmax = (std::max)(xmax, point.first);
+    ymin = (std::min)(ymin, point.second);
+    ymax = (std::max)(ymax, point.second);
+  }
+  return m_parseOptions.getCurveTolerance() * hypot(xmax - xmin, ymax - ymin);
+}
+
 bool libvisio::VSDContentCollector::_isUniform(const std::vector<double> &weights) const
 {
   if (weights.empty())
@@ -2185,7 +2401,7 @@ bool libvisio::VSDContentCollector::_isUniform(const std::vector<double> &weight
 
 #define MAX_ALLOWED_NURBS_DEGREE 8
 
-void libvisio::VSDContentCollector::collectNURBSTo(unsigned /* id */, unsigned level, double x2, double y2,
+void libvisio::VSDContentCollector::collectNURBSTo(unsigned id, unsigned level, double x2, double y2,
                                                    unsigned char xType, unsigned char yType, unsigned degree, const std::vector<std::pair<double, double> > &ctrlPnts,
                                                    const std::vector<double> &kntVec, const std::vector<double> &weights)
 {
@@ -2237,10 +2453,10 @@ void libvisio::VSDContentCollector::collectNURBSTo(unsigned /* id */, unsigned l
     knot /= lastKnot;
   }
 
-  if (degree <= 3 && _isUniform(weights))
+  if (degree <= 3 && _isUniform(weights) && m_parseOptions.getCurveOutput() != VisioParseOptions::CURVES_AS_LINES)
     _generateBezierSegmentsFromNURBS(degree, controlPoints, knotVector);
   else
-    _generatePolylineFromNURBS(degree, controlPoints, knotVector, weights);
+    _generatePolylineFromNURBS(id, degree, controlPoints, knotVector, weights);
 
   m_originalX = x2;
   m_originalY = y2;
@@ -2456,36 +2672,30 @@ void libvisio::VSDContentCollector::transformPoint(double &x, double &y, XForm *
   if (!m_currentShapeId)
     return;
 
-  unsigned shapeId = m_currentShapeId;
-
-  std::set<unsigned> visitedShapes; // avoid mutually nested shapes in broken files
-  visitedShapes.insert(shapeId);
+  if (!m_isShapeTransformValid)
+    _updateShapeTransform();
 
   if (txtxform)
     applyXForm(x, y, *txtxform);
 
-  while (true && m_groupXForms)
+  // The same steps as applyXForm, without looking the xforms up again
+  for (const auto &step : m_shapeTransform)
   {
-    auto iterX = m_groupXForms->find(shapeId);
-    if (iterX != m_groupXForms->end())
-    {
-      XForm xform = iterX->second;
-      applyXForm(x, y, xform);
-    }
-    else
-      break;
-    bool shapeFound = false;
-    if (m_groupMemberships != m_groupMembershipsSequence.end())
+    x -= step.pinLocX;
+    y -= step.pinLocY;
+    if (step.flipX)
+      x = -x;
+    if (step.flipY)
+      y = -y;
+    if (step.rotate)
     {
-      auto iter = m_groupMemberships->find(shapeId);
-      if (iter != m_groupMemberships->end() && shapeId != iter->second)
-      {
-        shapeId = iter->second;
-        shapeFound = visitedShapes.insert(shapeId).second;
-      }
+      double tmpX = x*step.cosAngle - y*step.sinAngle;
+      double tmpY = y*step.cosAngle + x*step.sinAngle;
+      x = tmpX;
+      y = tmpY;
     }
-    if (!shapeFound)
-      break;
+    x += step.pinX;
+    y += step.pinY;
   }
   y = m_pageHeight - y;
 }
@@ -2517,24 +2727,51 @@ void libvisio::VSDContentCollector::transformFlips(bool &flipX, bool &flipY)
   if (!m_currentShapeId)
     return;
 
+  if (!m_isShapeTransformValid)
+    _updateShapeTransform();
+
+  if (m_shapeTransformFlipX)
+    flipX = !flipX;
+  if (m_shapeTransformFlipY)
+    flipY = !flipY;
+}
+
+// Collects the xforms of the current shape and of the groups containing it,
+// so that transforming a point does not need to walk the groups again.
+void libvisio::VSDContentCollector::_updateShapeTransform()
+{
+  m_shapeTransform.clear();
+  m_shapeTransformFlipX = false;
+  m_shapeTransformFlipY = false;
+
   unsigned shapeId = m_currentShapeId;
 
   std::set<unsigned> visitedShapes; // avoid mutually nested shapes in broken files
   visitedShapes.insert(shapeId);
 
-  while (true && m_groupXForms)
+  while (m_groupXForms)
   {
     auto iterX = m_groupXForms->find(shapeId);
-    if (iterX != m_groupXForms->end())
-    {
-      XForm xform = iterX->second;
-      if (xform.flipX)
-        flipX = !flipX;
-      if (xform.flipY)
-        flipY = !flipY;
-    }
-    else
+    if (iterX == m_groupXForms->end())
       break;
+    const XForm &xform = iterX->second;
+    if (xform.flipX)
+      m_shapeTransformFlipX = !m_shapeTransformFlipX;
+    if (xform.flipY)
+      m_shapeTransformFlipY = !m_shapeTransformFlipY;
+
+    ShapeTransformStep step;
+    step.pinX = xform.pinX;
+    step.pinY = xform.pinY;
+    step.pinLocX = xform.pinLocX;
+    step.pinLocY = xform.pinLocY;
+    step.flipX = xform.flipX;
+    step.flipY = xform.flipY;
+    step.rotate = xform.angle != 0.0;
+    step.cosAngle = step.rotate ? cos(xform.angle) : 1.0;
+    step.sinAngle = step.rotate ? sin(xform.angle) : 0.0;
+    m_shapeTransform.push_back(step);
+
     bool shapeFound = false;
     if (m_groupMemberships != m_groupMembershipsSequence.end())
     {
@@ -2548,6 +2785,7 @@ void libvisio::VSDContentCollector::transformFlips(bool &flipX, bool &flipY)
     if (!shapeFound)
       break;
   }
+  m_isShapeTransformValid = true;
 }
 
 void libvisio::VSDContentCollector::collectShapesOrder(unsigned /* id */, unsigned level, const std::vector<unsigned> & /* shapeIds */)
@@ -2573,6 +2811,7 @@ void libvisio::VSDContentCollector::collectPageProps(unsigned /* id */, unsigned
   _handleLevelChange(level);
   m_pageWidth = pageWidth;
   m_pageHeight = pageHeight;
+  m_isShapeTransformValid = false;
   m_scale = scale;
   m_shadowOffsetX = shadowOffsetX;
   m_shadowOffsetY = shadowOffsetY;
@@ -2630,6 +2869,7 @@ void libvisio::VSDContentCollector::collectShape(unsigned id, unsigned level, un
 
   m_currentShapeId = id;
   m_parentShapeId = parent;
+  m_isShapeTransformValid = false;
   m_pageOutputDrawing[m_currentShapeId] = VSDOutputElementList();
   m_pageOutputText[m_currentShapeId] = VSDOutputElementList();
   m_shapeOutputDrawing = &m_pageOutputDrawing[m_currentShapeId];
@@ -2638,12 +2878,11 @@ void libvisio::VSDContentCollector::collectShape(unsigned id, unsigned level, un
   m_isFirstGeometry = true;
 
   m_names.clear();
-  m_stencilNames.clear();
   m_fields.clear();
-  m_stencilFields.clear();
 
   // Get stencil shape
   m_stencilShape = m_stencils.getStencilShape(masterPage, masterShape);
+  m_stencilShapeTemplate.reset();
   // Initialize the shape from stencil content
   m_lineStyle = VSDLineStyle();
   m_fillStyle = VSDFillStyle();
@@ -2660,51 +2899,27 @@ void libvisio::VSDContentCollector::collectShape(unsigned id, unsigned level, un
       m_foreignOffsetY = m_stencilShape->m_foreign->offsetY;
       m_foreignWidth = m_stencilShape->m_foreign->width;
       m_foreignHeight = m_stencilShape->m_foreign->height;
-      m_currentForeignData.clear();
-      _handleForeignData(m_stencilShape->m_foreign->data);
     }
 
-    for (const auto &name : m_stencilShape->m_names)
+    m_stencilShapeTemplate = _getStencilShapeTemplate(masterPage, masterShape);
+
+    if (m_stencilShape->m_foreign)
     {
-      librevenge::RVNGString nameString;
-      _convertDataToString(nameString, name.second.m_data, name.second.m_format);
-      m_stencilNames[name.first] = nameString;
+      m_currentForeignData = m_stencilShapeTemplate->foreignData;
+      if (!m_stencilShapeTemplate->foreignMimeType.empty())
+        m_currentForeignProps.insert("librevenge:mime-type", m_stencilShapeTemplate->foreignMimeType);
     }
 
     if (m_stencilShape->m_txtxform)
       m_txtxform.reset(new XForm(*(m_stencilShape->m_txtxform)));
 
-    m_stencilFields = m_stencilShape->m_fields;
-    for (size_t i = 0; i < m_stencilFields.size(); i++)
-    {
-      VSDFieldListElement *elem = m_stencilFields.getElement(i);
-      if (elem)
-        m_fields.push_back(elem->getString(m_stencilNames, m_defaultDrawingUnit));
-      else
-        m_fields.push_back(librevenge::RVNGString());
-    }
-
-    if (m_stencilShape->m_lineStyleId != MINUS_ONE)
-      m_lineStyle.override(m_styles.getOptionalLineStyle(m_stencilShape->m_lineStyleId), m_documentTheme);
-
-    m_lineStyle.override(m_stencilShape->m_lineStyle, m_documentTheme);
-
-    bool bDefault = _isDefaultShapeFormat();
-    if (m_stencilShape->m_fillStyleId != MINUS_ONE)
-      m_fillStyle.override(m_styles.getOptionalFillStyle(m_stencilShape->m_fillStyleId), !bDefault ? m_documentTheme : nullptr);
-
-    m_fillStyle.override(m_stencilShape->m_fillStyle, !bDefault ? m_documentTheme : nullptr);
+    m_fields = m_stencilShapeTemplate->fields;
 
-    if (m_stencilShape->m_textStyleId != MINUS_ONE)
-    {
-      m_defaultCharStyle.override(m_styles.getOptionalCharStyle(m_stencilShape->m_textStyleId), m_documentTheme);
-      m_defaultParaStyle.override(m_styles.getOptionalParaStyle(m_stencilShape->m_textStyleId), m_documentTheme);
-      m_textBlockStyle.override(m_styles.getOptionalTextBlockStyle(m_stencilShape->m_textStyleId), m_documentTheme);
-    }
-
-    m_textBlockStyle.override(m_stencilShape->m_textBlockStyle, m_documentTheme);
-    m_defaultCharStyle.override(m_stencilShape->m_charStyle, m_documentTheme);
-    m_defaultParaStyle.override(m_stencilShape->m_paraStyle, m_documentTheme);
+    m_lineStyle = m_stencilShapeTemplate->lineStyle;
+    m_fillStyle = _isDefaultShapeFormat() ? m_stencilShapeTemplate->fillStyle : m_stencilShapeTemplate->themedFillStyle;
+    m_textBlockStyle = m_stencilShapeTemplate->textBlockStyle;
+    m_defaultCharStyle = m_stencilShapeTemplate->charStyle;
+    m_defaultParaStyle = m_stencilShapeTemplate->paraStyle;
   }
 
   if (lineStyleId != MINUS_ONE)
@@ -2890,6 +3105,7 @@ void libvisio::VSDContentCollector::collectStyleSheet(unsigned id, unsigned leve
   m_styles.addLineStyleMaster(m_currentStyleSheet, lineStyleParent);
   m_styles.addFillStyleMaster(m_currentStyleSheet, fillStyleParent);
   m_styles.addTextStyleMaster(m_currentStyleSheet, textStyleParent);
+  m_stencilShapeTemplates.clear();
 }
 
 void libvisio::VSDContentCollector::collectLineStyle(unsigned /* level */, const std::optional<double> &strokeWidth, const std::optional<Colour> &c,
@@ -2900,6 +3116,7 @@ void libvisio::VSDContentCollector::collectLineStyle(unsigned /* level */, const
 {
   VSDOptionalLineStyle lineStyle(strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, qsLineColour, qsLineMatrix);
   m_styles.addLineStyle(m_currentStyleSheet, lineStyle);
+  m_stencilShapeTemplates.clear();
 }
 
 void libvisio::VSDContentCollector::collectFillStyle(unsigned /* level */, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
@@ -2912,6 +3129,7 @@ void libvisio::VSDContentCollector::collectFillStyle(unsigned /* level */, const
   VSDOptionalFillStyle fillStyle(colourFG, colourBG, fillPattern, fillFGTransparency, fillBGTransparency, shfgc, shadowPattern,
                                  shadowOffsetX, shadowOffsetY, qsFillColour, qsShadowColour, qsFillMatrix, m_variationColorIndex, m_variationStyleIndex);
   m_styles.addFillStyle(m_currentStyleSheet, fillStyle);
+  m_stencilShapeTemplates.clear();
 
 }
 
@@ -2936,6 +3154,7 @@ void libvisio::VSDContentCollector::collectParaIXStyle(unsigned /* id */, unsign
   VSDOptionalParaStyle paraStyle(charCount, indFirst, indLeft, indRight, spLine, spBefore, spAfter, align,
                                  bullet, bulletStr, bulletFont, bulletFontSize, textPosAfterBullet, flags);
   m_styles.addParaStyle(m_currentStyleSheet, paraStyle);
+  m_stencilShapeTemplates.clear();
 }
 
 
@@ -2949,6 +3168,7 @@ void libvisio::VSDContentCollector::collectCharIXStyle(unsigned /* id */, unsign
   VSDOptionalCharStyle charStyle(charCount, font, fontColour, fontSize, bold, italic, underline, doubleunderline, strikeout, doublestrikeout,
                                  allcaps, initcaps, smallcaps, superscript, subscript, scaleWidth);
   m_styles.addCharStyle(m_currentStyleSheet, charStyle);
+  m_stencilShapeTemplates.clear();
 }
 
 void libvisio::VSDContentCollector::collectTextBlockStyle(unsigned /* level */, const std::optional<double> &leftMargin, const std::optional<double> &rightMargin,
@@ -2958,6 +3178,7 @@ void libvisio::VSDContentCollector::collectTextBlockStyle(unsigned /* level */,
 {
   VSDOptionalTextBlockStyle textBlockStyle(leftMargin, rightMargin, topMargin, bottomMargin, verticalAlign, isBgFilled, bgColour, defaultTabStop, textDirection);
   m_styles.addTextBlockStyle(m_currentStyleSheet, textBlockStyle);
+  m_stencilShapeTemplates.clear();
 }
 
 void libvisio::VSDContentCollector::_lineProperties(const VSDLineStyle &style, librevenge::RVNGPropertyList &styleProps)
@@ -3501,11 +3722,11 @@ void libvisio::VSDContentCollector::collectFieldList(unsigned /* id */, unsigned
 void libvisio::VSDContentCollector::collectTextField(unsigned id, unsigned level, int nameId, int formatStringId)
 {
   _handleLevelChange(level);
-  VSDFieldListElement *element = m_stencilFields.getElement(m_fields.size());
+  VSDFieldListElement *element = m_stencilShapeTemplate ? m_stencilShapeTemplate->fieldList.getElement(m_fields.size()) : nullptr;
   if (element)
   {
     if (nameId == -2)
-      m_fields.push_back(element->getString(m_stencilNames, m_defaultDrawingUnit));
+      m_fields.push_back(element->getString(m_stencilShapeTemplate->names, m_defaultDrawingUnit));
     else
     {
       if (nameId >= 0)
@@ -3524,7 +3745,7 @@ void libvisio::VSDContentCollector::collectTextField(unsigned id, unsigned level
 void libvisio::VSDContentCollector::collectNumericField(unsigned id, unsigned level, unsigned short format, unsigned short cellType, double number, int formatStringId)
 {
   _handleLevelChange(level);
-  VSDFieldListElement *pElement = m_stencilFields.getElement(m_fields.size());
+  VSDFieldListElement *pElement = m_stencilShapeTemplate ? m_stencilShapeTemplate->fieldList.getElement(m_fields.size()) : nullptr;
   if (pElement)
   {
     std::unique_ptr<VSDFieldListElement> element{pElement->clone()};
@@ -3608,6 +3829,65 @@ bool libvisio::VSDContentCollector::_isDefaultShapeFormat()
   return bDefault;
 }
 
+std::shared_ptr<libvisio::VSDContentCollector::StencilShapeTemplate> libvisio::VSDContentCollector::_getStencilShapeTemplate(unsigned masterPage, unsigned masterShape)
+{
+  std::shared_ptr<StencilShapeTemplate> &shapeTemplatePtr = m_stencilShapeTemplates[std::make_pair(masterPage, masterShape)];
+  if (shapeTemplatePtr)
+    return shapeTemplatePtr;
+  shapeTemplatePtr = std::make_shared<StencilShapeTemplate>();
+  StencilShapeTemplate &shapeTemplate = *shapeTemplatePtr;
+
+  // The foreign type and format of the master are already set
+  if (m_stencilShape->m_foreign)
+  {
+    m_currentForeignData.clear();
+    _handleForeignData(m_stencilShape->m_foreign->data);
+    shapeTemplate.foreignData = m_currentForeignData;
+    shapeTemplate.foreignMimeType = _getForeignMimeType();
+  }
+
+  for (const auto &name : m_stencilShape->m_names)
+  {
+    librevenge::RVNGString nameString;
+    _convertDataToString(nameString, name.second.m_data, name.second.m_format);
+    shapeTemplate.names[name.first] = nameString;
+  }
+
+  shapeTemplate.fieldList = m_stencilShape->m_fields;
+  for (size_t i = 0; i < shapeTemplate.fieldList.size(); i++)
+  {
+    VSDFieldListElement *elem = shapeTemplate.fieldList.getElement(i);
+    if (elem)
+      shapeTemplate.fields.push_back(elem->getString(shapeTemplate.names, m_defaultDrawingUnit));
+    else
+      shapeTemplate.fields.push_back(librevenge::RVNGString());
+  }
+
+  if (m_stencilShape->m_lineStyleId != MINUS_ONE)
+    shapeTemplate.lineStyle.override(m_styles.getOptionalLineStyle(m_stencilShape->m_lineStyleId), m_documentTheme);
+  shapeTemplate.lineStyle.override(m_stencilShape->m_lineStyle, m_documentTheme);
+
+  if (m_stencilShape->m_fillStyleId != MINUS_ONE)
+  {
+    shapeTemplate.fillStyle.override(m_styles.getOptionalFillStyle(m_stencilShape->m_fillStyleId), nullptr);
+    shapeTemplate.themedFillStyle.override(m_styles.getOptionalFillStyle(m_stencilShape->m_fillStyleId), m_documentTheme);
+  }
+  shapeTemplate.fillStyle.override(m_stencilShape->m_fillStyle, nullptr);
+  shapeTemplate.themedFillStyle.override(m_stencilShape->m_fillStyle, m_documentTheme);
+
+  if (m_stencilShape->m_textStyleId != MINUS_ONE)
+  {
+    shapeTemplate.charStyle.override(m_styles.getOptionalCharStyle(m_stencilShape->m_textStyleId), m_documentTheme);
+    shapeTemplate.paraStyle.override(m_styles.getOptionalParaStyle(m_stencilShape->m_textStyleId), m_documentTheme);
+    shapeTemplate.textBlockStyle.override(m_styles.getOptionalTextBlockStyle(m_stencilShape->m_textStyleId), m_documentTheme);
+  }
+  shapeTemplate.textBlockStyle.override(m_stencilShape->m_textBlockStyle, m_documentTheme);
+  shapeTemplate.charStyle.override(m_stencilShape->m_charStyle, m_documentTheme);
+  shapeTemplate.paraStyle.override(m_stencilShape->m_paraStyle, m_documentTheme);
+
+  return shapeTemplatePtr;
+}
+
 void libvisio::VSDContentCollector::collectMetaData(const librevenge::RVNGPropertyList &metaData)
 {
   m_pages.setMetaData(metaData);
@@ -3630,6 +3910,25 @@ void libvisio::VSDContentCollector::startPage(unsigned pageId)
     m_groupMemberships = m_groupMembershipsSequence.begin() + (m_currentPageNumber-1);
   if (m_documentPageShapeOrders.size() >= m_currentPageNumber)
     m_pageShapeOrder = m_documentPageShapeOrders.begin() + (m_currentPageNumber-1);
+  m_isShapeTransformValid = false;
+  // Nothing is carried over from the page before, so that the pages come
+  // out the same when they are collected apart
+  m_pageWidth = 0.0;
+  m_pageHeight = 0.0;
+  m_shadowOffsetX = 0.0;
+  m_shadowOffsetY = 0.0;
+  m_scale = 1.0;
+  m_defaultDrawingUnit = 0;
+  m_variationColorIndex = m_documentVariationColorIndex;
+  m_variationStyleIndex = m_documentVariationStyleIndex;
+  m_currentLayerList.clear();
+  m_currentLayerMem.clear();
+  m_NURBSData.clear();
+  m_polylineData.clear();
+  m_currentForeignData.clear();
+  m_currentForeignProps.clear();
+  m_splineControlPoints.clear();
+  m_splineKnotVector.clear();
   m_currentPage = libvisio::VSDPage();
   m_currentPage.m_currentPageID = pageId;
   m_isPageStarted = true;
@@ -3656,7 +3955,48 @@ void libvisio::VSDContentCollector::endPage()
 
 void libvisio::VSDContentCollector::endPages()
 {
-  m_pages.draw(m_painter);
+  // Hand the finished pages over instead of drawing them, if somebody wants to keep them.
+  // A broken document can end its pages more than once, so they are copied rather than moved.
+  if (m_pagesOutput)
+    *m_pagesOutput = m_pages;
+  else
+    m_pages.endStreaming();
+}
+
+void libvisio::VSDContentCollector::setPageSelection(const VSDPageSelection &pageSelection)
+{
+  m_pages.setPageSelection(pageSelection);
+}
+
+void libvisio::VSDContentCollector::setPagesOutput(VSDPages *pages)
+{
+  m_pagesOutput = pages;
+  // Kept pages have to be complete
+  m_pages.setStreamingPainter(m_pagesOutput ? nullptr : m_painter);
+}
+
+void libvisio::VSDContentCollector::setParseOptions(const VisioParseOptions &options)
+{
+  m_parseOptions = options;
+}
+
+// Number of pages that came before the next one
+void libvisio::VSDContentCollector::setPageNumber(unsigned pageNumber)
+{
+  m_currentPageNumber = pageNumber;
+}
+
+// Moves the pages finished so far to pages
+void libvisio::VSDContentCollector::takePages(VSDPages &pages)
+{
+  pages = std::move(m_pages);
+  m_pages = VSDPages();
+  m_pages.setStreamingPainter(m_pagesOutput ? nullptr : m_painter);
+}
+
+void libvisio::VSDContentCollector::appendPages(const VSDPages &pages)
+{
+  m_pages.append(pages);
 }
 
 bool libvisio::VSDContentCollector::parseFormatId(const char *formatString, unsigned short &result)
@@ -3727,9 +4067,11 @@ void libvisio::VSDContentCollector::appendCharacters(librevenge::RVNGString &tex
     0x23A0, 0x23A4, 0x23A5, 0x23A6, 0x23AB, 0x23AC, 0x23AD, 0x0020  // .. 0xFE
   };
 
-  UChar32  ucs4Character = 0;
+  std::string buffer;
+  buffer.reserve(characters.size());
   if (format == VSD_TEXT_SYMBOL) // SYMBOL
   {
+    UChar32  ucs4Character = 0;
     for (unsigned char character : characters)
     {
       if (0x1e == ucs4Character)
@@ -3738,97 +4080,101 @@ void libvisio::VSDContentCollector::appendCharacters(librevenge::RVNGString &tex
         ucs4Character = 0x20;
       else
         ucs4Character = symbolmap[character - 0x20];
-      appendUCS4(text, ucs4Character);
+      appendUCS4(buffer, ucs4Character);
     }
   }
   else
+    _appendConverted(buffer, characters, format);
+  text.append(buffer.c_str());
+}
+
+void libvisio::VSDContentCollector::appendCharacters(librevenge::RVNGString &text, const std::vector<unsigned char> &characters)
+{
+  std::string buffer;
+  buffer.reserve(characters.size());
+  _appendUTF16LE(buffer, characters);
+  text.append(buffer.c_str());
+}
+
+void libvisio::VSDContentCollector::_appendUTF16LE(std::string &text, const std::vector<unsigned char> &characters)
+{
+  // Unpaired surrogates and a truncated last unit become U+FFFD, as with ICU
+  const size_t length = characters.size();
+  size_t i = 0;
+  for (; i + 1 < length; i += 2)
   {
-    UErrorCode status = U_ZERO_ERROR;
-    UConverter *conv = nullptr;
-    switch (format)
-    {
-    case VSD_TEXT_JAPANESE:
-      conv = ucnv_open("windows-932", &status);
-      break;
-    case VSD_TEXT_KOREAN:
-      conv = ucnv_open("windows-949", &status);
-      break;
-    case VSD_TEXT_CHINESE_SIMPLIFIED:
-      conv = ucnv_open("windows-936", &status);
-      break;
-    case VSD_TEXT_CHINESE_TRADITIONAL:
-      conv = ucnv_open("windows-950", &status);
-      break;
-    case VSD_TEXT_GREEK:
-      conv = ucnv_open("windows-1253", &status);
-      break;
-    case VSD_TEXT_TURKISH:
-      conv = ucnv_open("windows-1254", &status);
-      break;
-    case VSD_TEXT_VIETNAMESE:
-      conv = ucnv_open("windows-1258", &status);
-      break;
-    case VSD_TEXT_HEBREW:
-      conv = ucnv_open("windows-1255", &status);
-      break;
-    case VSD_TEXT_ARABIC:
-      conv = ucnv_open("windows-1256", &status);
-      break;
-    case VSD_TEXT_BALTIC:
-      conv = ucnv_open("windows-1257", &status);
-      break;
-    case VSD_TEXT_RUSSIAN:
-      conv = ucnv_open("windows-1251", &status);
-      break;
-    case VSD_TEXT_THAI:
-      conv = ucnv_open("windows-874", &status);
-      break;
-    case VSD_TEXT_CENTRAL_EUROPE:
-      conv = ucnv_open("windows-1250", &status);
-      break;
-    default:
-      conv = ucnv_open("windows-1252", &status);
-      break;
-    }
-    if (U_SUCCESS(status) && conv)
+    UChar32 ucs4Character = characters[i] | (characters[i + 1] << 8);
+    if (U16_IS_SURROGATE(ucs4Character))
     {
-      const auto *src = (const char *)characters.data();
-      const char *srcLimit = (const char *)src + characters.size();
-      while (src < srcLimit)
+      const UChar32 trail = i + 3 < length ? characters[i + 2] | (characters[i + 3] << 8) : 0;
+      if (U16_IS_SURROGATE_LEAD(ucs4Character) && U16_IS_TRAIL(trail))
       {
-        ucs4Character = ucnv_getNextUChar(conv, &src, srcLimit, &status);
-        if (U_SUCCESS(status) && U_IS_UNICODE_CHAR(ucs4Character))
-        {
-          if (0x1e == ucs4Character)
-            appendUCS4(text, 0xfffc);
-          else
-            appendUCS4(text, ucs4Character);
-        }
+        ucs4Character = U16_GET_SUPPLEMENTARY(ucs4Character, trail);
+        i += 2;
+      }
+      else
+      {
+        // A lead surrogate is truncated together with an odd last byte
+        if (U16_IS_SURROGATE_LEAD(ucs4Character) && i + 3 == length)
+          ++i;
+        ucs4Character = 0xfffd;
       }
     }
-    if (conv)
-      ucnv_close(conv);
+    if (U_IS_UNICODE_CHAR(ucs4Character))
+      appendUCS4(text, ucs4Character);
   }
+  if (i < length)
+    appendUCS4(text, 0xfffd);
 }
 
-void libvisio::VSDContentCollector::appendCharacters(librevenge::RVNGString &text, const std::vector<unsigned char> &characters)
+void libvisio::VSDContentCollector::_appendConverted(std::string &text, const std::vector<unsigned char> &characters, TextFormat format)
 {
-  UErrorCode status = U_ZERO_ERROR;
-  UConverter *conv = ucnv_open("UTF-16LE", &status);
+  if (isPlainASCII(characters))
+  {
+    for (unsigned char character : characters)
+      appendUCS4(text, 0x1e == character ? 0xfffc : character);
+    return;
+  }
 
-  if (U_SUCCESS(status) && conv)
+  UConverter *conv = _getConverter(format);
+  if (!conv)
+    return;
+  UErrorCode status = U_ZERO_ERROR;
+  const auto *src = (const char *)characters.data();
+  const char *srcLimit = (const char *)src + characters.size();
+  while (src < srcLimit)
   {
-    const auto *src = (const char *)characters.data();
-    const char *srcLimit = (const char *)src + characters.size();
-    while (src < srcLimit)
+    UChar32 ucs4Character = ucnv_getNextUChar(conv, &src, srcLimit, &status);
+    if (U_SUCCESS(status) && U_IS_UNICODE_CHAR(ucs4Character))
     {
-      UChar32 ucs4Character = ucnv_getNextUChar(conv, &src, srcLimit, &status);
-      if (U_SUCCESS(status) && U_IS_UNICODE_CHAR(ucs4Character))
+      if (0x1e == ucs4Character)
+        appendUCS4(text, 0xfffc);
+      else
         appendUCS4(text, ucs4Character);
     }
   }
-  if (conv)
+}
+
+UConverter *libvisio::VSDContentCollector::_getConverter(TextFormat format)
+{
+  auto it = m_converters.find(format);
+  if (it != m_converters.end())
+  {
+    if (it->second)
+      ucnv_resetToUnicode(it->second.get());
+    return it->second.get();
+  }
+
+  UErrorCode status = U_ZERO_ERROR;
+  UConverter *conv = ucnv_open(getCodePage(format), &status);
+  if (U_FAILURE(status) && conv)
+  {
     ucnv_close(conv);
+    conv = nullptr;
+  }
+  // A converter that failed to open is remembered as well
+  m_converters[format].reset(conv);
+  return conv;
 }
 
 void libvisio::VSDContentCollector::_appendField(librevenge::RVNGString &text)
@@ -18,6 +18,7 @@
 #include <memory>
 #include <list>
 #include <vector>
+#include <unicode/ucnv.h>
 #include "libvisio_utils.h"
 #include "VSDCollector.h"
 #include "VSDParser.h"
@@ -28,7 +29,7 @@
 namespace libvisio
 {
 
-class VSDContentCollector : public VSDCollector
+class VSDContentCollector final : public VSDCollector
 {
 public:
   VSDContentCollector(
@@ -39,6 +40,7 @@ public:
     VSDStyles &styles, VSDStencils &stencils, const std::optional<unsigned> &varColInd,
     const std::optional<unsigned> &varStyInd
   );
+  ~VSDContentCollector() override;
 
   void collectDocumentTheme(const VSDXTheme *theme) override;
   void collectEllipticalArcTo(unsigned id, unsigned level, double x3, double y3, double x2, double y2, double angle, double ecc) override;
@@ -178,10 +180,21 @@ public:
   void endPage() override;
   void endPages() override;
 
+  void setPageSelection(const VSDPageSelection &pageSelection);
+  void setPagesOutput(VSDPages *pages);
+  void setParseOptions(const VisioParseOptions &options);
+
+  // For collectors that only get some of the pages of a document
+  void setPageNumber(unsigned pageNumber);
+  void takePages(VSDPages &pages);
+  void appendPages(const VSDPages &pages);
 
 private:
   VSDContentCollector(const VSDContentCollector &);
   VSDContentCollector &operator=(const VSDContentCollector &);
+
+  struct StencilShapeTemplate;
+
   librevenge::RVNGDrawingInterface *m_painter;
 
   void applyXForm(double &x, double &y, const XForm &xform);
@@ -189,8 +202,7 @@ private:
   void transformPoint(double &x, double &y, XForm *txtxform = nullptr);
   void transformAngle(double &angle, XForm *txtxform = nullptr);
   void transformFlips(bool &flipX, bool &flipY);
-
-  double _NURBSBasis(unsigned knot, unsigned degree, double point, const std::vector<double> &knotVector);
+  void _updateShapeTransform();
 
   void _flushShape();
   void _flushCurrentPath(unsigned id);
@@ -200,8 +212,10 @@ private:
 
   void _handleLevelChange(unsigned level);
   bool _isDefaultShapeFormat();
+  std::shared_ptr<StencilShapeTemplate> _getStencilShapeTemplate(unsigned masterPage, unsigned masterShape);
 
   void _handleForeignData(const librevenge::RVNGBinaryData &data);
+  librevenge::RVNGString _getForeignMimeType() const;
 
   void _lineProperties(const VSDLineStyle &style, librevenge::RVNGPropertyList &styleProps);
   void _fillAndShadowProperties(const VSDFillStyle &style, librevenge::RVNGPropertyList &styleProps);
@@ -213,13 +227,20 @@ private:
 
   void appendCharacters(librevenge::RVNGString &text, const std::vector<unsigned char> &characters, TextFormat format);
   void appendCharacters(librevenge::RVNGString &text, const std::vector<unsigned char> &characters);
+  void _appendUTF16LE(std::string &text, const std::vector<unsigned char> &characters);
+  void _appendConverted(std::string &text, const std::vector<unsigned char> &characters, TextFormat format);
+  UConverter *_getConverter(TextFormat format);
   void _convertDataToString(librevenge::RVNGString &result, const librevenge::RVNGBinaryData &data, TextFormat format);
   bool parseFormatId(const char *formatString, unsigned short &result);
   void _appendField(librevenge::RVNGString &text);
 
   // NURBS processing functions
   bool _isUniform(const std::vector<double> &weights) const;
-  void _generatePolylineFromNURBS(unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
+  double _getCurveTolerance(const std::vector<std::pair<double, double> > &controlPoints) const;
+  void _flattenNURBS(unsigned id, unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
+                     const std::vector<double> &knotVector, const std::vector<double> &weights,
+                     std::vector<std::pair<double, double> > &points);
+  void _generatePolylineFromNURBS(unsigned id, unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
                                   const std::vector<double> &knotVector, const std::vector<double> &weights);
   void _generateBezierSegmentsFromNURBS(unsigned degree, const std::vector<std::pair<double, double> > &controlPoints,
                                         const std::vector<double> &knotVector);
@@ -283,9 +304,8 @@ private:
   std::map<unsigned, NURBSData> m_NURBSData;
   std::map<unsigned, PolylineData> m_polylineData;
   libvisio::VSDName m_currentText;
-  std::map<unsigned, librevenge::RVNGString> m_names, m_stencilNames;
+  std::map<unsigned, librevenge::RVNGString> m_names;
   std::vector<librevenge::RVNGString> m_fields;
-  VSDFieldList m_stencilFields;
   unsigned m_fieldIndex;
   std::vector<VSDCharStyle> m_charFormats;
   std::vector<VSDParaStyle> m_paraFormats;
@@ -302,6 +322,9 @@ private:
 
   std::optional<unsigned> m_variationColorIndex;
   std::optional<unsigned> m_variationStyleIndex;
+  // What the pages start with, before their page sheet overrides it
+  const std::optional<unsigned> m_documentVariationColorIndex;
+  const std::optional<unsigned> m_documentVariationStyleIndex;
 
   VSDStencils m_stencils;
   const VSDShape *m_stencilShape;
@@ -313,6 +336,8 @@ private:
   unsigned m_currentPageID;
   VSDPage m_currentPage;
   VSDPages m_pages;
+  VSDPages *m_pagesOutput;
+  VisioParseOptions m_parseOptions;
 
   VSDLayerList m_layerList;
 
@@ -331,6 +356,58 @@ private:
 
   const VSDXTheme *m_documentTheme;
   librevenge::RVNGString m_currentShapeType;
+
+  // The xforms of the current shape and of the groups containing it, innermost first
+  struct ShapeTransformStep
+  {
+    double pinX, pinY, pinLocX, pinLocY;
+    double cosAngle, sinAngle;
+    bool flipX, flipY, rotate;
+  };
+  bool m_isShapeTransformValid;
+  std::vector<ShapeTransformStep> m_shapeTransform;
+  bool m_shapeTransformFlipX, m_shapeTransformFlipY;
+
+  // What the instances of a master shape inherit from it, prepared once
+  struct StencilShapeTemplate
+  {
+    StencilShapeTemplate()
+      : names(), fieldList(), fields(), foreignData(), foreignMimeType(), lineStyle(), fillStyle(),
+        themedFillStyle(), textBlockStyle(), charStyle(), paraStyle(), flattenedCurves() {}
+    std::map<unsigned, librevenge::RVNGString> names;
+    VSDFieldList fieldList;
+    std::vector<librevenge::RVNGString> fields;
+    librevenge::RVNGBinaryData foreignData;
+    librevenge::RVNGString foreignMimeType;
+    VSDLineStyle lineStyle;
+    // Without and with the document theme applied
+    VSDFillStyle fillStyle, themedFillStyle;
+    VSDTextBlockStyle textBlockStyle;
+    VSDCharStyle charStyle;
+    VSDParaStyle paraStyle;
+    // Flattened NURBS of the master geometry, by geometry and element, with the input they were flattened from
+    struct FlattenedCurve
+    {
+      FlattenedCurve() : degree(0), controlPoints(), knotVector(), weights(), tolerance(0.0), points() {}
+      unsigned degree;
+      std::vector<std::pair<double, double> > controlPoints;
+      std::vector<double> knotVector, weights;
+      double tolerance;
+      std::vector<std::pair<double, double> > points;
+    };
+    std::map<std::pair<unsigned, unsigned>, FlattenedCurve> flattenedCurves;
+  };
+  std::map<std::pair<unsigned, unsigned>, std::shared_ptr<StencilShapeTemplate> > m_stencilShapeTemplates;
+  std::shared_ptr<StencilShapeTemplate> m_stencilShapeTemplate;
+
+  struct ConverterDeleter
+  {
+    void operator()(UConverter *conv) const
+    {
+      ucnv_close(conv);
+    }
+  };
+  std::map<TextFormat, std::unique_ptr<UConverter, ConverterDeleter> > m_converters;
 };
 
 } // namespace libvisio
@@ -917,18 +917,9 @@ void libvisio::VSDGeometryList::handle(VSDCollector *collector) const
   }
   else
   {
-    std::vector<unsigned> tmpVector;
-
-    for (auto iter = m_elements.begin(); iter != m_elements.end(); ++iter)
-      tmpVector.push_back(iter->first);
-    std::sort(tmpVector.begin(), tmpVector.end());
-
-    for (unsigned int i : tmpVector)
-    {
-      auto iter = m_elements.find(i);
-      if (iter != m_elements.end())
-        iter->second->handle(collector);
-    }
+    // The map is already ordered by the element index
+    for (const auto &element : m_elements)
+      element.second->handle(collector);
   }
   collector->collectSplineEnd();
 }
@@ -11,68 +11,154 @@
 
 #include <string.h>
 
-VSDInternalStream::VSDInternalStream(librevenge::RVNGInputStream *input, unsigned long size, bool compressed) :
-  librevenge::RVNGInputStream(),
-  m_offset(0),
-  m_buffer()
+#include <algorithm>
+
+namespace
 {
-  unsigned long tmpNumBytesRead = 0;
 
-  const unsigned char *tmpBuffer = input->read(size, tmpNumBytesRead);
+// Back-references address a 4 KiB window whose write position starts at 18 (4078 == 4096 - 18),
+// with positions not written yet reading as zeroes.
+const unsigned VSD_LZ77_WINDOW_SIZE = 4096;
+const unsigned VSD_LZ77_MAX_MATCH = 18;
 
-  if (tmpNumBytesRead < 2)
-    return;
+void decompress(const unsigned char *input, unsigned long inputSize, std::vector<unsigned char> &output)
+{
+  // Size the output for a typical compression ratio up front and grow it
+  // geometrically, so that the hot loop does not need to check every byte.
+  output.resize(4 * inputSize);
 
-  if (!compressed)
-  {
-    m_buffer.assign(tmpBuffer, tmpBuffer + tmpNumBytesRead);
-  }
-  else
+  unsigned long pos = 0;
+  unsigned long offset = 0;
+
+  while (offset < inputSize)
   {
-    unsigned char buffer[4096] = { 0 };
-    unsigned pos = 0;
-    unsigned offset = 0;
+    unsigned flag = input[offset++];
+    if (offset > inputSize-1)
+      break;
 
-    while (offset < tmpNumBytesRead)
-    {
-      unsigned flag = tmpBuffer[offset++];
-      if (offset > tmpNumBytesRead-1)
-        break;
+    // One flag byte yields at most 8 * VSD_LZ77_MAX_MATCH bytes; keep that
+    // much slack so copies below can be done in fixed-size blocks.
+    if (output.size() < pos + 8 * VSD_LZ77_MAX_MATCH)
+      output.resize(std::max<unsigned long>(2 * output.size(), pos + 8 * VSD_LZ77_MAX_MATCH));
 
-      unsigned mask = 1;
-      for (unsigned bit = 0; bit < 8 && offset < tmpNumBytesRead; ++bit)
+    for (unsigned bit = 0; bit < 8 && offset < inputSize;)
+    {
+      if (flag & (1u << bit))
       {
-        if (flag & mask)
+        // Copy the whole run of literals at once
+        unsigned count = 1;
+        while (bit + count < 8 && (flag & (1u << (bit + count))))
+          ++count;
+        if (count > inputSize - offset)
+          count = unsigned(inputSize - offset);
+        if (inputSize - offset >= 8)
+          memcpy(&output[pos], &input[offset], 8);
+        else
+          memcpy(&output[pos], &input[offset], count);
+        pos += count;
+        offset += count;
+        bit += count;
+      }
+      else
+      {
+        if (offset > inputSize-2)
+          break;
+        const unsigned char addr1 = input[offset++];
+        const unsigned char addr2 = input[offset++];
+        ++bit;
+
+        const unsigned length = (addr2&15) + 3;
+        unsigned pointer = (((unsigned)addr2 & 0xF0) << 4) | addr1;
+        if (pointer > 4078)
+          pointer -= 4078;
+        else
+          pointer += 18;
+
+        // Distance between the current output position and the referenced
+        // window position; 0 means a whole window back.
+        unsigned long distance = (pos - pointer) & (VSD_LZ77_WINDOW_SIZE - 1);
+        if (!distance)
+          distance = VSD_LZ77_WINDOW_SIZE;
+
+        unsigned char *const dest = &output[pos];
+        if (distance <= pos && distance >= VSD_LZ77_MAX_MATCH)
         {
-          buffer[pos&4095] = tmpBuffer[offset++];
-          m_buffer.push_back(buffer[pos&4095]);
-          pos++;
+          memcpy(dest, dest - distance, VSD_LZ77_MAX_MATCH);
+        }
+        else if (distance <= pos && distance >= length)
+        {
+          memcpy(dest, dest - distance, length);
         }
         else
         {
-          if (offset > tmpNumBytesRead-2)
-            break;
-          unsigned char addr1 = tmpBuffer[offset++];
-          unsigned char addr2 = tmpBuffer[offset++];
-
-          unsigned length = (addr2&15) + 3;
-          unsigned pointer = (((unsigned)addr2 & 0xF0) << 4) | addr1;
-          if (pointer > 4078)
-            pointer -= 4078;
-          else
-            pointer += 18;
-
+          // Overlapping copy, or reference into the zero-filled initial window
           for (unsigned j = 0; j < length; ++j)
-          {
-            buffer[(pos+j) & 4095] = buffer[(pointer+j) & 4095];
-            m_buffer.push_back(buffer[(pointer+j) & 4095]);
-          }
-          pos += length;
+            dest[j] = (pos + j >= distance) ? output[pos + j - distance] : 0;
         }
-        mask = mask << 1;
+        pos += length;
       }
     }
   }
+  output.resize(pos);
+}
+
+} // anonymous namespace
+
+VSDInternalStream::VSDInternalStream(librevenge::RVNGInputStream *input, unsigned long size, bool compressed) :
+  librevenge::RVNGInputStream(),
+  m_offset(0),
+  m_buffer(),
+  m_data(nullptr),
+  m_size(0)
+{
+  auto buffer = std::make_shared<std::vector<unsigned char> >();
+  m_buffer = buffer;
+
+  unsigned long tmpNumBytesRead = 0;
+
+  const unsigned char *tmpBuffer = input->read(size, tmpNumBytesRead);
+
+  if (tmpNumBytesRead >= 2)
+  {
+    if (!compressed)
+      buffer->assign(tmpBuffer, tmpBuffer + tmpNumBytesRead);
+    else
+      decompress(tmpBuffer, tmpNumBytesRead, *buffer);
+  }
+
+  m_data = buffer->data();
+  m_size = buffer->size();
+}
+
+VSDInternalStream::VSDInternalStream(const std::shared_ptr<const std::vector<unsigned char> > &buffer) :
+  VSDInternalStream(buffer, 0, buffer ? buffer->size() : 0)
+{
+}
+
+VSDInternalStream::VSDInternalStream(const std::shared_ptr<const std::vector<unsigned char> > &buffer, unsigned long offset, unsigned long length) :
+  librevenge::RVNGInputStream(),
+  m_offset(0),
+  m_buffer(buffer),
+  m_data(nullptr),
+  m_size(0)
+{
+  if (!m_buffer)
+    m_buffer = std::make_shared<std::vector<unsigned char> >();
+  if (offset > m_buffer->size())
+    offset = m_buffer->size();
+  if (length > m_buffer->size() - offset)
+    length = m_buffer->size() - offset;
+  m_data = m_buffer->data() + offset;
+  m_size = length;
+}
+
+VSDInternalStream::VSDInternalStream(const unsigned char *data, unsigned long length) :
+  librevenge::RVNGInputStream(),
+  m_offset(0),
+  m_buffer(),
+  m_data(data),
+  m_size(data ? length : 0)
+{
 }
 
 const unsigned char *VSDInternalStream::read(unsigned long numBytes, unsigned long &numBytesRead)
@@ -84,10 +170,10 @@ const unsigned char *VSDInternalStream::read(unsigned long numBytes, unsigned lo
 
   int numBytesToRead;
 
-  if (numBytes < m_buffer.size() - m_offset)
+  if (numBytes < m_size - m_offset)
     numBytesToRead = numBytes;
   else
-    numBytesToRead = m_buffer.size() - m_offset;
+    numBytesToRead = m_size - m_offset;
 
   numBytesRead = numBytesToRead; // about as paranoid as we can be..
 
@@ -97,7 +183,7 @@ const unsigned char *VSDInternalStream::read(unsigned long numBytes, unsigned lo
   long oldOffset = m_offset;
   m_offset += numBytesToRead;
 
-  return &m_buffer[oldOffset];
+  return m_data + oldOffset;
 }
 
 int VSDInternalStream::seek(long offset, librevenge::RVNG_SEEK_TYPE seekType)
@@ -107,16 +193,16 @@ int VSDInternalStream::seek(long offset, librevenge::RVNG_SEEK_TYPE seekType)
   else if (seekType == librevenge::RVNG_SEEK_SET)
     m_offset = offset;
   else if (seekType == librevenge::RVNG_SEEK_END)
-    m_offset = long(static_cast<unsigned long>(m_buffer.size())) + offset;
+    m_offset = long(m_size) + offset;
 
   if (m_offset < 0)
   {
     m_offset = 0;
     return 1;
   }
-  if ((long)m_offset > (long)m_buffer.size())
+  if ((long)m_offset > (long)m_size)
   {
-    m_offset = m_buffer.size();
+    m_offset = m_size;
     return 1;
   }
 
@@ -130,7 +216,7 @@ long VSDInternalStream::tell()
 
 bool VSDInternalStream::isEnd()
 {
-  if ((long)m_offset >= (long)m_buffer.size())
+  if ((long)m_offset >= (long)m_size)
     return true;
 
   return false;
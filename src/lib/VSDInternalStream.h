@@ -12,6 +12,7 @@
 #define __VSDINTERNALSTREAM_H__
 
 #include <stddef.h>
+#include <memory>
 #include <vector>
 #include <librevenge-stream/librevenge-stream.h>
 
@@ -19,6 +20,11 @@ class VSDInternalStream : public librevenge::RVNGInputStream
 {
 public:
   VSDInternalStream(librevenge::RVNGInputStream *input, unsigned long size, bool compressed=false);
+  explicit VSDInternalStream(const std::shared_ptr<const std::vector<unsigned char> > &buffer);
+  // A view of length bytes of buffer, starting at offset. The data are not copied.
+  VSDInternalStream(const std::shared_ptr<const std::vector<unsigned char> > &buffer, unsigned long offset, unsigned long length);
+  // A view of length bytes at data, which have to outlive the stream. The data are not copied.
+  VSDInternalStream(const unsigned char *data, unsigned long length);
   ~VSDInternalStream() override {}
 
   bool isStructured() override
@@ -51,12 +57,22 @@ public:
   bool isEnd() override;
   unsigned long getSize() const
   {
-    return m_buffer.size();
+    return m_size;
   };
+  const unsigned char *getData() const
+  {
+    return m_data;
+  }
+  const std::shared_ptr<const std::vector<unsigned char> > &getBuffer() const
+  {
+    return m_buffer;
+  }
 
 private:
   volatile long m_offset;
-  std::vector<unsigned char> m_buffer;
+  std::shared_ptr<const std::vector<unsigned char> > m_buffer;
+  const unsigned char *m_data;
+  unsigned long m_size;
   VSDInternalStream(const VSDInternalStream &);
   VSDInternalStream &operator=(const VSDInternalStream &);
 };
@@ -9,6 +9,8 @@
 
 #include "VSDOutputElementList.h"
 
+#include <deque>
+
 #include "libvisio_utils.h"
 
 namespace libvisio
@@ -57,459 +59,39 @@ static void separateSpacesAndInsertText(librevenge::RVNGDrawingInterface *iface,
 
 } // anonymous namespace
 
-class VSDOutputElement
-{
-public:
-  VSDOutputElement() {}
-  virtual ~VSDOutputElement() {}
-  virtual void draw(librevenge::RVNGDrawingInterface *painter) = 0;
-  virtual VSDOutputElement *clone() = 0;
-};
-
-
-class VSDStyleOutputElement : public VSDOutputElement
-{
-public:
-  VSDStyleOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDStyleOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDStyleOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDPathOutputElement : public VSDOutputElement
-{
-public:
-  VSDPathOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDPathOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDPathOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDGraphicObjectOutputElement : public VSDOutputElement
-{
-public:
-  VSDGraphicObjectOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDGraphicObjectOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDGraphicObjectOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDStartTextObjectOutputElement : public VSDOutputElement
+// Payloads of the elements. Elements only point to them, so lists can share
+// them instead of copying them. Entries are never modified or removed once
+// added, and std::deque does not move them when it grows.
+struct VSDOutputElementList::Arena
 {
-public:
-  VSDStartTextObjectOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDStartTextObjectOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDStartTextObjectOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDOpenParagraphOutputElement : public VSDOutputElement
-{
-public:
-  VSDOpenParagraphOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDOpenParagraphOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDOpenParagraphOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDStartLayerOutputElement : public VSDOutputElement
-{
-public:
-  VSDStartLayerOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDStartLayerOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDStartLayerOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDEndLayerOutputElement : public VSDOutputElement
-{
-public:
-  VSDEndLayerOutputElement();
-  ~VSDEndLayerOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDEndLayerOutputElement();
-  }
-};
-
-
-class VSDOpenSpanOutputElement : public VSDOutputElement
-{
-public:
-  VSDOpenSpanOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDOpenSpanOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDOpenSpanOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDInsertTextOutputElement : public VSDOutputElement
-{
-public:
-  VSDInsertTextOutputElement(const librevenge::RVNGString &text);
-  ~VSDInsertTextOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDInsertTextOutputElement(m_text);
-  }
-private:
-  librevenge::RVNGString m_text;
+  Arena() : m_propLists(), m_strings() {}
+  std::deque<librevenge::RVNGPropertyList> m_propLists;
+  std::deque<librevenge::RVNGString> m_strings;
 };
 
-
-class VSDInsertLineBreakOutputElement : public VSDOutputElement
-{
-public:
-  VSDInsertLineBreakOutputElement();
-  ~VSDInsertLineBreakOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDInsertLineBreakOutputElement();
-  }
-};
-
-
-class VSDInsertTabOutputElement : public VSDOutputElement
-{
-public:
-  VSDInsertTabOutputElement();
-  ~VSDInsertTabOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDInsertTabOutputElement();
-  }
-};
-
-
-class VSDCloseSpanOutputElement : public VSDOutputElement
-{
-public:
-  VSDCloseSpanOutputElement();
-  ~VSDCloseSpanOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDCloseSpanOutputElement();
-  }
-};
-
-
-class VSDCloseParagraphOutputElement : public VSDOutputElement
-{
-public:
-  VSDCloseParagraphOutputElement();
-  ~VSDCloseParagraphOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDCloseParagraphOutputElement();
-  }
-};
-
-
-class VSDEndTextObjectOutputElement : public VSDOutputElement
-{
-public:
-  VSDEndTextObjectOutputElement();
-  ~VSDEndTextObjectOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDEndTextObjectOutputElement();
-  }
-};
-
-class VSDOpenListElementOutputElement : public VSDOutputElement
-{
-public:
-  VSDOpenListElementOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDOpenListElementOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDOpenListElementOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDCloseListElementOutputElement : public VSDOutputElement
-{
-public:
-  VSDCloseListElementOutputElement();
-  ~VSDCloseListElementOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDCloseListElementOutputElement();
-  }
-};
-
-
-class VSDOpenUnorderedListLevelOutputElement : public VSDOutputElement
-{
-public:
-  VSDOpenUnorderedListLevelOutputElement(const librevenge::RVNGPropertyList &propList);
-  ~VSDOpenUnorderedListLevelOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDOpenUnorderedListLevelOutputElement(m_propList);
-  }
-private:
-  librevenge::RVNGPropertyList m_propList;
-};
-
-
-class VSDCloseUnorderedListLevelOutputElement : public VSDOutputElement
-{
-public:
-  VSDCloseUnorderedListLevelOutputElement();
-  ~VSDCloseUnorderedListLevelOutputElement() override {}
-  void draw(librevenge::RVNGDrawingInterface *painter) override;
-  VSDOutputElement *clone() override
-  {
-    return new VSDCloseUnorderedListLevelOutputElement();
-  }
-};
-
-
 } // namespace libvisio
 
-libvisio::VSDStyleOutputElement::VSDStyleOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDStyleOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->setStyle(m_propList);
-}
-
-
-libvisio::VSDPathOutputElement::VSDPathOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDPathOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->drawPath(m_propList);
-}
-
-
-libvisio::VSDGraphicObjectOutputElement::VSDGraphicObjectOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDGraphicObjectOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->drawGraphicObject(m_propList);
-}
-
-
-libvisio::VSDStartTextObjectOutputElement::VSDStartTextObjectOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDStartTextObjectOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->startTextObject(m_propList);
-}
-
-libvisio::VSDOpenSpanOutputElement::VSDOpenSpanOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDOpenSpanOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->openSpan(m_propList);
-}
-
-
-libvisio::VSDStartLayerOutputElement::VSDStartLayerOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDStartLayerOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->startLayer(m_propList);
-}
-
-
-libvisio::VSDEndLayerOutputElement::VSDEndLayerOutputElement() {}
-
-void libvisio::VSDEndLayerOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->endLayer();
-}
-
-
-libvisio::VSDOpenParagraphOutputElement::VSDOpenParagraphOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDOpenParagraphOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->openParagraph(m_propList);
-}
-
-
-libvisio::VSDInsertTextOutputElement::VSDInsertTextOutputElement(const librevenge::RVNGString &text) :
-  m_text(text) {}
-
-void libvisio::VSDInsertTextOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    separateSpacesAndInsertText(painter, m_text);
-}
-
-libvisio::VSDInsertLineBreakOutputElement::VSDInsertLineBreakOutputElement() {}
-
-void libvisio::VSDInsertLineBreakOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->insertLineBreak();
-}
-
-libvisio::VSDInsertTabOutputElement::VSDInsertTabOutputElement() {}
-
-void libvisio::VSDInsertTabOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->insertTab();
-}
-
-libvisio::VSDCloseSpanOutputElement::VSDCloseSpanOutputElement() {}
-
-void libvisio::VSDCloseSpanOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->closeSpan();
-}
-
-
-libvisio::VSDCloseParagraphOutputElement::VSDCloseParagraphOutputElement() {}
-
-void libvisio::VSDCloseParagraphOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->closeParagraph();
-}
-
-
-libvisio::VSDEndTextObjectOutputElement::VSDEndTextObjectOutputElement() {}
-
-void libvisio::VSDEndTextObjectOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->endTextObject();
-}
-
-
-libvisio::VSDOpenListElementOutputElement::VSDOpenListElementOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDOpenListElementOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->openListElement(m_propList);
-}
-
-
-libvisio::VSDCloseListElementOutputElement::VSDCloseListElementOutputElement() {}
-
-void libvisio::VSDCloseListElementOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->closeListElement();
-}
-
-
-libvisio::VSDOpenUnorderedListLevelOutputElement::VSDOpenUnorderedListLevelOutputElement(const librevenge::RVNGPropertyList &propList) :
-  m_propList(propList) {}
-
-void libvisio::VSDOpenUnorderedListLevelOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->openUnorderedListLevel(m_propList);
-}
-
-
-libvisio::VSDCloseUnorderedListLevelOutputElement::VSDCloseUnorderedListLevelOutputElement() {}
-
-void libvisio::VSDCloseUnorderedListLevelOutputElement::draw(librevenge::RVNGDrawingInterface *painter)
-{
-  if (painter)
-    painter->closeUnorderedListLevel();
-}
-
-
 libvisio::VSDOutputElementList::VSDOutputElementList()
-  : m_elements()
+  : m_elements(), m_arenas(), m_arena()
 {
 }
 
 libvisio::VSDOutputElementList::VSDOutputElementList(const libvisio::VSDOutputElementList &elementList)
-  : m_elements()
+  : m_elements(elementList.m_elements), m_arenas(elementList.m_arenas), m_arena()
 {
-  for (const auto &elem : elementList.m_elements)
-    m_elements.push_back(clone(elem));
+  if (elementList.m_arena)
+    m_arenas.push_back(elementList.m_arena);
 }
 
 libvisio::VSDOutputElementList &libvisio::VSDOutputElementList::operator=(const libvisio::VSDOutputElementList &elementList)
 {
   if (&elementList != this)
   {
-    m_elements.clear();
-
-    for (const auto &elem : elementList.m_elements)
-      m_elements.push_back(clone(elem));
+    m_elements = elementList.m_elements;
+    m_arenas = elementList.m_arenas;
+    if (elementList.m_arena)
+      m_arenas.push_back(elementList.m_arena);
+    m_arena.reset();
   }
 
   return *this;
@@ -517,8 +99,20 @@ libvisio::VSDOutputElementList &libvisio::VSDOutputElementList::operator=(const
 
 void libvisio::VSDOutputElementList::append(const libvisio::VSDOutputElementList &elementList)
 {
-  for (const auto &elem : elementList.m_elements)
-    m_elements.push_back(clone(elem));
+  if (elementList.m_elements.empty())
+    return;
+  if (&elementList == this)
+  {
+    const VSDOutputElementList tmpList(elementList);
+    append(tmpList);
+    return;
+  }
+
+  m_elements.insert(m_elements.end(), elementList.m_elements.begin(), elementList.m_elements.end());
+  for (const auto &arena : elementList.m_arenas)
+    _addArena(arena);
+  if (elementList.m_arena)
+    _addArena(elementList.m_arena);
 }
 
 libvisio::VSDOutputElementList::~VSDOutputElementList()
@@ -527,98 +121,187 @@ libvisio::VSDOutputElementList::~VSDOutputElementList()
 
 void libvisio::VSDOutputElementList::draw(librevenge::RVNGDrawingInterface *painter) const
 {
+  if (!painter)
+    return;
+
   for (const auto &elem : m_elements)
-    elem->draw(painter);
+  {
+    switch (elem.m_type)
+    {
+    case STYLE:
+      painter->setStyle(*elem.m_propList);
+      break;
+    case PATH:
+      painter->drawPath(*elem.m_propList);
+      break;
+    case GRAPHIC_OBJECT:
+      painter->drawGraphicObject(*elem.m_propList);
+      break;
+    case START_TEXT_OBJECT:
+      painter->startTextObject(*elem.m_propList);
+      break;
+    case END_TEXT_OBJECT:
+      painter->endTextObject();
+      break;
+    case OPEN_UNORDERED_LIST_LEVEL:
+      painter->openUnorderedListLevel(*elem.m_propList);
+      break;
+    case CLOSE_UNORDERED_LIST_LEVEL:
+      painter->closeUnorderedListLevel();
+      break;
+    case OPEN_LIST_ELEMENT:
+      painter->openListElement(*elem.m_propList);
+      break;
+    case CLOSE_LIST_ELEMENT:
+      painter->closeListElement();
+      break;
+    case OPEN_PARAGRAPH:
+      painter->openParagraph(*elem.m_propList);
+      break;
+    case CLOSE_PARAGRAPH:
+      painter->closeParagraph();
+      break;
+    case OPEN_SPAN:
+      painter->openSpan(*elem.m_propList);
+      break;
+    case CLOSE_SPAN:
+      painter->closeSpan();
+      break;
+    case INSERT_TEXT:
+      separateSpacesAndInsertText(painter, *elem.m_text);
+      break;
+    case INSERT_LINE_BREAK:
+      painter->insertLineBreak();
+      break;
+    case INSERT_TAB:
+      painter->insertTab();
+      break;
+    case START_LAYER:
+      painter->startLayer(*elem.m_propList);
+      break;
+    case END_LAYER:
+      painter->endLayer();
+      break;
+    default:
+      break;
+    }
+  }
 }
 
 void libvisio::VSDOutputElementList::addStyle(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDStyleOutputElement>(propList));
+  _addElement(STYLE, propList);
 }
 
 void libvisio::VSDOutputElementList::addPath(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDPathOutputElement>(propList));
+  _addElement(PATH, propList);
 }
 
 void libvisio::VSDOutputElementList::addGraphicObject(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDGraphicObjectOutputElement>(propList));
+  _addElement(GRAPHIC_OBJECT, propList);
 }
 
 void libvisio::VSDOutputElementList::addStartTextObject(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDStartTextObjectOutputElement>(propList));
+  _addElement(START_TEXT_OBJECT, propList);
 }
 
 void libvisio::VSDOutputElementList::addOpenParagraph(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDOpenParagraphOutputElement>(propList));
+  _addElement(OPEN_PARAGRAPH, propList);
 }
 
 void libvisio::VSDOutputElementList::addOpenSpan(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDOpenSpanOutputElement>(propList));
+  _addElement(OPEN_SPAN, propList);
 }
 
 void libvisio::VSDOutputElementList::addInsertText(const librevenge::RVNGString &text)
 {
-  m_elements.push_back(std::make_unique<VSDInsertTextOutputElement>(text));
+  _getArena().m_strings.push_back(text);
+  Element elem(INSERT_TEXT);
+  elem.m_text = &m_arena->m_strings.back();
+  m_elements.push_back(elem);
 }
 
 void libvisio::VSDOutputElementList::addInsertLineBreak()
 {
-  m_elements.push_back(std::make_unique<VSDInsertLineBreakOutputElement>());
+  m_elements.push_back(Element(INSERT_LINE_BREAK));
 }
 
 void libvisio::VSDOutputElementList::addInsertTab()
 {
-  m_elements.push_back(std::make_unique<VSDInsertTabOutputElement>());
+  m_elements.push_back(Element(INSERT_TAB));
 }
 
 void libvisio::VSDOutputElementList::addCloseSpan()
 {
-  m_elements.push_back(std::make_unique<VSDCloseSpanOutputElement>());
+  m_elements.push_back(Element(CLOSE_SPAN));
 }
 
 void libvisio::VSDOutputElementList::addCloseParagraph()
 {
-  m_elements.push_back(std::make_unique<VSDCloseParagraphOutputElement>());
+  m_elements.push_back(Element(CLOSE_PARAGRAPH));
 }
 
 void libvisio::VSDOutputElementList::addEndTextObject()
 {
-  m_elements.push_back(std::make_unique<VSDEndTextObjectOutputElement>());
+  m_elements.push_back(Element(END_TEXT_OBJECT));
 }
 
 void libvisio::VSDOutputElementList::addStartLayer(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDStartLayerOutputElement>(propList));
+  _addElement(START_LAYER, propList);
 }
 
 void libvisio::VSDOutputElementList::addEndLayer()
 {
-  m_elements.push_back(std::make_unique<VSDEndLayerOutputElement>());
+  m_elements.push_back(Element(END_LAYER));
 }
 
 void libvisio::VSDOutputElementList::addOpenListElement(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDOpenListElementOutputElement>(propList));
+  _addElement(OPEN_LIST_ELEMENT, propList);
 }
 
 void libvisio::VSDOutputElementList::addOpenUnorderedListLevel(const librevenge::RVNGPropertyList &propList)
 {
-  m_elements.push_back(std::make_unique<VSDOpenUnorderedListLevelOutputElement>(propList));
+  _addElement(OPEN_UNORDERED_LIST_LEVEL, propList);
 }
 
 void libvisio::VSDOutputElementList::addCloseListElement()
 {
-  m_elements.push_back(std::make_unique<VSDCloseListElementOutputElement>());
+  m_elements.push_back(Element(CLOSE_LIST_ELEMENT));
 }
 
 void libvisio::VSDOutputElementList::addCloseUnorderedListLevel()
 {
-  m_elements.push_back(std::make_unique<VSDCloseUnorderedListLevelOutputElement>());
+  m_elements.push_back(Element(CLOSE_UNORDERED_LIST_LEVEL));
+}
+
+void libvisio::VSDOutputElementList::_addElement(ElementType type, const librevenge::RVNGPropertyList &propList)
+{
+  _getArena().m_propLists.push_back(propList);
+  Element elem(type);
+  elem.m_propList = &m_arena->m_propLists.back();
+  m_elements.push_back(elem);
+}
+
+libvisio::VSDOutputElementList::Arena &libvisio::VSDOutputElementList::_getArena()
+{
+  if (!m_arena)
+    m_arena = std::make_shared<Arena>();
+  return *m_arena;
+}
+
+void libvisio::VSDOutputElementList::_addArena(const std::shared_ptr<const Arena> &arena)
+{
+  // Appending the parts of the same list one after another is common
+  if (arena == m_arena || (!m_arenas.empty() && m_arenas.back() == arena))
+    return;
+  m_arenas.push_back(arena);
 }
 
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -19,8 +19,6 @@
 namespace libvisio
 {
 
-class VSDOutputElement;
-
 class VSDOutputElementList
 {
 public:
@@ -53,7 +51,47 @@ public:
     return m_elements.empty();
   }
 private:
-  std::vector<std::unique_ptr<VSDOutputElement>> m_elements;
+  enum ElementType
+  {
+    STYLE,
+    PATH,
+    GRAPHIC_OBJECT,
+    START_TEXT_OBJECT,
+    END_TEXT_OBJECT,
+    OPEN_UNORDERED_LIST_LEVEL,
+    CLOSE_UNORDERED_LIST_LEVEL,
+    OPEN_LIST_ELEMENT,
+    CLOSE_LIST_ELEMENT,
+    OPEN_PARAGRAPH,
+    CLOSE_PARAGRAPH,
+    OPEN_SPAN,
+    CLOSE_SPAN,
+    INSERT_TEXT,
+    INSERT_LINE_BREAK,
+    INSERT_TAB,
+    START_LAYER,
+    END_LAYER
+  };
+
+  struct Element
+  {
+    explicit Element(ElementType type) : m_type(type), m_propList(nullptr), m_text(nullptr) {}
+    ElementType m_type;
+    const librevenge::RVNGPropertyList *m_propList;
+    const librevenge::RVNGString *m_text;
+  };
+
+  struct Arena;
+
+  void _addElement(ElementType type, const librevenge::RVNGPropertyList &propList);
+  Arena &_getArena();
+  void _addArena(const std::shared_ptr<const Arena> &arena);
+
+  std::vector<Element> m_elements;
+  // Payloads shared with the lists the elements were appended from
+  std::vector<std::shared_ptr<const Arena> > m_arenas;
+  // Payloads of the elements added to this list
+  std::shared_ptr<Arena> m_arena;
 };
 
 
@@ -0,0 +1,86 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "VSDPageSelection.h"
+
+libvisio::VSDPageSelection::VSDPageSelection()
+  : m_pages(), m_isActive(false), m_isResolved(false), m_foregroundPages(), m_backgroundPages(),
+    m_selectedIds(), m_neededIds()
+{
+}
+
+libvisio::VSDPageSelection::VSDPageSelection(const std::vector<unsigned> &pages)
+  : m_pages(pages.begin(), pages.end()), m_isActive(true), m_isResolved(false), m_foregroundPages(),
+    m_backgroundPages(), m_selectedIds(), m_neededIds()
+{
+}
+
+libvisio::VSDPageSelection::~VSDPageSelection()
+{
+}
+
+void libvisio::VSDPageSelection::addPage(unsigned id, bool isBackgroundPage, unsigned backgroundPageID)
+{
+  if (isBackgroundPage)
+    m_backgroundPages[id] = backgroundPageID;
+  else
+    m_foregroundPages.push_back(std::make_pair(id, backgroundPageID));
+}
+
+void libvisio::VSDPageSelection::resolve()
+{
+  m_isResolved = true;
+  if (!m_isActive)
+    return;
+
+  std::map<unsigned, unsigned> backgrounds;
+  unsigned position = 0;
+  for (const auto &page : m_foregroundPages)
+  {
+    if (m_pages.count(position++))
+    {
+      m_selectedIds.insert(page.first);
+      backgrounds.insert(page);
+    }
+  }
+  for (const auto &page : m_backgroundPages)
+  {
+    if (m_pages.count(position++))
+    {
+      m_selectedIds.insert(page.first);
+      backgrounds.insert(page);
+    }
+  }
+
+  // Follow the chain of background pages of every selected page; only
+  // background pages are ever drawn below another page.
+  for (const auto &page : backgrounds)
+  {
+    m_neededIds.insert(page.first);
+    auto iter = m_backgroundPages.find(page.second);
+    while (iter != m_backgroundPages.end() && m_neededIds.insert(iter->first).second)
+      iter = m_backgroundPages.find(iter->second);
+  }
+}
+
+bool libvisio::VSDPageSelection::isPageNeeded(unsigned id) const
+{
+  if (!m_isActive || !m_isResolved)
+    return true;
+  return bool(m_neededIds.count(id));
+}
+
+bool libvisio::VSDPageSelection::isPageSelected(unsigned id) const
+{
+  if (!m_isActive || !m_isResolved)
+    return true;
+  return bool(m_selectedIds.count(id));
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
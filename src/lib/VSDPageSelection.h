@@ -0,0 +1,63 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __VSDPAGESELECTION_H__
+#define __VSDPAGESELECTION_H__
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace libvisio
+{
+
+// Pages requested by their position in the output, where the foreground pages
+// come in document order, followed by the background pages ordered by id.
+// Once all pages of the document are known, the selection is resolved into
+// the ids of the pages to emit and of the pages to parse, which include the
+// background pages the emitted ones are drawn on.
+class VSDPageSelection
+{
+public:
+  VSDPageSelection();
+  explicit VSDPageSelection(const std::vector<unsigned> &pages);
+  ~VSDPageSelection();
+
+  // An inactive selection selects all pages
+  bool isActive() const
+  {
+    return m_isActive;
+  }
+  bool isResolved() const
+  {
+    return m_isResolved;
+  }
+
+  void addPage(unsigned id, bool isBackgroundPage, unsigned backgroundPageID);
+  void resolve();
+
+  bool isPageNeeded(unsigned id) const;
+  bool isPageSelected(unsigned id) const;
+
+private:
+  std::set<unsigned> m_pages;
+  bool m_isActive;
+  bool m_isResolved;
+  // page id -> background page id
+  std::vector<std::pair<unsigned, unsigned> > m_foregroundPages;
+  std::map<unsigned, unsigned> m_backgroundPages;
+  std::set<unsigned> m_selectedIds;
+  std::set<unsigned> m_neededIds;
+};
+
+} // namespace libvisio
+
+#endif // __VSDPAGESELECTION_H__
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
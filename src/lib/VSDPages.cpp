@@ -9,6 +9,8 @@
 
 #include "VSDPages.h"
 
+#include <set>
+
 #include "libvisio_utils.h"
 
 libvisio::VSDPage::VSDPage()
@@ -55,18 +57,32 @@ void libvisio::VSDPage::draw(librevenge::RVNGDrawingInterface *painter) const
 }
 
 libvisio::VSDPages::VSDPages()
-  : m_pages(), m_backgroundPages(), m_metaData()
+  : m_pages(), m_backgroundPages(), m_metaData(), m_pageSelection(),
+    m_streamingPainter(nullptr), m_isDocumentStarted(false), m_isStreamingEnded(false)
 {
 }
 
 void libvisio::VSDPages::addPage(const libvisio::VSDPage &page)
 {
   m_pages.push_back(page);
+  if (m_streamingPainter && !m_isStreamingEnded)
+    _streamPages();
 }
 
 void libvisio::VSDPages::addBackgroundPage(const libvisio::VSDPage &page)
 {
   m_backgroundPages[page.m_currentPageID] = page;
+  if (m_streamingPainter && !m_isStreamingEnded)
+    _streamPages();
+}
+
+// Adds the pages of another instance, which collected a part of the document
+void libvisio::VSDPages::append(const libvisio::VSDPages &pages)
+{
+  for (const auto &page : pages.m_backgroundPages)
+    addBackgroundPage(page.second);
+  for (const auto &page : pages.m_pages)
+    addPage(page);
 }
 
 void libvisio::VSDPages::setMetaData(const librevenge::RVNGPropertyList &metaData)
@@ -74,45 +90,175 @@ void libvisio::VSDPages::setMetaData(const librevenge::RVNGPropertyList &metaDat
   m_metaData = metaData;
 }
 
-void libvisio::VSDPages::draw(librevenge::RVNGDrawingInterface *painter)
+void libvisio::VSDPages::setPageSelection(const libvisio::VSDPageSelection &pageSelection)
+{
+  m_pageSelection = pageSelection;
+}
+
+/* When streaming, foreground pages are drawn as soon as they and their
+ * background pages are complete, and only the pages that are still waiting
+ * for a background page are kept. Background pages are kept until the end,
+ * where they are drawn after the foreground pages, just like draw() does.
+ * The document is ended only once; pages that come after that are dropped.
+ */
+void libvisio::VSDPages::setStreamingPainter(librevenge::RVNGDrawingInterface *painter)
+{
+  m_streamingPainter = painter;
+}
+
+void libvisio::VSDPages::endStreaming()
+{
+  if (!m_streamingPainter || m_isStreamingEnded)
+    return;
+  m_isStreamingEnded = true;
+  if (!m_isDocumentStarted && m_pages.empty() && !m_pageSelection.isActive())
+    return;
+
+  if (!m_isDocumentStarted)
+  {
+    m_streamingPainter->startDocument(librevenge::RVNGPropertyList());
+    m_streamingPainter->setDocumentMetaData(m_metaData);
+  }
+  // Whatever still waits has a background page that never came
+  for (const auto &page : m_pages)
+    _drawPage(m_streamingPainter, page);
+  m_pages.clear();
+  for (std::map<unsigned, libvisio::VSDPage>::const_iterator iter = m_backgroundPages.begin();
+       iter != m_backgroundPages.end(); ++iter)
+  {
+    if (!m_pageSelection.isPageSelected(iter->first))
+      continue;
+    _drawPage(m_streamingPainter, iter->second);
+  }
+  m_streamingPainter->endDocument();
+  m_isDocumentStarted = false;
+}
+
+// Ends a document that parsing left open, without the pages that still wait
+void libvisio::VSDPages::cancelStreaming()
+{
+  if (!m_streamingPainter || m_isStreamingEnded)
+    return;
+  m_isStreamingEnded = true;
+  m_pages.clear();
+  if (m_isDocumentStarted)
+  {
+    m_streamingPainter->endDocument();
+    m_isDocumentStarted = false;
+  }
+}
+
+void libvisio::VSDPages::_streamPages()
+{
+  std::vector<VSDPage>::iterator iter = m_pages.begin();
+  // Keep the order of the foreground pages
+  for (; iter != m_pages.end() && _isBackgroundComplete(*iter); ++iter)
+  {
+    if (!m_isDocumentStarted)
+    {
+      m_streamingPainter->startDocument(librevenge::RVNGPropertyList());
+      m_streamingPainter->setDocumentMetaData(m_metaData);
+      m_isDocumentStarted = true;
+    }
+    _drawPage(m_streamingPainter, *iter);
+  }
+  m_pages.erase(m_pages.begin(), iter);
+}
+
+bool libvisio::VSDPages::_isBackgroundComplete(const libvisio::VSDPage &page) const
+{
+  std::set<unsigned> visited;
+  unsigned backgroundPageID = page.m_backgroundPageID;
+  while (backgroundPageID != MINUS_ONE && visited.insert(backgroundPageID).second)
+  {
+    auto iter = m_backgroundPages.find(backgroundPageID);
+    if (iter == m_backgroundPages.end())
+      return false;
+    backgroundPageID = iter->second.m_backgroundPageID;
+  }
+  return true;
+}
+
+void libvisio::VSDPages::draw(librevenge::RVNGDrawingInterface *painter) const
 {
   if (!painter)
     return;
-  if (m_pages.empty())
+  if (m_pages.empty() && !m_pageSelection.isActive())
     return;
 
   painter->startDocument(librevenge::RVNGPropertyList());
   painter->setDocumentMetaData(m_metaData);
 
-  for (auto &page : m_pages)
-  {
-    librevenge::RVNGPropertyList pageProps;
-    pageProps.insert("svg:width", page.m_pageWidth);
-    pageProps.insert("svg:height", page.m_pageHeight);
-    if (page.m_pageName.len())
-      pageProps.insert("draw:name", page.m_pageName);
-    painter->startPage(pageProps);
-    _drawWithBackground(painter, page);
-    painter->endPage();
-  }
+  for (const auto &page : m_pages)
+    _drawPage(painter, page);
   // Visio shows background pages in tabs after the normal pages
   for (std::map<unsigned, libvisio::VSDPage>::const_iterator iter = m_backgroundPages.begin();
        iter != m_backgroundPages.end(); ++iter)
   {
-    librevenge::RVNGPropertyList pageProps;
-    pageProps.insert("svg:width", iter->second.m_pageWidth);
-    pageProps.insert("svg:height", iter->second.m_pageHeight);
-    if (iter->second.m_pageName.len())
-      pageProps.insert("draw:name", iter->second.m_pageName);
-    painter->startPage(pageProps);
-    _drawWithBackground(painter, iter->second);
-    painter->endPage();
+    // Background pages parsed only to be drawn below the selected pages
+    if (!m_pageSelection.isPageSelected(iter->first))
+      continue;
+    _drawPage(painter, iter->second);
   }
 
   painter->endDocument();
 }
 
-void libvisio::VSDPages::_drawWithBackground(librevenge::RVNGDrawingInterface *painter, const libvisio::VSDPage &page)
+bool libvisio::VSDPages::drawPage(librevenge::RVNGDrawingInterface *painter, unsigned index) const
+{
+  if (!painter)
+    return false;
+  const VSDPage *page = _getPage(index);
+  if (!page)
+    return false;
+
+  painter->startDocument(librevenge::RVNGPropertyList());
+  painter->setDocumentMetaData(m_metaData);
+  _drawPage(painter, *page);
+  painter->endDocument();
+  return true;
+}
+
+unsigned libvisio::VSDPages::getPageCount() const
+{
+  unsigned count = m_pages.size();
+  for (const auto &backgroundPage : m_backgroundPages)
+  {
+    if (m_pageSelection.isPageSelected(backgroundPage.first))
+      ++count;
+  }
+  return count;
+}
+
+// Pages are indexed in the order draw() outputs them
+const libvisio::VSDPage *libvisio::VSDPages::_getPage(unsigned index) const
+{
+  if (index < m_pages.size())
+    return &m_pages[index];
+  index -= m_pages.size();
+  for (const auto &backgroundPage : m_backgroundPages)
+  {
+    if (!m_pageSelection.isPageSelected(backgroundPage.first))
+      continue;
+    if (!index--)
+      return &backgroundPage.second;
+  }
+  return nullptr;
+}
+
+void libvisio::VSDPages::_drawPage(librevenge::RVNGDrawingInterface *painter, const libvisio::VSDPage &page) const
+{
+  librevenge::RVNGPropertyList pageProps;
+  pageProps.insert("svg:width", page.m_pageWidth);
+  pageProps.insert("svg:height", page.m_pageHeight);
+  if (page.m_pageName.len())
+    pageProps.insert("draw:name", page.m_pageName);
+  painter->startPage(pageProps);
+  _drawWithBackground(painter, page);
+  painter->endPage();
+}
+
+void libvisio::VSDPages::_drawWithBackground(librevenge::RVNGDrawingInterface *painter, const libvisio::VSDPage &page) const
 {
   if (!painter)
     return;
@@ -126,7 +272,6 @@ void libvisio::VSDPages::_drawWithBackground(librevenge::RVNGDrawingInterface *p
   page.draw(painter);
 }
 
-
 libvisio::VSDPages::~VSDPages()
 {
 }
@@ -11,6 +11,7 @@
 #define __VSDPAGES_H__
 
 #include "VSDOutputElementList.h"
+#include "VSDPageSelection.h"
 #include "VSDTypes.h"
 
 namespace libvisio
@@ -35,16 +36,35 @@ class VSDPages
 {
 public:
   VSDPages();
+  VSDPages(const VSDPages &pages) = default;
+  VSDPages(VSDPages &&pages) = default;
   ~VSDPages();
+  VSDPages &operator=(const VSDPages &pages) = default;
+  VSDPages &operator=(VSDPages &&pages) = default;
   void addPage(const VSDPage &page);
   void addBackgroundPage(const VSDPage &page);
-  void draw(librevenge::RVNGDrawingInterface *painter);
+  void append(const VSDPages &pages);
+  void draw(librevenge::RVNGDrawingInterface *painter) const;
+  bool drawPage(librevenge::RVNGDrawingInterface *painter, unsigned index) const;
+  unsigned getPageCount() const;
   void setMetaData(const librevenge::RVNGPropertyList &metaData);
+  void setPageSelection(const VSDPageSelection &pageSelection);
+  void setStreamingPainter(librevenge::RVNGDrawingInterface *painter);
+  void endStreaming();
+  void cancelStreaming();
 private:
-  void _drawWithBackground(librevenge::RVNGDrawingInterface *painter, const VSDPage &page);
+  void _streamPages();
+  bool _isBackgroundComplete(const VSDPage &page) const;
+  const VSDPage *_getPage(unsigned index) const;
+  void _drawPage(librevenge::RVNGDrawingInterface *painter, const VSDPage &page) const;
+  void _drawWithBackground(librevenge::RVNGDrawingInterface *painter, const VSDPage &page) const;
   std::vector<VSDPage> m_pages;
   std::map<unsigned, VSDPage> m_backgroundPages;
   librevenge::RVNGPropertyList m_metaData;
+  VSDPageSelection m_pageSelection;
+  librevenge::RVNGDrawingInterface *m_streamingPainter;
+  bool m_isDocumentStarted;
+  bool m_isStreamingEnded;
 };
 
 
@@ -11,16 +11,19 @@
 
 #include <librevenge-stream/librevenge-stream.h>
 #include <locale.h>
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <string>
 #include <cmath>
 #include <set>
 #include "libvisio_utils.h"
+#include "VSDChunkTypes.h"
 #include "VSDInternalStream.h"
 #include "VSDDocumentStructure.h"
 #include "VSDContentCollector.h"
 #include "VSDStylesCollector.h"
+#include "VSDRecordingCollector.h"
 #include "VSDMetaData.h"
 
 libvisio::VSDParser::VSDParser(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, librevenge::RVNGInputStream *container)
@@ -29,7 +32,9 @@ libvisio::VSDParser::VSDParser(librevenge::RVNGInputStream *input, librevenge::R
     m_currentShapeLevel(0), m_currentShapeID(MINUS_ONE), m_currentLayerListLevel(0), m_extractStencils(false), m_colours(),
     m_isBackgroundPage(false), m_isShapeStarted(false), m_shadowOffsetX(0.0), m_shadowOffsetY(0.0),
     m_currentGeometryList(nullptr), m_currentGeomListCount(0), m_fonts(), m_names(), m_namesMapMap(),
-    m_currentPageName(), m_currentTabSet()
+    m_currentPageName(), m_currentTabSet(), m_streamCache(), m_documentData(nullptr), m_documentLength(0),
+    m_singlePass(true), m_maxRecordSize(VSD_RECORDING_DEFAULT_SIZE), m_recorder(nullptr), m_isFirstPass(false),
+    m_pageSelection(), m_pagesOutput(nullptr), m_parseOptions()
 {}
 
 libvisio::VSDParser::~VSDParser()
@@ -48,35 +53,30 @@ void libvisio::VSDParser::_nameFromId(VSDName &name, unsigned id, unsigned level
   }
 }
 
-bool libvisio::VSDParser::getChunkHeader(librevenge::RVNGInputStream *input)
+bool libvisio::VSDParser::getChunkHeader(VSDBinaryReader &input)
 {
-  unsigned char tmpChar = 0;
-  while (!input->isEnd() && !tmpChar)
-    tmpChar = readU8(input);
-
-  if (input->isEnd())
+  input.skipZeroBytes();
+  // A lone trailing byte cannot start a chunk
+  if (input.getRemainingLength() <= 1)
+  {
+    input.seek(input.getSize());
     return false;
-  else
-    input->seek(-1, librevenge::RVNG_SEEK_CUR);
+  }
 
-  m_header.chunkType = readU32(input);
-  m_header.id = readU32(input);
-  m_header.list = readU32(input);
+  m_header.chunkType = input.readU32();
+  m_header.id = input.readU32();
+  m_header.list = input.readU32();
+  m_header.dataLength = input.readU32();
+  m_header.level = input.readU16();
+  m_header.unknown = input.readU8();
+
+  const unsigned char flags = getChunkTypeFlags(VSD11_CHUNK_TYPES, m_header.chunkType);
 
   // Certain chunk types seem to always have a trailer
   m_header.trailer = 0;
-  if (m_header.list != 0 || m_header.chunkType == 0x71 || m_header.chunkType == 0x70 ||
-      m_header.chunkType == 0x6b || m_header.chunkType == 0x6a || m_header.chunkType == 0x69 ||
-      m_header.chunkType == 0x66 || m_header.chunkType == 0x65 || m_header.chunkType == 0x2c)
+  if (m_header.list != 0 || (flags & CHUNK_TRAILER))
     m_header.trailer += 8; // 8 byte trailer
 
-  m_header.dataLength = readU32(input);
-  m_header.level = readU16(input);
-  m_header.unknown = readU8(input);
-
-  unsigned trailerChunks [14] = {0x64, 0x65, 0x66, 0x69, 0x6a, 0x6b, 0x6f, 0x71,
-                                 0x92, 0xa9, 0xb4, 0xb6, 0xb9, 0xc7
-                                };
   // Add word separator under certain circumstances for v11
   // Below are known conditions, may be more or a simpler pattern
   if (m_header.list != 0 || (m_header.level == 2 && m_header.unknown == 0x55) ||
@@ -86,21 +86,12 @@ bool libvisio::VSDParser::getChunkHeader(librevenge::RVNGInputStream *input)
     m_header.trailer += 4;
   }
 
-  for (unsigned int trailerChunk : trailerChunks)
-  {
-    if (m_header.chunkType == trailerChunk && m_header.trailer != 12 && m_header.trailer != 4)
-    {
-      m_header.trailer += 4;
-      break;
-    }
-  }
+  if ((flags & CHUNK_SEPARATOR) && m_header.trailer != 12 && m_header.trailer != 4)
+    m_header.trailer += 4;
 
   // Some chunks never have a trailer
-  if (m_header.chunkType == 0x1f || m_header.chunkType == 0xc9 ||
-      m_header.chunkType == 0x2d || m_header.chunkType == 0xd1)
-  {
+  if (flags & CHUNK_NO_TRAILER)
     m_header.trailer = 0;
-  }
   return true;
 }
 
@@ -120,36 +111,132 @@ bool libvisio::VSDParser::parseMain()
   if (compressed)
     shift = 4;
 
-  m_input->seek(trailerPointer.Offset, librevenge::RVNG_SEEK_SET);
-  VSDInternalStream trailerStream(m_input, trailerPointer.Length, compressed);
+  // Read the whole document once; uncompressed streams are parsed in place.
+  // The input is not used again until the parsing is over, so the data stay valid.
+  m_input->seek(0, librevenge::RVNG_SEEK_SET);
+  m_documentLength = getRemainingLength(m_input);
+  m_documentData = m_input->read(m_documentLength, m_documentLength);
+  if (!m_documentData)
+    m_documentLength = 0;
+
+  VSDStreamCache::Buffer_t trailerBuffer;
+  unsigned long trailerLength = 0;
+  const unsigned char *const trailerData = getStreamData(trailerPointer, trailerBuffer, trailerLength);
+  VSDInternalStream trailerStream(trailerData, trailerLength);
 
   std::vector<std::map<unsigned, XForm> > groupXFormsSequence;
   std::vector<std::map<unsigned, unsigned> > groupMembershipsSequence;
   std::vector<std::list<unsigned> > documentPageShapeOrders;
 
   VSDStylesCollector stylesCollector(groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders);
-  m_collector = &stylesCollector;
+  VSDRecordingCollector recordingCollector(&stylesCollector, m_maxRecordSize);
+  if (m_singlePass)
+  {
+    // Record the calls the content collector would get from a 2nd pass,
+    // starting with the metadata
+    m_recorder = &recordingCollector;
+    m_collector = &recordingCollector;
+    if (m_container)
+      parseMetaData();
+  }
+  else
+    m_collector = &stylesCollector;
   VSD_DEBUG_MSG(("VSDParser::parseMain 1st pass\n"));
+  m_isFirstPass = true;
   if (!parseDocument(&trailerStream, shift))
+  {
+    m_isFirstPass = false;
+    m_recorder = nullptr;
+    m_streamCache.clear();
+    m_documentData = nullptr;
+    m_documentLength = 0;
     return false;
+  }
 
+  recordingCollector.mark();
   _handleLevelChange(0);
+  recordingCollector.rewind();
+  m_recorder = nullptr;
+  m_isFirstPass = false;
 
   VSDStyles styles = stylesCollector.getStyleSheets();
   const std::optional<unsigned> varColInd = stylesCollector.getvariationColorIndex();
   const std::optional<unsigned> varStyInd = stylesCollector.getvariationStyleIndex();
 
   VSDContentCollector contentCollector(m_painter, groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders, styles, m_stencils, varColInd, varStyInd);
+  contentCollector.setPageSelection(m_pageSelection);
+  contentCollector.setPagesOutput(m_pagesOutput);
+  contentCollector.setParseOptions(m_parseOptions);
   m_collector = &contentCollector;
-  if (m_container)
-    parseMetaData();
 
-  VSD_DEBUG_MSG(("VSDParser::parseMain 2nd pass\n"));
-  if (!parseDocument(&trailerStream, shift))
-    return false;
+  bool result = false;
+  if (m_singlePass && !recordingCollector.isDiscarded())
+  {
+    VSD_DEBUG_MSG(("VSDParser::parseMain replaying 1st pass\n"));
+    const auto createCollector = [&]()
+    {
+      std::unique_ptr<VSDContentCollector> collector(
+        new VSDContentCollector(nullptr, groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders, styles, m_stencils, varColInd, varStyInd));
+      collector->setParseOptions(m_parseOptions);
+      return collector;
+    };
+    result = replay(recordingCollector, contentCollector, createCollector);
+  }
+  else
+  {
+    if (m_container)
+      parseMetaData();
 
+    VSD_DEBUG_MSG(("VSDParser::parseMain 2nd pass\n"));
+    result = parseDocument(&trailerStream, shift);
+  }
+  m_streamCache.clear();
+  m_documentData = nullptr;
+  m_documentLength = 0;
+  return result;
+}
+
+void libvisio::VSDParser::setStreamCacheSize(unsigned long maxSize)
+{
+  m_streamCache.setMaxSize(maxSize);
+}
+
+void libvisio::VSDParser::setSinglePass(bool singlePass)
+{
+  m_singlePass = singlePass;
+}
+
+// Recording more than this falls back to a 2nd pass
+void libvisio::VSDParser::setMaxRecordSize(unsigned long maxSize)
+{
+  m_maxRecordSize = maxSize;
+}
+
+void libvisio::VSDParser::setPageSelection(const VSDPageSelection &pageSelection)
+{
+  m_pageSelection = pageSelection;
+}
+
+void libvisio::VSDParser::setPagesOutput(VSDPages *pages)
+{
+  m_pagesOutput = pages;
+}
+
+void libvisio::VSDParser::setParseOptions(const VisioParseOptions &options)
+{
+  m_parseOptions = options;
+}
+
+bool libvisio::VSDParser::replay(const VSDRecordingCollector &recordingCollector, VSDContentCollector &contentCollector,
+                                 const std::function<std::unique_ptr<VSDContentCollector> ()> &createCollector) try
+{
+  recordingCollector.replay(&contentCollector, createCollector, m_parseOptions.getThreadCount());
   return true;
 }
+catch (...)
+{
+  return false;
+}
 
 void libvisio::VSDParser::parseMetaData() try
 {
@@ -263,6 +350,9 @@ void libvisio::VSDParser::handleStreams(librevenge::RVNGInputStream *input, unsi
     NameList.clear();
   }
 
+  if (ptrType == VSD_PAGES && m_pageSelection.isActive())
+    selectPages(PtrList, pointerOrder);
+
   std::map<unsigned, libvisio::Pointer>::iterator iter;
   for (iter = NameList.begin(); iter != NameList.end(); ++iter)
     handleStream(iter->second, iter->first, level+1, visited);
@@ -299,9 +389,12 @@ void libvisio::VSDParser::handleStream(const Pointer &ptr, unsigned idx, unsigne
   _handleLevelChange(level);
   VSDStencil tmpStencil;
   bool compressed = ((ptr.Format & 2) == 2);
-  m_input->seek(ptr.Offset, librevenge::RVNG_SEEK_SET);
-  VSDInternalStream tmpInput(m_input, ptr.Length, compressed);
-  m_header.dataLength = tmpInput.getSize();
+  VSDStreamCache::Buffer_t buffer;
+  unsigned long length = 0;
+  const unsigned char *const data = getStreamData(ptr, buffer, length);
+  VSDInternalStream tmpInput(data, length);
+  VSDBinaryReader reader(data, length);
+  m_header.dataLength = length;
   unsigned shift = compressed ? 4 : 0;
   switch (ptr.Type)
   {
@@ -328,6 +421,8 @@ void libvisio::VSDParser::handleStream(const Pointer &ptr, unsigned idx, unsigne
     if (m_stencils.count())
       return;
     m_isStencilStarted = true;
+    if (m_recorder)
+      m_recorder->mark();
     break;
   case VSD_STENCIL_PAGE:
     if (m_extractStencils)
@@ -355,7 +450,7 @@ void libvisio::VSDParser::handleStream(const Pointer &ptr, unsigned idx, unsigne
 
   if ((ptr.Format >> 4) == 0x4 || (ptr.Format >> 4) == 0x5 || (ptr.Format >> 4) == 0x0)
   {
-    handleBlob(&tmpInput, shift, level+1);
+    handleBlob(reader, shift, level+1);
     if ((ptr.Format >> 4) == 0x5 && ptr.Type != VSD_COLORS)
     {
       const auto it = visited.insert(ptr.Offset);
@@ -375,7 +470,7 @@ void libvisio::VSDParser::handleStream(const Pointer &ptr, unsigned idx, unsigne
     }
   }
   else if ((ptr.Format >> 4) == 0xd || (ptr.Format >> 4) == 0xc || (ptr.Format >> 4) == 0x8)
-    handleChunks(&tmpInput, level+1);
+    handleChunks(reader, level+1);
 
   switch (ptr.Type)
   {
@@ -396,7 +491,18 @@ void libvisio::VSDParser::handleStream(const Pointer &ptr, unsigned idx, unsigne
     if (m_extractStencils)
       m_collector->endPages();
     else
+    {
       m_isStencilStarted = false;
+      // A 2nd pass skips the stencils if there are any, and reads the pages
+      // that precede them with the stencils known.
+      if (m_recorder && m_stencils.count())
+      {
+        if (m_recorder->getPageCount())
+          m_recorder->discard();
+        else
+          m_recorder->rewind();
+      }
+    }
     break;
   case VSD_STENCIL_PAGE:
     _handleLevelChange(0);
@@ -424,42 +530,138 @@ void libvisio::VSDParser::handleStream(const Pointer &ptr, unsigned idx, unsigne
 
 }
 
-void libvisio::VSDParser::handleBlob(librevenge::RVNGInputStream *input, unsigned shift, unsigned level)
+// The data of the stream; buffer keeps decompressed data
+const unsigned char *libvisio::VSDParser::getStreamData(const Pointer &ptr, VSDStreamCache::Buffer_t &buffer, unsigned long &length)
+{
+  buffer.reset();
+  length = 0;
+  if (!m_documentData)
+    return nullptr;
+
+  bool compressed = ((ptr.Format & 2) == 2);
+  if (!compressed)
+  {
+    // Uncompressed streams are views of the document. Like reading them
+    // from the input stream, less than 2 available bytes is an empty stream.
+    if (ptr.Offset >= m_documentLength)
+      return nullptr;
+    length = std::min<unsigned long>(ptr.Length, m_documentLength - ptr.Offset);
+    if (length < 2)
+      length = 0;
+    return m_documentData + ptr.Offset;
+  }
+
+  buffer = m_streamCache.find(ptr.Offset, ptr.Length, ptr.Format);
+  if (!buffer)
+  {
+    VSDInternalStream compressedInput(m_documentData + std::min<unsigned long>(ptr.Offset, m_documentLength),
+                                      ptr.Offset < m_documentLength ? m_documentLength - ptr.Offset : 0);
+    VSDInternalStream tmpInput(&compressedInput, ptr.Length, compressed);
+    buffer = tmpInput.getBuffer();
+    // If the stream does not fit into the cache any more, it will be
+    // decompressed again when the next pass reaches it. There is no next
+    // pass as long as the 1st one is being recorded.
+    if (!m_recorder || m_recorder->isDiscarded())
+      m_streamCache.insert(ptr.Offset, ptr.Length, ptr.Format, buffer);
+  }
+  length = buffer->size();
+  return buffer->data();
+}
+
+void libvisio::VSDParser::selectPages(std::map<unsigned, Pointer> &pointers, const std::vector<unsigned> &pointerOrder)
+{
+  if (!m_pageSelection.isResolved())
+  {
+    // Pages are numbered in the order handleStreams reads them
+    std::vector<unsigned> order;
+    std::set<unsigned> ordered;
+    for (unsigned j : pointerOrder)
+    {
+      if (pointers.find(j) != pointers.end() && ordered.insert(j).second)
+        order.push_back(j);
+    }
+    for (const auto &pointer : pointers)
+    {
+      if (ordered.insert(pointer.first).second)
+        order.push_back(pointer.first);
+    }
+    for (unsigned idx : order)
+    {
+      const Pointer &ptr = pointers[idx];
+      if (ptr.Type == VSD_PAGE)
+        m_pageSelection.addPage(idx, !(ptr.Format&0x1), getBackgroundPageID(ptr));
+    }
+    m_pageSelection.resolve();
+  }
+
+  for (auto iter = pointers.begin(); iter != pointers.end();)
+  {
+    if (iter->second.Type == VSD_PAGE && !m_pageSelection.isPageNeeded(iter->first))
+      iter = pointers.erase(iter);
+    else
+      ++iter;
+  }
+}
+
+unsigned libvisio::VSDParser::getBackgroundPageID(const Pointer &ptr)
+{
+  VSDStreamCache::Buffer_t buffer;
+  unsigned long length = 0;
+  const unsigned char *const data = getStreamData(ptr, buffer, length);
+  VSDBinaryReader input(data, length);
+  input.seek((ptr.Format & 2) == 2 ? 4 : 0);
+  const unsigned backgroundPageID = readBackgroundPageID(input);
+  return input.isGood() ? backgroundPageID : MINUS_ONE;
+}
+
+void libvisio::VSDParser::handleBlob(VSDBinaryReader &input, unsigned shift, unsigned level)
 {
   try
   {
     m_header.level = level;
-    input->seek(shift, librevenge::RVNG_SEEK_SET);
+    input.seek(shift);
     m_header.dataLength -= shift;
     _handleLevelChange(m_header.level);
     handleChunk(input);
   }
+  // A short chunk is not an error here, but the collectors can still throw
   catch (EndOfStreamException &)
   {
     VSD_DEBUG_MSG(("VSDParser::handleBlob - catching EndOfStreamException\n"));
   }
 }
 
-void libvisio::VSDParser::handleChunks(librevenge::RVNGInputStream *input, unsigned level)
+void libvisio::VSDParser::handleChunks(VSDBinaryReader &input, unsigned level)
 {
   long endPos = 0;
 
-  while (!input->isEnd())
+  while (!input.isEnd())
   {
     if (!getChunkHeader(input))
       return;
+    // A truncated chunk ends the document
+    if (!input.isGood())
+      throw EndOfStreamException();
     m_header.level += level;
-    endPos = m_header.dataLength+m_header.trailer+input->tell();
+    endPos = m_header.dataLength+m_header.trailer+input.tell();
 
     _handleLevelChange(m_header.level);
     VSD_DEBUG_MSG(("VSDParser::handleChunks - parsing chunk type 0x%x\n", m_header.chunkType));
     handleChunk(input);
-    input->seek(endPos, librevenge::RVNG_SEEK_SET);
+    if (!input.isGood())
+      throw EndOfStreamException();
+    input.seek(endPos);
   }
 }
 
-void libvisio::VSDParser::handleChunk(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::handleChunk(VSDBinaryReader &input)
 {
+  if (_isSkeletonScan() && _isContentChunk())
+  {
+    m_collector->collectUnhandledChunk(m_header.id, m_header.level);
+    return;
+  }
+
   switch (m_header.chunkType)
   {
   case VSD_SHAPE_GROUP:
@@ -634,6 +836,50 @@ void libvisio::VSDParser::handleChunk(librevenge::RVNGInputStream *input)
   }
 }
 
+bool libvisio::VSDParser::_isSkeletonScan() const
+{
+  // Only a 1st pass that is not recorded for replay can skip the shape content,
+  // as the 2nd pass reads it again. Stencils are not read in the 2nd pass.
+  return m_isFirstPass && !m_isStencilStarted && (!m_recorder || m_recorder->isDiscarded());
+}
+
+bool libvisio::VSDParser::_isContentChunk() const
+{
+  switch (m_header.chunkType)
+  {
+  case VSD_GEOM_LIST:
+  case VSD_GEOMETRY:
+  case VSD_MOVE_TO:
+  case VSD_LINE_TO:
+  case VSD_ARC_TO:
+  case VSD_ELLIPSE:
+  case VSD_ELLIPTICAL_ARC_TO:
+  case VSD_NURBS_TO:
+  case VSD_POLYLINE_TO:
+  case VSD_INFINITE_LINE:
+  case VSD_SHAPE_DATA:
+  case VSD_SPLINE_START:
+  case VSD_SPLINE_KNOT:
+  case VSD_FOREIGN_DATA:
+  case VSD_OLE_DATA:
+  case VSD_TEXT:
+  case VSD_FIELD_LIST:
+  case VSD_TEXT_FIELD:
+    return true;
+  case VSD_CHAR_LIST:
+  case VSD_PARA_LIST:
+  case VSD_CHAR_IX:
+  case VSD_PARA_IX:
+  case VSD_TABS_DATA_LIST:
+  case VSD_TABS_DATA_1:
+  case VSD_TABS_DATA_2:
+  case VSD_TABS_DATA_3:
+    return !m_isInStyles;
+  default:
+    return false;
+  }
+}
+
 void libvisio::VSDParser::_flushShape()
 {
   if (!m_isShapeStarted)
@@ -744,30 +990,32 @@ void libvisio::VSDParser::_handleLevelChange(unsigned level)
 
 // --- READERS ---
 
-void libvisio::VSDParser::readEllipticalArcTo(librevenge::RVNGInputStream *input)
-{
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x3 = readDouble(input); // End x
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y3 = readDouble(input); // End y
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x2 = readDouble(input); // Mid x
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y2 = readDouble(input); // Mid y
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double angle = readDouble(input); // Angle
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double ecc = readDouble(input); // Eccentricity
-
+void libvisio::VSDParser::readEllipticalArcTo(VSDBinaryReader &input)
+{
+  input.skip(1);
+  double x3 = input.readDouble(); // End x
+  input.skip(1);
+  double y3 = input.readDouble(); // End y
+  input.skip(1);
+  double x2 = input.readDouble(); // Mid x
+  input.skip(1);
+  double y2 = input.readDouble(); // Mid y
+  input.skip(1);
+  double angle = input.readDouble(); // Angle
+  input.skip(1);
+  double ecc = input.readDouble(); // Eccentricity
+
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addEllipticalArcTo(m_header.id, m_header.level, x3, y3, x2, y2, angle, ecc);
 }
 
 
-void libvisio::VSDParser::readForeignData(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readForeignData(VSDBinaryReader &input)
 {
   unsigned long tmpBytesRead = 0;
-  const unsigned char *buffer = input->read(m_header.dataLength, tmpBytesRead);
+  const unsigned char *buffer = input.read(m_header.dataLength, tmpBytesRead);
   if (m_header.dataLength != tmpBytesRead)
     return;
   librevenge::RVNGBinaryData binaryData(buffer, tmpBytesRead);
@@ -778,14 +1026,14 @@ void libvisio::VSDParser::readForeignData(librevenge::RVNGInputStream *input)
   m_shape.m_foreign->data = binaryData;
 }
 
-void libvisio::VSDParser::readOLEList(librevenge::RVNGInputStream * /* input */)
+void libvisio::VSDParser::readOLEList(VSDBinaryReader & /* input */)
 {
 }
 
-void libvisio::VSDParser::readOLEData(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readOLEData(VSDBinaryReader &input)
 {
   unsigned long tmpBytesRead = 0;
-  const unsigned char *buffer = input->read(m_header.dataLength, tmpBytesRead);
+  const unsigned char *buffer = input.read(m_header.dataLength, tmpBytesRead);
   if (m_header.dataLength != tmpBytesRead)
     return;
   librevenge::RVNGBinaryData oleData(buffer, tmpBytesRead);
@@ -797,47 +1045,57 @@ void libvisio::VSDParser::readOLEData(librevenge::RVNGInputStream *input)
 
 }
 
-void libvisio::VSDParser::readTabsData(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readTabsData(VSDBinaryReader &input)
 {
-  m_shape.m_tabSets[m_header.id].m_numChars = getUInt(input);
-  unsigned char numStops = readU8(input);
+  unsigned numChars = getUInt(input);
+  unsigned char numStops = input.readU8();
+  if (!input.isGood())
+    return;
+  m_shape.m_tabSets[m_header.id].m_numChars = numChars;
   m_shape.m_tabSets[m_header.id].m_tabStops.clear();
   for (unsigned char i = 0; i < numStops; ++i)
   {
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
-    m_shape.m_tabSets[m_header.id].m_tabStops[i].m_position = readDouble(input);
-    m_shape.m_tabSets[m_header.id].m_tabStops[i].m_alignment = readU8(input);
-    m_shape.m_tabSets[m_header.id].m_tabStops[i].m_leader = readU8(input);
+    input.skip(1);
+    double position = input.readDouble();
+    unsigned char alignment = input.readU8();
+    unsigned char leader = input.readU8();
+    if (!input.isGood())
+      return;
+    m_shape.m_tabSets[m_header.id].m_tabStops[i].m_position = position;
+    m_shape.m_tabSets[m_header.id].m_tabStops[i].m_alignment = alignment;
+    m_shape.m_tabSets[m_header.id].m_tabStops[i].m_leader = leader;
   }
 }
 
-void libvisio::VSDParser::readNameIDX(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readNameIDX(VSDBinaryReader &input)
 {
   std::map<unsigned, VSDName> names;
-  unsigned recordCount = readU32(input);
-  if (recordCount > getRemainingLength(input) / 13)
-    recordCount = getRemainingLength(input) / 13;
+  unsigned recordCount = input.readU32();
+  if (recordCount > input.getRemainingLength() / 13)
+    recordCount = input.getRemainingLength() / 13;
   for (unsigned i = 0; i < recordCount; ++i)
   {
-    unsigned nameId = readU32(input);
-    if (nameId != readU32(input))
+    unsigned nameId = input.readU32();
+    if (nameId != input.readU32())
     {
       VSD_DEBUG_MSG(("VSDParser::readNameIDX --> mismatch of first two dwords\n"));
     }
-    unsigned elementId = readU32(input);
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
+    unsigned elementId = input.readU32();
+    input.skip(1);
     std::map<unsigned, VSDName>::const_iterator iter = m_names.find(nameId);
     if (iter != m_names.end())
       names[elementId] = iter->second;
   }
+  if (!input.isGood())
+    return;
   m_namesMapMap[m_header.level] = names;
 }
 
-void libvisio::VSDParser::readNameIDX123(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readNameIDX123(VSDBinaryReader &input)
 {
   std::map<unsigned, VSDName> names;
-  long endPosition = input->tell() + m_header.dataLength;
-  while (!input->isEnd() && input->tell() < endPosition)
+  unsigned long endPosition = input.tell() + m_header.dataLength;
+  while (!input.isEnd() && input.tell() < endPosition)
   {
     unsigned nameId = getUInt(input);
     unsigned elementId = getUInt(input);
@@ -845,80 +1103,87 @@ void libvisio::VSDParser::readNameIDX123(librevenge::RVNGInputStream *input)
     if (iter != m_names.end())
       names[elementId] = iter->second;
   }
+  if (!input.isGood())
+    return;
   m_namesMapMap[m_header.level] = names;
-
 }
 
-void libvisio::VSDParser::readEllipse(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readEllipse(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double cx = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double cy = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double xleft = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double yleft = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double xtop = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double ytop = readDouble(input);
+  input.skip(1);
+  double cx = input.readDouble();
+  input.skip(1);
+  double cy = input.readDouble();
+  input.skip(1);
+  double xleft = input.readDouble();
+  input.skip(1);
+  double yleft = input.readDouble();
+  input.skip(1);
+  double xtop = input.readDouble();
+  input.skip(1);
+  double ytop = input.readDouble();
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addEllipse(m_header.id, m_header.level, cx, cy, xleft, yleft, xtop, ytop);
 }
 
-void libvisio::VSDParser::readLine(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readLine(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double strokeWidth = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
+  input.skip(1);
+  double strokeWidth = input.readDouble();
+  input.skip(1);
   Colour c;
-  c.r = readU8(input);
-  c.g = readU8(input);
-  c.b = readU8(input);
-  c.a = readU8(input);
-  unsigned char linePattern = readU8(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double rounding = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  unsigned char startMarker = readU8(input);
-  unsigned char endMarker = readU8(input);
-  unsigned char lineCap = readU8(input);
-
+  c.r = input.readU8();
+  c.g = input.readU8();
+  c.b = input.readU8();
+  c.a = input.readU8();
+  unsigned char linePattern = input.readU8();
+  input.skip(1);
+  double rounding = input.readDouble();
+  input.skip(1);
+  unsigned char startMarker = input.readU8();
+  unsigned char endMarker = input.readU8();
+  unsigned char lineCap = input.readU8();
+
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectLineStyle(m_header.level, strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, -1, -1);
   else
     m_shape.m_lineStyle.override(VSDOptionalLineStyle(strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, -1, -1));
 }
 
-void libvisio::VSDParser::readTextBlock(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readTextBlock(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double leftMargin = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double rightMargin = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double topMargin = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double bottomMargin = readDouble(input);
-  unsigned char verticalAlign = readU8(input);
-  const unsigned char bgColourIdx = readU8(input);
+  input.skip(1);
+  double leftMargin = input.readDouble();
+  input.skip(1);
+  double rightMargin = input.readDouble();
+  input.skip(1);
+  double topMargin = input.readDouble();
+  input.skip(1);
+  double bottomMargin = input.readDouble();
+  unsigned char verticalAlign = input.readU8();
+  const unsigned char bgColourIdx = input.readU8();
   // The TextBkgnd cell can have any value from 0 through 24, or 255.
   // The values 0 and 255 (visTxtBlklOpaque) both indicate a transparent text background.
   const bool isBgFilled = bgColourIdx != 0 && bgColourIdx != 0xff;
   Colour c;
-  c.r = readU8(input);
-  c.g = readU8(input);
-  c.b = readU8(input);
-  c.a = readU8(input);
+  c.r = input.readU8();
+  c.g = input.readU8();
+  c.b = input.readU8();
+  c.a = input.readU8();
   if (isBgFilled)
     c = _colourFromIndex(bgColourIdx - 1);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double defaultTabStop = readDouble(input);
-  input->seek(12, librevenge::RVNG_SEEK_CUR);
-  unsigned char textDirection = readU8(input);
+  input.skip(1);
+  double defaultTabStop = input.readDouble();
+  input.skip(12);
+  unsigned char textDirection = input.readU8();
 
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectTextBlockStyle(m_header.level, leftMargin, rightMargin, topMargin, bottomMargin,
                                        verticalAlign, isBgFilled, c, defaultTabStop, textDirection);
@@ -927,7 +1192,7 @@ void libvisio::VSDParser::readTextBlock(librevenge::RVNGInputStream *input)
                                                                 verticalAlign, isBgFilled, c, defaultTabStop, textDirection));
 }
 
-void libvisio::VSDParser::readGeomList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readGeomList(VSDBinaryReader &input)
 {
   if (!m_shape.m_geometries.empty() && m_currentGeometryList && m_currentGeometryList->empty())
     m_shape.m_geometries.erase(--m_currentGeomListCount);
@@ -938,16 +1203,18 @@ void libvisio::VSDParser::readGeomList(librevenge::RVNGInputStream *input)
 
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
     std::vector<unsigned> geometryOrder;
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     geometryOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      geometryOrder.push_back(readU32(input));
+      geometryOrder.push_back(input.readU32());
 
+    if (!input.isGood())
+      return;
     if (m_currentGeometryList)
       m_currentGeometryList->setElementsOrder(geometryOrder);
   }
@@ -957,7 +1224,7 @@ void libvisio::VSDParser::readGeomList(librevenge::RVNGInputStream *input)
     m_collector->collectUnhandledChunk(m_header.id, m_header.level);
 }
 
-void libvisio::VSDParser::readCharList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readCharList(VSDBinaryReader &input)
 {
   // We want the collectors to still get the level information
   if (!m_isStencilStarted)
@@ -965,21 +1232,23 @@ void libvisio::VSDParser::readCharList(librevenge::RVNGInputStream *input)
 
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     std::vector<unsigned> characterOrder;
     characterOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      characterOrder.push_back(readU32(input));
+      characterOrder.push_back(input.readU32());
 
+    if (!input.isGood())
+      return;
     m_shape.m_charList.setElementsOrder(characterOrder);
   }
 }
 
-void libvisio::VSDParser::readParaList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readParaList(VSDBinaryReader &input)
 {
   // We want the collectors to still get the level information
   if (!m_isStencilStarted)
@@ -987,25 +1256,27 @@ void libvisio::VSDParser::readParaList(librevenge::RVNGInputStream *input)
 
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     std::vector<unsigned> paragraphOrder;
     paragraphOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      paragraphOrder.push_back(readU32(input));
+      paragraphOrder.push_back(input.readU32());
 
+    if (!input.isGood())
+      return;
     m_shape.m_paraList.setElementsOrder(paragraphOrder);
   }
 }
 
-void libvisio::VSDParser::readPropList(librevenge::RVNGInputStream * /* input */)
+void libvisio::VSDParser::readPropList(VSDBinaryReader & /* input */)
 {
 }
 
-void libvisio::VSDParser::readTabsDataList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readTabsDataList(VSDBinaryReader &input)
 {
   // We want the collectors to still get the level information
   if (!m_isStencilStarted)
@@ -1013,19 +1284,19 @@ void libvisio::VSDParser::readTabsDataList(librevenge::RVNGInputStream *input)
 
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     std::vector<unsigned> tabsOrder;
     tabsOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      tabsOrder.push_back(readU32(input));
+      tabsOrder.push_back(input.readU32());
   }
 }
 
-void libvisio::VSDParser::readLayerList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readLayerList(VSDBinaryReader &input)
 {
   // We want the collectors to still get the level information
   if (!m_isStencilStarted)
@@ -1033,49 +1304,51 @@ void libvisio::VSDParser::readLayerList(librevenge::RVNGInputStream *input)
 
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     std::vector<unsigned> layerOrder;
     layerOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      layerOrder.push_back(readU32(input));
+      layerOrder.push_back(input.readU32());
   }
 }
 
-void libvisio::VSDParser::readLayer(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readLayer(VSDBinaryReader &input)
 {
   libvisio::VSDLayer layer;
-  input->seek(8, librevenge::RVNG_SEEK_CUR);
-  unsigned char colourId = readU8(input);
+  input.skip(8);
+  unsigned char colourId = input.readU8();
   if (colourId == 0xff)
-    input->seek(4, librevenge::RVNG_SEEK_CUR);
+    input.skip(4);
   else
   {
     libvisio::Colour colour;
-    colour.r = readU8(input);
-    colour.g = readU8(input);
-    colour.b = readU8(input);
-    colour.a = readU8(input);
+    colour.r = input.readU8();
+    colour.g = input.readU8();
+    colour.b = input.readU8();
+    colour.a = input.readU8();
     layer.m_colour = colour;
   }
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  layer.m_visible = !!readU8(input);
-  layer.m_printable = !!readU8(input);
+  input.skip(1);
+  layer.m_visible = !!input.readU8();
+  layer.m_printable = !!input.readU8();
 
+  if (!input.isGood())
+    return;
   m_collector->collectLayer(m_header.id, m_header.level, layer);
 }
 
-void libvisio::VSDParser::readLayerMem(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readLayerMem(VSDBinaryReader &input)
 {
-  input->seek(13, librevenge::RVNG_SEEK_CUR);
-  unsigned textLength = readU8(input);
+  input.skip(13);
+  unsigned textLength = input.readU8();
 
   librevenge::RVNGBinaryData  textStream;
   unsigned long numBytesRead = 0;
-  const unsigned char *tmpBuffer = input->read(textLength*2, numBytesRead);
+  const unsigned char *tmpBuffer = input.read(textLength*2, numBytesRead);
   if (numBytesRead)
   {
     textStream.append(tmpBuffer, numBytesRead);
@@ -1085,137 +1358,173 @@ void libvisio::VSDParser::readLayerMem(librevenge::RVNGInputStream *input)
 
 }
 
-void libvisio::VSDParser::readPage(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readPage(VSDBinaryReader &input)
 {
-  input->seek(8, librevenge::RVNG_SEEK_CUR); //sub header length and children list length
-  unsigned backgroundPageID = readU32(input);
+  unsigned backgroundPageID = readBackgroundPageID(input);
+  if (!input.isGood())
+    return;
   m_collector->collectPage(m_header.id, m_header.level, backgroundPageID, m_isBackgroundPage, m_currentPageName);
 }
 
-void libvisio::VSDParser::readGeometry(librevenge::RVNGInputStream *input)
+unsigned libvisio::VSDParser::readBackgroundPageID(VSDBinaryReader &input)
+{
+  input.skip(8); //sub header length and children list length
+  return input.readU32();
+}
+
+void libvisio::VSDParser::readGeometry(VSDBinaryReader &input)
 {
-  unsigned char geomFlags = readU8(input);
+  unsigned char geomFlags = input.readU8();
   bool noFill = (!!(geomFlags & 1));
   bool noLine = (!!(geomFlags & 2));
   bool noShow = (!!(geomFlags & 4));
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addGeometry(m_header.id, m_header.level, noFill, noLine, noShow);
 }
 
-void libvisio::VSDParser::readMoveTo(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readMoveTo(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y = readDouble(input);
+  input.skip(1);
+  double x = input.readDouble();
+  input.skip(1);
+  double y = input.readDouble();
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addMoveTo(m_header.id, m_header.level, x, y);
 }
 
-void libvisio::VSDParser::readLineTo(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readLineTo(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y = readDouble(input);
+  input.skip(1);
+  double x = input.readDouble();
+  input.skip(1);
+  double y = input.readDouble();
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addLineTo(m_header.id, m_header.level, x, y);
 }
 
-void libvisio::VSDParser::readArcTo(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readArcTo(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x2 = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y2 = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double bow = readDouble(input);
+  input.skip(1);
+  double x2 = input.readDouble();
+  input.skip(1);
+  double y2 = input.readDouble();
+  input.skip(1);
+  double bow = input.readDouble();
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addArcTo(m_header.id, m_header.level, x2, y2, bow);
 }
 
-void libvisio::VSDParser::readXFormData(librevenge::RVNGInputStream *input)
-{
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.pinX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.pinY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.width = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.height = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.pinLocX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.pinLocY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform.angle = readDouble(input);
-  m_shape.m_xform.flipX = !!readU8(input);
-  m_shape.m_xform.flipY = !!readU8(input);
+void libvisio::VSDParser::readXFormData(VSDBinaryReader &input)
+{
+  XForm xform(m_shape.m_xform);
+  input.skip(1);
+  xform.pinX = input.readDouble();
+  input.skip(1);
+  xform.pinY = input.readDouble();
+  input.skip(1);
+  xform.width = input.readDouble();
+  input.skip(1);
+  xform.height = input.readDouble();
+  input.skip(1);
+  xform.pinLocX = input.readDouble();
+  input.skip(1);
+  xform.pinLocY = input.readDouble();
+  input.skip(1);
+  xform.angle = input.readDouble();
+  xform.flipX = !!input.readU8();
+  xform.flipY = !!input.readU8();
+
+  if (!input.isGood())
+    return;
+  m_shape.m_xform = xform;
 }
 
-void libvisio::VSDParser::readXForm1D(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readXForm1D(VSDBinaryReader &input)
 {
+  input.skip(1);
+  double beginX = input.readDouble();
+  input.skip(1);
+  double beginY = input.readDouble();
+  input.skip(1);
+  double endX = input.readDouble();
+  input.skip(1);
+  double endY = input.readDouble();
+
+  if (!input.isGood())
+    return;
   if (!m_shape.m_xform1d)
     m_shape.m_xform1d = std::make_unique<XForm1D>();
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->beginX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->beginY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->endX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_xform1d->endY = readDouble(input);
-}
-
-void libvisio::VSDParser::readTxtXForm(librevenge::RVNGInputStream *input)
-{
-  m_shape.m_txtxform = std::make_unique<XForm>();
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->pinX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->pinY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->width = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->height = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->pinLocX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->pinLocY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shape.m_txtxform->angle = readDouble(input);
-}
-
-void libvisio::VSDParser::readShapeId(librevenge::RVNGInputStream *input)
+  m_shape.m_xform1d->beginX = beginX;
+  m_shape.m_xform1d->beginY = beginY;
+  m_shape.m_xform1d->endX = endX;
+  m_shape.m_xform1d->endY = endY;
+}
+
+void libvisio::VSDParser::readTxtXForm(VSDBinaryReader &input)
+{
+  auto txtxform = std::make_unique<XForm>();
+  input.skip(1);
+  txtxform->pinX = input.readDouble();
+  input.skip(1);
+  txtxform->pinY = input.readDouble();
+  input.skip(1);
+  txtxform->width = input.readDouble();
+  input.skip(1);
+  txtxform->height = input.readDouble();
+  input.skip(1);
+  txtxform->pinLocX = input.readDouble();
+  input.skip(1);
+  txtxform->pinLocY = input.readDouble();
+  input.skip(1);
+  txtxform->angle = input.readDouble();
+
+  if (!input.isGood())
+    return;
+  m_shape.m_txtxform = std::move(txtxform);
+}
+
+void libvisio::VSDParser::readShapeId(VSDBinaryReader &input)
 {
+  unsigned shapeId = getUInt(input);
+  if (!input.isGood())
+    return;
   if (!m_isShapeStarted)
-    m_shapeList.addShapeId(m_header.id, getUInt(input));
+    m_shapeList.addShapeId(m_header.id, shapeId);
   else
-    m_shape.m_shapeList.addShapeId(m_header.id, getUInt(input));
+    m_shape.m_shapeList.addShapeId(m_header.id, shapeId);
 }
 
-void libvisio::VSDParser::readShapeList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readShapeList(VSDBinaryReader &input)
 {
   // We want the collectors to still get the level information
   m_collector->collectUnhandledChunk(m_header.id, m_header.level);
 
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     std::vector<unsigned> shapeOrder;
     shapeOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      shapeOrder.push_back(readU32(input));
+      shapeOrder.push_back(input.readU32());
 
+    if (!input.isGood())
+      return;
     if (!m_isShapeStarted)
       m_shapeList.setElementsOrder(shapeOrder);
     else
@@ -1223,23 +1532,25 @@ void libvisio::VSDParser::readShapeList(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readForeignDataType(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readForeignDataType(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double imgOffsetX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double imgOffsetY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double imgWidth = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double imgHeight = readDouble(input);
-  unsigned foreignType = readU16(input);
-  unsigned foreignMapMode = readU16(input);
+  input.skip(1);
+  double imgOffsetX = input.readDouble();
+  input.skip(1);
+  double imgOffsetY = input.readDouble();
+  input.skip(1);
+  double imgWidth = input.readDouble();
+  input.skip(1);
+  double imgHeight = input.readDouble();
+  unsigned foreignType = input.readU16();
+  unsigned foreignMapMode = input.readU16();
   if (foreignMapMode == 0x8)
     foreignType = 0x4;
-  input->seek(0x9, librevenge::RVNG_SEEK_CUR);
-  unsigned foreignFormat = readU32(input);
+  input.skip(0x9);
+  unsigned foreignFormat = input.readU32();
 
+  if (!input.isGood())
+    return;
   if (!m_shape.m_foreign)
     m_shape.m_foreign = std::make_unique<ForeignData>();
   m_shape.m_foreign->typeId = m_header.id;
@@ -1251,22 +1562,26 @@ void libvisio::VSDParser::readForeignDataType(librevenge::RVNGInputStream *input
   m_shape.m_foreign->height = imgHeight;
 }
 
-void libvisio::VSDParser::readPageProps(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readPageProps(VSDBinaryReader &input)
 {
   // Skip bytes representing unit to *display* (value is always inches)
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  const double pageWidth = std::max<double>(readDouble(input), 0);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  const double pageHeight = std::max<double>(readDouble(input), 0);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shadowOffsetX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  m_shadowOffsetY = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  const double pageScale = readDouble(input);
-
-  const unsigned char drawingScaleUnit = readU8(input);
-  double drawingScale = readDouble(input);
+  input.skip(1);
+  const double pageWidth = std::max<double>(input.readDouble(), 0);
+  input.skip(1);
+  const double pageHeight = std::max<double>(input.readDouble(), 0);
+  input.skip(1);
+  const double shadowOffsetX = input.readDouble();
+  input.skip(1);
+  const double shadowOffsetY = input.readDouble();
+  input.skip(1);
+  const double pageScale = input.readDouble();
+
+  const unsigned char drawingScaleUnit = input.readU8();
+  double drawingScale = input.readDouble();
+  if (!input.isGood())
+    return;
+  m_shadowOffsetX = shadowOffsetX;
+  m_shadowOffsetY = shadowOffsetY;
   if (VSD_ALMOST_ZERO(drawingScale))
     drawingScale = 1;
 
@@ -1280,7 +1595,7 @@ void libvisio::VSDParser::readPageProps(librevenge::RVNGInputStream *input)
   m_collector->collectPageProps(m_header.id, m_header.level, pageWidth, pageHeight, m_shadowOffsetX, m_shadowOffsetY, scale, drawingScaleUnit, 0, 0);
 }
 
-void libvisio::VSDParser::readShape(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readShape(VSDBinaryReader &input)
 {
   m_currentGeomListCount = 0;
   m_isShapeStarted = true;
@@ -1295,24 +1610,25 @@ void libvisio::VSDParser::readShape(librevenge::RVNGInputStream *input)
   auto fillStyle = MINUS_ONE;
   auto textStyle = MINUS_ONE;
 
-  try
-  {
-    input->seek(10, librevenge::RVNG_SEEK_CUR);
-    parent = readU32(input);
-    input->seek(4, librevenge::RVNG_SEEK_CUR);
-    masterPage = readU32(input);
-    input->seek(4, librevenge::RVNG_SEEK_CUR);
-    masterShape = readU32(input);
-    input->seek(0x4, librevenge::RVNG_SEEK_CUR);
-    fillStyle = readU32(input);
-    input->seek(4, librevenge::RVNG_SEEK_CUR);
-    lineStyle = readU32(input);
-    input->seek(4, librevenge::RVNG_SEEK_CUR);
-    textStyle = readU32(input);
-  }
-  catch (const EndOfStreamException &)
+  // Ids missing from a short record keep their defaults
+  const auto readId = [&input](unsigned &id)
   {
-  }
+    const unsigned value = input.readU32();
+    if (input.isGood())
+      id = value;
+  };
+  input.skip(10);
+  readId(parent);
+  input.skip(4);
+  readId(masterPage);
+  input.skip(4);
+  readId(masterShape);
+  input.skip(0x4);
+  readId(fillStyle);
+  input.skip(4);
+  readId(lineStyle);
+  input.skip(4);
+  readId(textStyle);
 
   m_shape.clear();
   m_currentGeometryList = nullptr;
@@ -1340,25 +1656,27 @@ void libvisio::VSDParser::readShape(librevenge::RVNGInputStream *input)
   m_currentShapeID = MINUS_ONE;
 }
 
-void libvisio::VSDParser::readNURBSTo(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readNURBSTo(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y = readDouble(input);
-  double knot = readDouble(input); // Second last knot
-  double weight = readDouble(input); // Last weight
-  double knotPrev = readDouble(input); // First knot
-  double weightPrev = readDouble(input); // First weight
+  input.skip(1);
+  double x = input.readDouble();
+  input.skip(1);
+  double y = input.readDouble();
+  double knot = input.readDouble(); // Second last knot
+  double weight = input.readDouble(); // Last weight
+  double knotPrev = input.readDouble(); // First knot
+  double weightPrev = input.readDouble(); // First weight
 
   // Detect whether to use Shape Data block
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  unsigned char useData = readU8(input);
+  input.skip(1);
+  unsigned char useData = input.readU8();
   if (useData == 0x8a)
   {
-    input->seek(3, librevenge::RVNG_SEEK_CUR);
-    unsigned dataId = readU32(input);
+    input.skip(3);
+    unsigned dataId = input.readU32();
 
+    if (!input.isGood())
+      return;
     if (m_currentGeometryList)
       m_currentGeometryList->addNURBSTo(m_header.id, m_header.level, x, y, knot, knotPrev, weight, weightPrev, dataId);
     return;
@@ -1370,26 +1688,26 @@ void libvisio::VSDParser::readNURBSTo(librevenge::RVNGInputStream *input)
   std::vector<double> weights;
   weights.push_back(weightPrev);
 
-  input->seek(9, librevenge::RVNG_SEEK_CUR); // Seek to blocks at offset 0x50 (80)
+  input.skip(9); // Seek to blocks at offset 0x50 (80)
   unsigned long chunkBytesRead = 0x50;
 
   // Find formula block referring to cell E (cell 6)
   unsigned cellRef = 0;
   unsigned length = 0;
-  unsigned long inputPos = input->tell();
-  while (cellRef != 6 && !input->isEnd() &&
+  unsigned long inputPos = input.tell();
+  while (cellRef != 6 && !input.isEnd() &&
          m_header.dataLength - chunkBytesRead > 4)
   {
-    length = readU32(input);
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
-    cellRef = readU8(input);
+    length = input.readU32();
+    input.skip(1);
+    cellRef = input.readU8();
     if (cellRef < 6)
-      input->seek(length - 6, librevenge::RVNG_SEEK_CUR);
-    chunkBytesRead += input->tell() - inputPos;
-    inputPos = input->tell();
+      input.skip(length - 6);
+    chunkBytesRead += input.tell() - inputPos;
+    inputPos = input.tell();
   }
 
-  if (input->isEnd())
+  if (input.isEnd())
     return;
 
   // Only read formula if block is found
@@ -1400,7 +1718,7 @@ void libvisio::VSDParser::readNURBSTo(librevenge::RVNGInputStream *input)
     unsigned degree = 3;
     // Indicates whether it's a "simple" NURBS block with a static format
     // or a complex block where parameters each have a type
-    unsigned char paramType = readU8(input);
+    unsigned char paramType = input.readU8();
     unsigned char valueType = 0;
 
     double lastKnot = 0;
@@ -1409,35 +1727,35 @@ void libvisio::VSDParser::readNURBSTo(librevenge::RVNGInputStream *input)
     // Read formula's static first four parameters
     if (paramType == 0x8a)
     {
-      lastKnot = readDouble(input);
-      degree = readU16(input);
-      xType = readU8(input);
-      yType = readU8(input);
-      repetitions = readU32(input);
+      lastKnot = input.readDouble();
+      degree = input.readU16();
+      xType = input.readU8();
+      yType = input.readU8();
+      repetitions = input.readU32();
     }
     else
     {
       valueType = paramType;
       if (valueType == 0x20)
-        lastKnot = readDouble(input);
+        lastKnot = input.readDouble();
       else
-        lastKnot = readU16(input);
-
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      degree = readU16(input);
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      xType = readU16(input);
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      yType = readU16(input);
+        lastKnot = input.readU16();
+
+      input.skip(1);
+      degree = input.readU16();
+      input.skip(1);
+      xType = input.readU16();
+      input.skip(1);
+      yType = input.readU16();
     }
 
     // Read sequences of (x, y, knot, weight) until finished
-    unsigned long bytesRead = input->tell() - inputPos;
+    unsigned long bytesRead = input.tell() - inputPos;
     unsigned char flag = 0;
-    if (paramType != 0x8a) flag = readU8(input);
+    if (paramType != 0x8a) flag = input.readU8();
     while ((paramType == 0x8a ? repetitions > 0 : flag != 0x81) && bytesRead < length)
     {
-      inputPos = input->tell();
+      inputPos = input.tell();
       double knot_ = 0;
       double weight_ = 0;
       double controlX = 0;
@@ -1445,45 +1763,49 @@ void libvisio::VSDParser::readNURBSTo(librevenge::RVNGInputStream *input)
 
       if (paramType == 0x8a) // Parameters have static format
       {
-        controlX = readDouble(input);
-        controlY = readDouble(input);
-        knot_ = readDouble(input);
-        weight_ = readDouble(input);
+        controlX = input.readDouble();
+        controlY = input.readDouble();
+        knot_ = input.readDouble();
+        weight_ = input.readDouble();
       }
       else // Parameters have types
       {
         valueType = flag;
         if (valueType == 0x20)
-          controlX = readDouble(input);
+          controlX = input.readDouble();
         else
-          controlX = readU16(input);
+          controlX = input.readU16();
 
-        valueType = readU8(input);
+        valueType = input.readU8();
         if (valueType == 0x20)
-          controlY = readDouble(input);
+          controlY = input.readDouble();
         else
-          controlY = readU16(input);
+          controlY = input.readU16();
 
-        valueType = readU8(input);
+        valueType = input.readU8();
         if (valueType == 0x20)
-          knot_ = readDouble(input);
+          knot_ = input.readDouble();
         else if (valueType == 0x62)
-          knot_ = readU16(input);
+          knot_ = input.readU16();
 
-        valueType = readU8(input);
+        valueType = input.readU8();
         if (valueType == 0x20)
-          weight_ = readDouble(input);
+          weight_ = input.readDouble();
         else if (valueType == 0x62)
-          weight_ = readU16(input);
+          weight_ = input.readU16();
       }
+      if (!input.isGood())
+        return;
       controlPoints.push_back(std::pair<double, double>(controlX, controlY));
       knotVector.push_back(knot_);
       weights.push_back(weight_);
 
-      if (paramType != 0x8a) flag = readU8(input);
+      if (paramType != 0x8a) flag = input.readU8();
       else repetitions--;
-      bytesRead += input->tell() - inputPos;
+      bytesRead += input.tell() - inputPos;
     }
+    if (!input.isGood())
+      return;
     knotVector.push_back(knot);
     knotVector.push_back(lastKnot);
     weights.push_back(weight);
@@ -1499,49 +1821,51 @@ void libvisio::VSDParser::readNURBSTo(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readPolylineTo(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readPolylineTo(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y = readDouble(input);
+  input.skip(1);
+  double x = input.readDouble();
+  input.skip(1);
+  double y = input.readDouble();
 
   // Detect whether to use Shape Data block
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  unsigned useData = readU8(input);
+  input.skip(1);
+  unsigned useData = input.readU8();
   if (useData == 0x8b)
   {
-    input->seek(3, librevenge::RVNG_SEEK_CUR);
-    unsigned dataId = readU32(input);
+    input.skip(3);
+    unsigned dataId = input.readU32();
 
+    if (!input.isGood())
+      return;
     if (m_currentGeometryList)
       m_currentGeometryList->addPolylineTo(m_header.id, m_header.level, x, y, dataId);
     return;
   }
 
   // Blocks start at 0x30
-  input->seek(0x9, librevenge::RVNG_SEEK_CUR);
+  input.skip(0x9);
   unsigned long chunkBytesRead = 0x30;
 
   // Find formula block referring to cell A (cell 2)
   unsigned cellRef = 0;
   unsigned length = 0;
-  unsigned long inputPos = input->tell();
-  while (cellRef != 2 && !input->isEnd() &&
+  unsigned long inputPos = input.tell();
+  while (cellRef != 2 && !input.isEnd() &&
          m_header.dataLength - chunkBytesRead > 4)
   {
-    length = readU32(input);
+    length = input.readU32();
     if (!length)
       break;
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
-    cellRef = readU8(input);
+    input.skip(1);
+    cellRef = input.readU8();
     if (cellRef < 2)
-      input->seek(length - 6, librevenge::RVNG_SEEK_CUR);
-    chunkBytesRead += input->tell() - inputPos;
-    inputPos = input->tell();
+      input.skip(length - 6);
+    chunkBytesRead += input.tell() - inputPos;
+    inputPos = input.tell();
   }
 
-  if (input->isEnd())
+  if (input.isEnd())
     return;
 
   // Default to local co-ordinates if unspecified
@@ -1551,42 +1875,46 @@ void libvisio::VSDParser::readPolylineTo(librevenge::RVNGInputStream *input)
   if (cellRef == 2)
   {
     unsigned long blockBytesRead = 0;
-    inputPos = input->tell();
+    inputPos = input.tell();
     blockBytesRead += 6;
 
     // Parse static first two parameters to function
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
-    unsigned char xType = readU16(input);
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
-    unsigned char yType = readU16(input);
+    input.skip(1);
+    unsigned char xType = input.readU16();
+    input.skip(1);
+    unsigned char yType = input.readU16();
 
     // Parse pairs of x,y co-ordinates
-    unsigned flag = readU8(input);
+    unsigned flag = input.readU8();
     unsigned valueType = 0; // Holds parameter type indicator
-    blockBytesRead += input->tell() - inputPos;
+    blockBytesRead += input.tell() - inputPos;
     while (flag != 0x81 && blockBytesRead < length)
     {
-      inputPos = input->tell();
+      inputPos = input.tell();
       double x2 = 0;
       double y2 = 0;
 
       valueType = flag;
       if (valueType == 0x20)
-        x2 = readDouble(input);
+        x2 = input.readDouble();
       else
-        x2 = readU16(input);
+        x2 = input.readU16();
 
-      valueType = readU8(input);
+      valueType = input.readU8();
       if (valueType == 0x20)
-        y2 = readDouble(input);
+        y2 = input.readDouble();
       else
-        y2 = readU16(input);
+        y2 = input.readU16();
 
+      if (!input.isGood())
+        return;
       points.push_back(std::pair<double, double>(x2, y2));
-      flag = readU8(input);
-      blockBytesRead += input->tell() - inputPos;
+      flag = input.readU8();
+      blockBytesRead += input.tell() - inputPos;
     }
 
+    if (!input.isGood())
+      return;
     if (m_currentGeometryList)
       m_currentGeometryList->addPolylineTo(m_header.id, m_header.level, x, y, xType,
                                            yType, points);
@@ -1598,42 +1926,47 @@ void libvisio::VSDParser::readPolylineTo(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readInfiniteLine(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readInfiniteLine(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x1 = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y1 = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x2 = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y2 = readDouble(input);
+  input.skip(1);
+  double x1 = input.readDouble();
+  input.skip(1);
+  double y1 = input.readDouble();
+  input.skip(1);
+  double x2 = input.readDouble();
+  input.skip(1);
+  double y2 = input.readDouble();
+
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addInfiniteLine(m_header.id, m_header.level, x1, y1, x2, y2);
 }
 
-void libvisio::VSDParser::readShapeData(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readShapeData(VSDBinaryReader &input)
 {
-  unsigned char dataType = readU8(input);
+  unsigned char dataType = input.readU8();
 
-  input->seek(15, librevenge::RVNG_SEEK_CUR);
+  input.skip(15);
   // Polyline data
   if (dataType == 0x80)
   {
     std::vector<std::pair<double, double> > points;
-    unsigned char xType = readU8(input);
-    unsigned char yType = readU8(input);
-    unsigned pointCount = readU32(input);
-    if (pointCount > getRemainingLength(input) / 16)
-      pointCount = getRemainingLength(input) / 16;
+    unsigned char xType = input.readU8();
+    unsigned char yType = input.readU8();
+    unsigned pointCount = input.readU32();
+    if (pointCount > input.getRemainingLength() / 16)
+      pointCount = input.getRemainingLength() / 16;
 
     for (unsigned i = 0; i < pointCount; i++)
     {
-      double x = readDouble(input);
-      double y = readDouble(input);
+      double x = input.readDouble();
+      double y = input.readDouble();
       points.push_back(std::pair<double, double>(x, y));
     }
 
+    if (!input.isGood())
+      return;
     PolylineData data;
     data.xType = xType;
     data.yType = yType;
@@ -1644,14 +1977,14 @@ void libvisio::VSDParser::readShapeData(librevenge::RVNGInputStream *input)
   // NURBS data
   else if (dataType == 0x82)
   {
-    double lastKnot = readDouble(input);
+    double lastKnot = input.readDouble();
 
-    unsigned degree = readU16(input);
-    unsigned char xType = readU8(input);
-    unsigned char yType = readU8(input);
-    unsigned pointCount = readU32(input);
-    if (pointCount > getRemainingLength(input) / 32)
-      pointCount = getRemainingLength(input) / 32;
+    unsigned degree = input.readU16();
+    unsigned char xType = input.readU8();
+    unsigned char yType = input.readU8();
+    unsigned pointCount = input.readU32();
+    if (pointCount > input.getRemainingLength() / 32)
+      pointCount = input.getRemainingLength() / 32;
 
     std::vector<double> knotVector;
     std::vector<std::pair<double, double> > controlPoints;
@@ -1659,16 +1992,18 @@ void libvisio::VSDParser::readShapeData(librevenge::RVNGInputStream *input)
 
     for (unsigned i = 0; i < pointCount; i++)
     {
-      double controlX = readDouble(input);
-      double controlY = readDouble(input);
-      double knot = readDouble(input);
-      double weight = readDouble(input);
+      double controlX = input.readDouble();
+      double controlY = input.readDouble();
+      double knot = input.readDouble();
+      double weight = input.readDouble();
 
       knotVector.push_back(knot);
       weights.push_back(weight);
       controlPoints.push_back(std::pair<double, double>(controlX, controlY));
     }
 
+    if (!input.isGood())
+      return;
     NURBSData data;
     data.lastKnot = lastKnot;
     data.degree = degree;
@@ -1681,114 +2016,128 @@ void libvisio::VSDParser::readShapeData(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readSplineStart(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readSplineStart(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y = readDouble(input);
-  double secondKnot = readDouble(input);
-  double firstKnot = readDouble(input);
-  double lastKnot = readDouble(input);
-  unsigned degree = readU8(input);
+  input.skip(1);
+  double x = input.readDouble();
+  input.skip(1);
+  double y = input.readDouble();
+  double secondKnot = input.readDouble();
+  double firstKnot = input.readDouble();
+  double lastKnot = input.readDouble();
+  unsigned degree = input.readU8();
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addSplineStart(m_header.id, m_header.level, x, y, secondKnot, firstKnot, lastKnot, degree);
 }
 
-void libvisio::VSDParser::readSplineKnot(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readSplineKnot(VSDBinaryReader &input)
 {
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double x = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double y = readDouble(input);
-  double knot = readDouble(input);
+  input.skip(1);
+  double x = input.readDouble();
+  input.skip(1);
+  double y = input.readDouble();
+  double knot = input.readDouble();
 
+  if (!input.isGood())
+    return;
   if (m_currentGeometryList)
     m_currentGeometryList->addSplineKnot(m_header.id, m_header.level, x, y, knot);
 }
 
-void libvisio::VSDParser::readNameList(librevenge::RVNGInputStream * /* input */)
+void libvisio::VSDParser::readNameList(VSDBinaryReader & /* input */)
 {
   m_shape.m_names.clear();
 }
 
-void libvisio::VSDParser::readNameList2(librevenge::RVNGInputStream * /* input */)
+void libvisio::VSDParser::readNameList2(VSDBinaryReader & /* input */)
 {
   m_names.clear();
 }
 
-void libvisio::VSDParser::readFieldList(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readFieldList(VSDBinaryReader &input)
 {
   if (m_header.trailer)
   {
-    uint32_t subHeaderLength = readU32(input);
-    uint32_t childrenListLength = readU32(input);
-    input->seek(subHeaderLength, librevenge::RVNG_SEEK_CUR);
-    if (childrenListLength > getRemainingLength(input))
-      childrenListLength = getRemainingLength(input);
+    uint32_t subHeaderLength = input.readU32();
+    uint32_t childrenListLength = input.readU32();
+    input.skip(subHeaderLength);
+    if (childrenListLength > input.getRemainingLength())
+      childrenListLength = input.getRemainingLength();
     std::vector<unsigned> fieldOrder;
     fieldOrder.reserve(childrenListLength / sizeof(uint32_t));
     for (size_t i = 0; i < (childrenListLength / sizeof(uint32_t)); i++)
-      fieldOrder.push_back(readU32(input));
+      fieldOrder.push_back(input.readU32());
 
+    if (!input.isGood())
+      return;
     m_shape.m_fields.setElementsOrder(fieldOrder);
     m_shape.m_fields.addFieldList(m_header.id, m_header.level);
   }
 }
 
-void libvisio::VSDParser::readColours(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readColours(VSDBinaryReader &input)
 {
-  input->seek(2, librevenge::RVNG_SEEK_CUR);
-  unsigned numColours = readU8(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
+  input.skip(2);
+  unsigned numColours = input.readU8();
+  input.skip(1);
+  if (!input.isGood())
+    return;
   m_colours.clear();
 
   for (unsigned i = 0; i < numColours; i++)
   {
     Colour tmpColour;
-    tmpColour.r = readU8(input);
-    tmpColour.g = readU8(input);
-    tmpColour.b = readU8(input);
-    tmpColour.a = readU8(input);
+    tmpColour.r = input.readU8();
+    tmpColour.g = input.readU8();
+    tmpColour.b = input.readU8();
+    tmpColour.a = input.readU8();
+    if (!input.isGood())
+      return;
 
     m_colours.push_back(tmpColour);
   }
 }
 
-void libvisio::VSDParser::readFont(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readFont(VSDBinaryReader &input)
 {
-  input->seek(4, librevenge::RVNG_SEEK_CUR);
+  input.skip(4);
   librevenge::RVNGBinaryData textStream;
 
   for (unsigned i = 0; i < 32; i++)
   {
-    unsigned char curchar = readU8(input);
-    unsigned char nextchar = readU8(input);
+    unsigned char curchar = input.readU8();
+    unsigned char nextchar = input.readU8();
     if (curchar == 0 && nextchar == 0)
       break;
     textStream.append(curchar);
     textStream.append(nextchar);
   }
+  if (!input.isGood())
+    return;
   m_fonts[m_header.id] = VSDName(textStream, libvisio::VSD_TEXT_UTF16);
 }
 
-void libvisio::VSDParser::readFontIX(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readFontIX(VSDBinaryReader &input)
 {
-  long tmpAdjust = input->tell();
-  input->seek(2, librevenge::RVNG_SEEK_CUR);
+  long tmpAdjust = input.tell();
+  input.skip(2);
   auto codePage = (unsigned char)(getUInt(input) & 0xff);
-  tmpAdjust -= input->tell();
+  tmpAdjust -= input.tell();
 
   std::string fontName;
 
   for (long i = 0; i < (long)(m_header.dataLength + tmpAdjust); i++)
   {
-    auto curchar = (char)readU8(input);
+    auto curchar = (char)input.readU8();
     if (curchar == 0)
       break;
     fontName.append(1, curchar);
   }
+  if (!input.isGood())
+    return;
 
   if (!codePage)
   {
@@ -1888,32 +2237,34 @@ void libvisio::VSDParser::readFontIX(librevenge::RVNGInputStream *input)
 
 /* StyleSheet readers */
 
-void libvisio::VSDParser::readStyleSheet(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readStyleSheet(VSDBinaryReader &input)
 {
-  input->seek(0x22, librevenge::RVNG_SEEK_CUR);
-  unsigned lineStyle = readU32(input);
-  input->seek(4, librevenge::RVNG_SEEK_CUR);
-  unsigned fillStyle = readU32(input);
-  input->seek(4, librevenge::RVNG_SEEK_CUR);
-  unsigned textStyle = readU32(input);
+  input.skip(0x22);
+  unsigned lineStyle = input.readU32();
+  input.skip(4);
+  unsigned fillStyle = input.readU32();
+  input.skip(4);
+  unsigned textStyle = input.readU32();
 
+  if (!input.isGood())
+    return;
   m_collector->collectStyleSheet(m_header.id, m_header.level, lineStyle, fillStyle, textStyle);
 }
 
-void libvisio::VSDParser::readPageSheet(librevenge::RVNGInputStream * /* input */)
+void libvisio::VSDParser::readPageSheet(VSDBinaryReader & /* input */)
 {
   m_currentShapeLevel = m_header.level;
   m_collector->collectPageSheet(m_header.id, m_header.level);
 }
 
-void libvisio::VSDParser::readText(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readText(VSDBinaryReader &input)
 {
-  input->seek(8, librevenge::RVNG_SEEK_CUR);
+  input.skip(8);
   librevenge::RVNGBinaryData textStream;
 
   // Read up to end of chunk in byte pairs (except from last 2 bytes)
   unsigned long numBytesRead = 0;
-  const unsigned char *tmpBuffer = input->read(m_header.dataLength - 8, numBytesRead);
+  const unsigned char *tmpBuffer = input.read(m_header.dataLength - 8, numBytesRead);
   if (numBytesRead)
   {
     if (m_isStencilStarted)
@@ -1928,21 +2279,21 @@ void libvisio::VSDParser::readText(librevenge::RVNGInputStream *input)
   m_shape.m_textFormat = libvisio::VSD_TEXT_UTF16;
 }
 
-void libvisio::VSDParser::readCharIX(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readCharIX(VSDBinaryReader &input)
 {
   VSDFont fontFace;
-  unsigned charCount = readU32(input);
-  unsigned fontID = readU16(input);
+  unsigned charCount = input.readU32();
+  unsigned fontID = input.readU16();
   VSDName font;
   std::map<unsigned, VSDName>::const_iterator iter = m_fonts.find(fontID);
   if (iter != m_fonts.end())
     font = iter->second;
-  input->seek(1, librevenge::RVNG_SEEK_CUR);  // Color ID
+  input.skip(1);  // Color ID
   Colour fontColour;            // Font Colour
-  fontColour.r = readU8(input);
-  fontColour.g = readU8(input);
-  fontColour.b = readU8(input);
-  fontColour.a = readU8(input);
+  fontColour.r = input.readU8();
+  fontColour.g = input.readU8();
+  fontColour.b = input.readU8();
+  fontColour.a = input.readU8();
 
   bool bold(false);
   bool italic(false);
@@ -1955,27 +2306,29 @@ void libvisio::VSDParser::readCharIX(librevenge::RVNGInputStream *input)
   bool smallcaps(false);
   bool superscript(false);
   bool subscript(false);
-  unsigned char fontMod = readU8(input);
+  unsigned char fontMod = input.readU8();
   if (fontMod & 1) bold = true;
   if (fontMod & 2) italic = true;
   if (fontMod & 4) underline = true;
   if (fontMod & 8) smallcaps = true;
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) allcaps = true;
   if (fontMod & 2) initcaps = true;
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) superscript = true;
   if (fontMod & 2) subscript = true;
 
-  double scaleWidth = (double)(readU16(input)) / 10000.0;
-  input->seek(2, librevenge::RVNG_SEEK_CUR);
-  double fontSize = readDouble(input);
+  double scaleWidth = (double)(input.readU16()) / 10000.0;
+  input.skip(2);
+  double fontSize = input.readDouble();
 
-  fontMod = readU8(input);
+  fontMod = input.readU8();
   if (fontMod & 1) doubleunderline = true;
   if (fontMod & 4) strikeout = true;
   if (fontMod & 0x20) doublestrikeout = true;
 
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectCharIXStyle(m_header.id, m_header.level, charCount, font, fontColour, fontSize,
                                     bold, italic, underline, doubleunderline, strikeout, doublestrikeout,
@@ -1996,26 +2349,26 @@ void libvisio::VSDParser::readCharIX(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readParaIX(librevenge::RVNGInputStream *input)
-{
-  long startPosition = input->tell();
-  unsigned charCount = readU32(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indFirst = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indLeft = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double indRight = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spLine = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spBefore = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double spAfter = readDouble(input);
-  unsigned char align = readU8(input);
-  unsigned char bullet = readU8(input);
-  input->seek(4, librevenge::RVNG_SEEK_CUR);
-  unsigned fontID = readU16(input);
+void libvisio::VSDParser::readParaIX(VSDBinaryReader &input)
+{
+  long startPosition = input.tell();
+  unsigned charCount = input.readU32();
+  input.skip(1);
+  double indFirst = input.readDouble();
+  input.skip(1);
+  double indLeft = input.readDouble();
+  input.skip(1);
+  double indRight = input.readDouble();
+  input.skip(1);
+  double spLine = input.readDouble();
+  input.skip(1);
+  double spBefore = input.readDouble();
+  input.skip(1);
+  double spAfter = input.readDouble();
+  unsigned char align = input.readU8();
+  unsigned char bullet = input.readU8();
+  input.skip(4);
+  unsigned fontID = input.readU16();
   VSDName bulletFont;
   if (fontID)
   {
@@ -2023,27 +2376,27 @@ void libvisio::VSDParser::readParaIX(librevenge::RVNGInputStream *input)
     if (iter != m_fonts.end())
       bulletFont = iter->second;
   }
-  input->seek(2, librevenge::RVNG_SEEK_CUR);
-  double bulletFontSize = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR);
-  double textPosAfterBullet = readDouble(input);
-  unsigned flags = readU32(input);
-  input->seek(34, librevenge::RVNG_SEEK_CUR);
-  long remainingData = m_header.dataLength - input->tell() + startPosition;
+  input.skip(2);
+  double bulletFontSize = input.readDouble();
+  input.skip(1);
+  double textPosAfterBullet = input.readDouble();
+  unsigned flags = input.readU32();
+  input.skip(34);
+  long remainingData = m_header.dataLength - input.tell() + startPosition;
   unsigned blockLength = 0;
   VSDName bulletStr;
 
-  while (remainingData >= 4 && (blockLength = readU32(input)))
+  while (remainingData >= 4 && (blockLength = input.readU32()))
   {
-    long blockEnd = blockLength-4 + input->tell();
-    unsigned char blockType = readU8(input);
-    unsigned char blockIdx = readU8(input);
+    long blockEnd = blockLength-4 + input.tell();
+    unsigned char blockType = input.readU8();
+    unsigned char blockIdx = input.readU8();
     if (blockType == 2 && blockIdx == 8)
     {
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      unsigned long numBytes = 2*readU8(input);
+      input.skip(1);
+      unsigned long numBytes = 2*input.readU8();
       unsigned long numBytesRead = 0;
-      const unsigned char *tmpBuffer = input->read(numBytes, numBytesRead);
+      const unsigned char *tmpBuffer = input.read(numBytes, numBytesRead);
       if (tmpBuffer && numBytesRead)
       {
         librevenge::RVNGBinaryData tmpBulletString(tmpBuffer, numBytesRead);
@@ -2053,11 +2406,12 @@ void libvisio::VSDParser::readParaIX(librevenge::RVNGInputStream *input)
     else if (blockType == 2 && blockIdx == 3)
     {
     };
-    input->seek(blockEnd, librevenge::RVNG_SEEK_SET);
+    input.seek(blockEnd);
     remainingData -= blockLength;
   }
 
-
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectParaIXStyle(m_header.id, m_header.level, charCount, indFirst, indLeft, indRight,
                                     spLine, spBefore, spAfter, align, bullet, bulletStr, bulletFont,
@@ -2081,20 +2435,20 @@ void libvisio::VSDParser::readParaIX(librevenge::RVNGInputStream *input)
 }
 
 
-void libvisio::VSDParser::readFillAndShadow(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readFillAndShadow(VSDBinaryReader &input)
 {
-  unsigned char colourFGIndex = readU8(input);
+  unsigned char colourFGIndex = input.readU8();
   Colour colourFG;
-  colourFG.r = readU8(input);
-  colourFG.g = readU8(input);
-  colourFG.b = readU8(input);
-  colourFG.a = readU8(input);
-  unsigned char colourBGIndex = readU8(input);
+  colourFG.r = input.readU8();
+  colourFG.g = input.readU8();
+  colourFG.b = input.readU8();
+  colourFG.a = input.readU8();
+  unsigned char colourBGIndex = input.readU8();
   Colour colourBG;
-  colourBG.r = readU8(input);
-  colourBG.g = readU8(input);
-  colourBG.b = readU8(input);
-  colourBG.a = readU8(input);
+  colourBG.r = input.readU8();
+  colourBG.g = input.readU8();
+  colourBG.b = input.readU8();
+  colourBG.a = input.readU8();
   if (!colourFG && !colourBG)
   {
     colourFG = _colourFromIndex(colourFGIndex);
@@ -2103,36 +2457,36 @@ void libvisio::VSDParser::readFillAndShadow(librevenge::RVNGInputStream *input)
   double fillFGTransparency = (double)colourFG.a / 255.0;
   double fillBGTransparency = (double)colourBG.a / 255.0;
 
-  unsigned char fillPattern = readU8(input);
+  unsigned char fillPattern = input.readU8();
 
-  unsigned char shadowFGIndex = readU8(input);
+  unsigned char shadowFGIndex = input.readU8();
   Colour shadowFG;
-  shadowFG.r = readU8(input);
-  shadowFG.g = readU8(input);
-  shadowFG.b = readU8(input);
-  shadowFG.a = readU8(input);
-  unsigned char shadowBGIndex = readU8(input);
+  shadowFG.r = input.readU8();
+  shadowFG.g = input.readU8();
+  shadowFG.b = input.readU8();
+  shadowFG.a = input.readU8();
+  unsigned char shadowBGIndex = input.readU8();
   Colour shadowBG;
-  shadowBG.r = readU8(input);
-  shadowBG.g = readU8(input);
-  shadowBG.b = readU8(input);
-  shadowBG.a = readU8(input);
+  shadowBG.r = input.readU8();
+  shadowBG.g = input.readU8();
+  shadowBG.b = input.readU8();
+  shadowBG.a = input.readU8();
   if (!shadowFG && !shadowBG)
   {
     shadowFG = _colourFromIndex(shadowFGIndex);
     shadowBG = _colourFromIndex(shadowBGIndex);
   }
 
-  unsigned char shadowPattern = readU8(input);
+  unsigned char shadowPattern = input.readU8();
 
 // only version 11 after that point
-  input->seek(2, librevenge::RVNG_SEEK_CUR); // Shadow Type and Value format byte
-  double shadowOffsetX = readDouble(input);
-  input->seek(1, librevenge::RVNG_SEEK_CUR); // Value format byte
-  double shadowOffsetY = readDouble(input);
-
-
+  input.skip(2); // Shadow Type and Value format byte
+  double shadowOffsetX = input.readDouble();
+  input.skip(1); // Value format byte
+  double shadowOffsetY = input.readDouble();
 
+  if (!input.isGood())
+    return;
   if (m_isInStyles)
     m_collector->collectFillStyle(m_header.level, colourFG, colourBG, fillPattern,
                                   fillFGTransparency, fillBGTransparency, shadowPattern, shadowFG,
@@ -2149,10 +2503,10 @@ void libvisio::VSDParser::readFillAndShadow(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readName(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readName(VSDBinaryReader &input)
 {
   unsigned long numBytesRead = 0;
-  const unsigned char *tmpBuffer = input->read(m_header.dataLength, numBytesRead);
+  const unsigned char *tmpBuffer = input.read(m_header.dataLength, numBytesRead);
   if (numBytesRead)
   {
     librevenge::RVNGBinaryData name(tmpBuffer, numBytesRead);
@@ -2160,67 +2514,71 @@ void libvisio::VSDParser::readName(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readName2(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readName2(VSDBinaryReader &input)
 {
   unsigned short unicharacter = 0;
   librevenge::RVNGBinaryData name;
-  input->seek(4, librevenge::RVNG_SEEK_CUR); // skip a dword that seems to be always 1
-  while ((unicharacter = readU16(input)))
+  input.skip(4); // skip a dword that seems to be always 1
+  while ((unicharacter = input.readU16()))
   {
     name.append(unicharacter & 0xff);
     name.append((unicharacter & 0xff00) >> 8);
   }
+  if (!input.isGood())
+    return;
   name.append(unicharacter & 0xff);
   name.append((unicharacter & 0xff00) >> 8);
   m_names[m_header.id] = VSDName(name, libvisio::VSD_TEXT_UTF16);
 }
 
-void libvisio::VSDParser::readTextField(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readTextField(VSDBinaryReader &input)
 {
-  unsigned long initialPosition = input->tell();
-  input->seek(7, librevenge::RVNG_SEEK_CUR);
-  unsigned char cellType = readU8(input);
+  unsigned long initialPosition = input.tell();
+  input.skip(7);
+  unsigned char cellType = input.readU8();
   if (cellType == CELL_TYPE_StringWithoutUnit)
   {
-    int nameId = readS32(input);
-    input->seek(6, librevenge::RVNG_SEEK_CUR);
-    int formatStringId = readS32(input);
+    int nameId = input.readS32();
+    input.skip(6);
+    int formatStringId = input.readS32();
+    if (!input.isGood())
+      return;
     m_shape.m_fields.addTextField(m_header.id, m_header.level, nameId, formatStringId);
   }
   else
   {
-    double numericValue = readDouble(input);
-    input->seek(2, librevenge::RVNG_SEEK_CUR);
-    int formatStringId = readS32(input);
+    double numericValue = input.readDouble();
+    input.skip(2);
+    int formatStringId = input.readS32();
 
     unsigned blockIdx = 0;
     unsigned length = 0;
     unsigned short formatNumber = 0;
-    input->seek(initialPosition+0x36, librevenge::RVNG_SEEK_SET);
-    while (blockIdx != 2 && !input->isEnd() && (unsigned long) input->tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
+    input.seek(initialPosition+0x36);
+    while (blockIdx != 2 && !input.isEnd() && (unsigned long) input.tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
     {
-      unsigned long inputPos = input->tell();
-      length = readU32(input);
+      unsigned long inputPos = input.tell();
+      length = input.readU32();
       if (!length)
         break;
-      input->seek(1, librevenge::RVNG_SEEK_CUR);
-      blockIdx = readU8(input);
+      input.skip(1);
+      blockIdx = input.readU8();
       if (blockIdx != 2)
-        input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+        input.seek(inputPos + length);
       else
       {
-        input->seek(1, librevenge::RVNG_SEEK_CUR);
-        formatNumber = readU16(input);
-        if (0x80 != readU8(input))
+        input.skip(1);
+        formatNumber = input.readU16();
+        if (0x80 != input.readU8())
         {
-          input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+          input.seek(inputPos + length);
           blockIdx = 0;
         }
         else
         {
-          if (0xc2 != readU8(input))
+          if (0xc2 != input.readU8())
           {
-            input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+            input.seek(inputPos + length);
             blockIdx = 0;
           }
           else
@@ -2229,7 +2587,7 @@ void libvisio::VSDParser::readTextField(librevenge::RVNGInputStream *input)
       }
     }
 
-    if (input->isEnd())
+    if (input.isEnd() || !input.isGood())
       return;
 
     if (blockIdx != 2)
@@ -2244,34 +2602,36 @@ void libvisio::VSDParser::readTextField(librevenge::RVNGInputStream *input)
   }
 }
 
-void libvisio::VSDParser::readMisc(librevenge::RVNGInputStream *input)
+void libvisio::VSDParser::readMisc(VSDBinaryReader &input)
 {
-  unsigned long initialPosition = input->tell();
-  unsigned char flags = readU8(input);
+  unsigned long initialPosition = input.tell();
+  unsigned char flags = input.readU8();
+  if (!input.isGood())
+    return;
   if (flags & 0x20)
     m_shape.m_misc.m_hideText = true;
   else
     m_shape.m_misc.m_hideText = false;
 
-  input->seek(initialPosition+45, librevenge::RVNG_SEEK_SET);
-  while (!input->isEnd() && (unsigned long) input->tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
+  input.seek(initialPosition+45);
+  while (!input.isEnd() && (unsigned long) input.tell() < (unsigned long)(initialPosition+m_header.dataLength+m_header.trailer))
   {
-    unsigned long inputPos = input->tell();
-    unsigned length = readU32(input);
+    unsigned long inputPos = input.tell();
+    unsigned length = input.readU32();
     if (!length)
       break;
-    unsigned blockType = readU8(input);
-    input->seek(1, librevenge::RVNG_SEEK_CUR);
+    unsigned blockType = input.readU8();
+    input.skip(1);
     if (blockType == 2)
     {
-      if (0x74 == readU8(input))
+      if (0x74 == input.readU8())
       {
-        if (0x6000004e == readU32(input))
+        if (0x6000004e == input.readU32())
         {
-          unsigned shapeId = readU32(input);
-          if (0x7a == readU8(input))
+          unsigned shapeId = input.readU32();
+          if (0x7a == input.readU8())
           {
-            if (0x40000073 == readU32(input))
+            if (0x40000073 == input.readU32())
             {
               if (!m_shape.m_xform1d)
                 m_shape.m_xform1d = std::make_unique<XForm1D>();
@@ -2284,7 +2644,7 @@ void libvisio::VSDParser::readMisc(librevenge::RVNGInputStream *input)
         }
       }
     }
-    input->seek(inputPos + length, librevenge::RVNG_SEEK_SET);
+    input.seek(inputPos + length);
   }
 }
 
@@ -2295,14 +2655,14 @@ libvisio::Colour libvisio::VSDParser::_colourFromIndex(unsigned idx)
   return libvisio::Colour();
 }
 
-unsigned libvisio::VSDParser::getUInt(librevenge::RVNGInputStream *input)
+unsigned libvisio::VSDParser::getUInt(VSDBinaryReader &input)
 {
-  return readU32(input);
+  return input.readU32();
 }
 
-int libvisio::VSDParser::getInt(librevenge::RVNGInputStream *input)
+int libvisio::VSDParser::getInt(VSDBinaryReader &input)
 {
-  return readS32(input);
+  return input.readS32();
 }
 
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
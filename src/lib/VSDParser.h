@@ -11,25 +11,34 @@
 #define __VSDPARSER_H__
 
 #include <stdio.h>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <stack>
 #include <map>
 #include <set>
 #include <librevenge/librevenge.h>
+#include <libvisio/VisioDocument.h>
 #include "VSDTypes.h"
+#include "VSDBinaryReader.h"
 #include "VSDGeometryList.h"
 #include "VSDFieldList.h"
 #include "VSDCharacterList.h"
 #include "VSDParagraphList.h"
 #include "VSDShapeList.h"
 #include "VSDLayerList.h"
+#include "VSDPageSelection.h"
 #include "VSDStencils.h"
+#include "VSDStreamCache.h"
 
 namespace libvisio
 {
 
 class VSDCollector;
+class VSDContentCollector;
+class VSDPages;
+class VSDRecordingCollector;
 
 struct Pointer
 {
@@ -51,73 +60,80 @@ public:
   virtual ~VSDParser();
   bool parseMain();
   bool extractStencils();
+  void setStreamCacheSize(unsigned long maxSize);
+  void setSinglePass(bool singlePass);
+  void setMaxRecordSize(unsigned long maxSize);
+  void setPageSelection(const VSDPageSelection &pageSelection);
+  void setPagesOutput(VSDPages *pages);
+  void setParseOptions(const VisioParseOptions &options);
 
 protected:
   // reader functions
-  void readEllipticalArcTo(librevenge::RVNGInputStream *input);
-  void readForeignData(librevenge::RVNGInputStream *input);
-  void readEllipse(librevenge::RVNGInputStream *input);
-  virtual void readLine(librevenge::RVNGInputStream *input);
-  virtual void readFillAndShadow(librevenge::RVNGInputStream *input);
-  virtual void readGeomList(librevenge::RVNGInputStream *input);
-  void readGeometry(librevenge::RVNGInputStream *input);
-  void readMoveTo(librevenge::RVNGInputStream *input);
-  void readLineTo(librevenge::RVNGInputStream *input);
-  void readArcTo(librevenge::RVNGInputStream *input);
-  void readNURBSTo(librevenge::RVNGInputStream *input);
-  void readPolylineTo(librevenge::RVNGInputStream *input);
-  void readInfiniteLine(librevenge::RVNGInputStream *input);
-  void readShapeData(librevenge::RVNGInputStream *input);
-  void readXFormData(librevenge::RVNGInputStream *input);
-  virtual void readXForm1D(librevenge::RVNGInputStream *input);
-  void readTxtXForm(librevenge::RVNGInputStream *input);
-  void readShapeId(librevenge::RVNGInputStream *input);
-  virtual void readShapeList(librevenge::RVNGInputStream *input);
-  void readForeignDataType(librevenge::RVNGInputStream *input);
-  void readPageProps(librevenge::RVNGInputStream *input);
-  virtual void readShape(librevenge::RVNGInputStream *input);
-  void readColours(librevenge::RVNGInputStream *input);
-  void readFont(librevenge::RVNGInputStream *input);
-  void readFontIX(librevenge::RVNGInputStream *input);
-  virtual void readCharList(librevenge::RVNGInputStream *input);
-  virtual void readParaList(librevenge::RVNGInputStream *input);
-  virtual void readPropList(librevenge::RVNGInputStream *input);
-  virtual void readPage(librevenge::RVNGInputStream *input);
-  virtual void readText(librevenge::RVNGInputStream *input);
-  virtual void readCharIX(librevenge::RVNGInputStream *input);
-  virtual void readParaIX(librevenge::RVNGInputStream *input);
-  virtual void readTextBlock(librevenge::RVNGInputStream *input);
-  virtual void readTabsDataList(librevenge::RVNGInputStream *input);
-  virtual void readTabsData(librevenge::RVNGInputStream *input);
-
-  void readNameList(librevenge::RVNGInputStream *input);
-  virtual void readName(librevenge::RVNGInputStream *input);
-
-  virtual void readNameList2(librevenge::RVNGInputStream *input);
-  virtual void readName2(librevenge::RVNGInputStream *input);
-
-  virtual void readFieldList(librevenge::RVNGInputStream *input);
-  virtual void readTextField(librevenge::RVNGInputStream *input);
-
-  virtual void readStyleSheet(librevenge::RVNGInputStream *input);
-  void readPageSheet(librevenge::RVNGInputStream *input);
-
-  void readSplineStart(librevenge::RVNGInputStream *input);
-  void readSplineKnot(librevenge::RVNGInputStream *input);
-
-  void readStencilShape(librevenge::RVNGInputStream *input);
-
-  void readOLEList(librevenge::RVNGInputStream *input);
-  void readOLEData(librevenge::RVNGInputStream *input);
-
-  virtual void readNameIDX(librevenge::RVNGInputStream *input);
-  virtual void readNameIDX123(librevenge::RVNGInputStream *input);
-
-  virtual void readMisc(librevenge::RVNGInputStream *input);
-
-  virtual void readLayerList(librevenge::RVNGInputStream *input);
-  virtual void readLayer(librevenge::RVNGInputStream *input);
-  virtual void readLayerMem(librevenge::RVNGInputStream *input);
+  void readEllipticalArcTo(VSDBinaryReader &input);
+  void readForeignData(VSDBinaryReader &input);
+  void readEllipse(VSDBinaryReader &input);
+  virtual void readLine(VSDBinaryReader &input);
+  virtual void readFillAndShadow(VSDBinaryReader &input);
+  virtual void readGeomList(VSDBinaryReader &input);
+  void readGeometry(VSDBinaryReader &input);
+  void readMoveTo(VSDBinaryReader &input);
+  void readLineTo(VSDBinaryReader &input);
+  void readArcTo(VSDBinaryReader &input);
+  void readNURBSTo(VSDBinaryReader &input);
+  void readPolylineTo(VSDBinaryReader &input);
+  void readInfiniteLine(VSDBinaryReader &input);
+  void readShapeData(VSDBinaryReader &input);
+  void readXFormData(VSDBinaryReader &input);
+  virtual void readXForm1D(VSDBinaryReader &input);
+  void readTxtXForm(VSDBinaryReader &input);
+  void readShapeId(VSDBinaryReader &input);
+  virtual void readShapeList(VSDBinaryReader &input);
+  void readForeignDataType(VSDBinaryReader &input);
+  void readPageProps(VSDBinaryReader &input);
+  virtual void readShape(VSDBinaryReader &input);
+  void readColours(VSDBinaryReader &input);
+  void readFont(VSDBinaryReader &input);
+  void readFontIX(VSDBinaryReader &input);
+  virtual void readCharList(VSDBinaryReader &input);
+  virtual void readParaList(VSDBinaryReader &input);
+  virtual void readPropList(VSDBinaryReader &input);
+  virtual void readPage(VSDBinaryReader &input);
+  virtual unsigned readBackgroundPageID(VSDBinaryReader &input);
+  virtual void readText(VSDBinaryReader &input);
+  virtual void readCharIX(VSDBinaryReader &input);
+  virtual void readParaIX(VSDBinaryReader &input);
+  virtual void readTextBlock(VSDBinaryReader &input);
+  virtual void readTabsDataList(VSDBinaryReader &input);
+  virtual void readTabsData(VSDBinaryReader &input);
+
+  void readNameList(VSDBinaryReader &input);
+  virtual void readName(VSDBinaryReader &input);
+
+  virtual void readNameList2(VSDBinaryReader &input);
+  virtual void readName2(VSDBinaryReader &input);
+
+  virtual void readFieldList(VSDBinaryReader &input);
+  virtual void readTextField(VSDBinaryReader &input);
+
+  virtual void readStyleSheet(VSDBinaryReader &input);
+  void readPageSheet(VSDBinaryReader &input);
+
+  void readSplineStart(VSDBinaryReader &input);
+  void readSplineKnot(VSDBinaryReader &input);
+
+  void readStencilShape(VSDBinaryReader &input);
+
+  void readOLEList(VSDBinaryReader &input);
+  void readOLEData(VSDBinaryReader &input);
+
+  virtual void readNameIDX(VSDBinaryReader &input);
+  virtual void readNameIDX123(VSDBinaryReader &input);
+
+  virtual void readMisc(VSDBinaryReader &input);
+
+  virtual void readLayerList(VSDBinaryReader &input);
+  virtual void readLayer(VSDBinaryReader &input);
+  virtual void readLayerMem(VSDBinaryReader &input);
 
   // parser of one pass
   bool parseDocument(librevenge::RVNGInputStream *input, unsigned shift);
@@ -127,20 +143,27 @@ protected:
   // Stream handlers
   void handleStreams(librevenge::RVNGInputStream *input, unsigned ptrType, unsigned shift, unsigned level, std::set<unsigned> &visited);
   void handleStream(const Pointer &ptr, unsigned idx, unsigned level, std::set<unsigned> &visited);
-  void handleChunks(librevenge::RVNGInputStream *input, unsigned level);
-  void handleChunk(librevenge::RVNGInputStream *input);
-  void handleBlob(librevenge::RVNGInputStream *input, unsigned shift, unsigned level);
+  void handleChunks(VSDBinaryReader &input, unsigned level);
+  void handleChunk(VSDBinaryReader &input);
+  void handleBlob(VSDBinaryReader &input, unsigned shift, unsigned level);
+  bool replay(const VSDRecordingCollector &recordingCollector, VSDContentCollector &contentCollector,
+              const std::function<std::unique_ptr<VSDContentCollector> ()> &createCollector);
+  const unsigned char *getStreamData(const Pointer &ptr, VSDStreamCache::Buffer_t &buffer, unsigned long &length);
+  void selectPages(std::map<unsigned, Pointer> &pointers, const std::vector<unsigned> &pointerOrder);
+  unsigned getBackgroundPageID(const Pointer &ptr);
 
   virtual void readPointer(librevenge::RVNGInputStream *input, Pointer &ptr);
   virtual void readPointerInfo(librevenge::RVNGInputStream *input, unsigned ptrType, unsigned shift, unsigned &listSize, int &pointerCount);
-  virtual bool getChunkHeader(librevenge::RVNGInputStream *input);
+  virtual bool getChunkHeader(VSDBinaryReader &input);
   void _handleLevelChange(unsigned level);
   Colour _colourFromIndex(unsigned idx);
   void _flushShape();
+  bool _isSkeletonScan() const;
+  bool _isContentChunk() const;
   void _nameFromId(VSDName &name, unsigned id, unsigned level);
 
-  virtual unsigned getUInt(librevenge::RVNGInputStream *input);
-  virtual int getInt(librevenge::RVNGInputStream *input);
+  virtual unsigned getUInt(VSDBinaryReader &input);
+  virtual int getInt(VSDBinaryReader &input);
 
   librevenge::RVNGInputStream *m_input;
   librevenge::RVNGDrawingInterface *m_painter;
@@ -179,6 +202,19 @@ protected:
 
   std::map<unsigned, VSDTabStop> *m_currentTabSet;
 
+  VSDStreamCache m_streamCache;
+  // The whole document, as read from the input, which keeps the data
+  const unsigned char *m_documentData;
+  unsigned long m_documentLength;
+
+  bool m_singlePass;
+  unsigned long m_maxRecordSize;
+  VSDRecordingCollector *m_recorder;
+  bool m_isFirstPass;
+  VSDPageSelection m_pageSelection;
+  VSDPages *m_pagesOutput;
+  VisioParseOptions m_parseOptions;
+
 private:
   VSDParser();
   VSDParser(const VSDParser &);
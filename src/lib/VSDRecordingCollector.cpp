@@ -0,0 +1,762 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "VSDRecordingCollector.h"
+
+#include <thread>
+#include "VSDContentCollector.h"
+#include "VSDPages.h"
+#include "VSDStylesCollector.h"
+#include "VSDXTheme.h"
+
+libvisio::VSDRecordingCollector::VSDRecordingCollector(VSDStylesCollector *collector, unsigned long maxSize) :
+  m_collector(collector), m_calls(), m_mark(0), m_size(0), m_markSize(0), m_maxSize(maxSize), m_pageCount(0), m_isDiscarded(false),
+  m_pageCalls(), m_isPageStarted(false), m_arePagesSeparate(true)
+{
+}
+
+libvisio::VSDRecordingCollector::~VSDRecordingCollector()
+{
+}
+
+template<typename C>
+void libvisio::VSDRecordingCollector::record(const C &call, std::size_t dataSize)
+{
+  call(m_collector);
+  if (m_isDiscarded)
+    return;
+  m_size += sizeof(std::function<void (VSDContentCollector *)>) + sizeof(C) + dataSize;
+  if (m_size > m_maxSize)
+    discard();
+  else
+    m_calls.push_back(call);
+}
+
+void libvisio::VSDRecordingCollector::mark()
+{
+  m_mark = m_calls.size();
+  m_markSize = m_size;
+}
+
+void libvisio::VSDRecordingCollector::rewind()
+{
+  if (m_mark < m_calls.size())
+    m_calls.erase(m_calls.begin() + m_mark, m_calls.end());
+  m_size = m_markSize;
+  while (!m_pageCalls.empty() && m_pageCalls.back().first >= m_mark)
+  {
+    m_pageCalls.pop_back();
+    m_isPageStarted = false;
+  }
+  if (!m_pageCalls.empty() && m_pageCalls.back().second > m_mark)
+    m_pageCalls.back().second = m_mark;
+}
+
+void libvisio::VSDRecordingCollector::discard()
+{
+  m_isDiscarded = true;
+  m_size = 0;
+  std::vector<std::function<void (VSDContentCollector *)> >().swap(m_calls);
+  std::vector<std::pair<std::size_t, std::size_t> >().swap(m_pageCalls);
+}
+
+void libvisio::VSDRecordingCollector::replay(VSDContentCollector *collector) const
+{
+  for (const auto &call : m_calls)
+    call(collector);
+}
+
+void libvisio::VSDRecordingCollector::replay(VSDContentCollector *collector, const ContentCollectorFactory_t &createCollector, unsigned threadCount) const
+{
+  const std::size_t pageCount = m_pageCalls.size();
+  if (threadCount > pageCount)
+    threadCount = unsigned(pageCount);
+  if (threadCount < 2 || m_isPageStarted || !m_arePagesSeparate)
+  {
+    replay(collector);
+    return;
+  }
+
+  // Each thread gets a run of consecutive pages, so a page only misses what
+  // the page before it left behind in the collector at the start of a run
+  std::vector<VSDPages> pages(pageCount);
+  std::vector<std::exception_ptr> errors(pageCount);
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount);
+  for (unsigned i = 0; i < threadCount; ++i)
+  {
+    const std::size_t first = pageCount * i / threadCount;
+    const std::size_t last = pageCount * (i + 1) / threadCount;
+    threads.emplace_back([&, first, last]()
+    {
+      _replayPages(createCollector, first, last, pages, errors);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  // Nothing reaches the collector unless every page was collected
+  for (const auto &error : errors)
+  {
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  std::size_t call = 0;
+  for (std::size_t page = 0; page < pageCount; ++page)
+  {
+    for (; call < m_pageCalls[page].first; ++call)
+      m_calls[call](collector);
+    collector->appendPages(pages[page]);
+    call = m_pageCalls[page].second;
+  }
+  for (; call < m_calls.size(); ++call)
+    m_calls[call](collector);
+}
+
+void libvisio::VSDRecordingCollector::_replayPages(const ContentCollectorFactory_t &createCollector, std::size_t first, std::size_t last,
+                                                   std::vector<VSDPages> &pages, std::vector<std::exception_ptr> &errors) const
+{
+  std::size_t page = first;
+  try
+  {
+    const std::unique_ptr<VSDContentCollector> collector(createCollector());
+    collector->setPageNumber(unsigned(first));
+    // The calls outside of pages go to every collector, the calls of a page
+    // only to the one that collects it
+    std::size_t call = 0;
+    for (std::size_t i = 0; i < last; ++i)
+    {
+      if (i >= first)
+        page = i;
+      for (; call < m_pageCalls[i].first; ++call)
+        m_calls[call](collector.get());
+      if (i >= first)
+      {
+        for (; call < m_pageCalls[i].second; ++call)
+          m_calls[call](collector.get());
+        collector->takePages(pages[i]);
+      }
+      call = m_pageCalls[i].second;
+    }
+  }
+  catch (...)
+  {
+    errors[page] = std::current_exception();
+  }
+}
+
+void libvisio::VSDRecordingCollector::collectDocumentTheme(const VSDXTheme *theme)
+{
+  // The record keeps its own copy, the parser's theme may be gone by the replay
+  const std::shared_ptr<const VSDXTheme> recordedTheme(theme ? std::make_shared<const VSDXTheme>(*theme) : nullptr);
+  record([=](auto *collector)
+  {
+    collector->collectDocumentTheme(recordedTheme.get());
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectEllipticalArcTo(unsigned id, unsigned level, double x3, double y3, double x2, double y2, double angle, double ecc)
+{
+  record([=](auto *collector)
+  {
+    collector->collectEllipticalArcTo(id, level, x3, y3, x2, y2, angle, ecc);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectForeignData(unsigned level, const librevenge::RVNGBinaryData &binaryData)
+{
+  record([=](auto *collector)
+  {
+    collector->collectForeignData(level, binaryData);
+  }, binaryData.size());
+}
+
+void libvisio::VSDRecordingCollector::collectOLEList(unsigned id, unsigned level)
+{
+  record([=](auto *collector)
+  {
+    collector->collectOLEList(id, level);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectOLEData(unsigned id, unsigned level, const librevenge::RVNGBinaryData &oleData)
+{
+  record([=](auto *collector)
+  {
+    collector->collectOLEData(id, level, oleData);
+  }, oleData.size());
+}
+
+void libvisio::VSDRecordingCollector::collectEllipse(unsigned id, unsigned level, double cx, double cy, double xleft, double yleft, double xtop, double ytop)
+{
+  record([=](auto *collector)
+  {
+    collector->collectEllipse(id, level, cx, cy, xleft, yleft, xtop, ytop);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectLine(unsigned level, const std::optional<double> &strokeWidth, const std::optional<Colour> &c, const std::optional<unsigned char> &linePattern,
+                                                  const std::optional<unsigned char> &startMarker, const std::optional<unsigned char> &endMarker,
+                                                  const std::optional<unsigned char> &lineCap, const std::optional<double> &rounding,
+                                                  const std::optional<long> &qsLineColour, const std::optional<long> &qsLineMatrix)
+{
+  record([=](auto *collector)
+  {
+    collector->collectLine(level, strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, qsLineColour, qsLineMatrix);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectFillAndShadow(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                                                           const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                                                           const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                                                           const std::optional<Colour> &shfgc, const std::optional<double> &shadowOffsetX, const std::optional<double> &shadowOffsetY,
+                                                           const std::optional<long> &qsFc, const std::optional<long> &qsSc, const std::optional<long> &qsLm)
+{
+  record([=](auto *collector)
+  {
+    collector->collectFillAndShadow(level, colourFG, colourBG, fillPattern, fillFGTransparency, fillBGTransparency, shadowPattern, shfgc,
+                                    shadowOffsetX, shadowOffsetY, qsFc, qsSc, qsLm);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectFillAndShadow(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                                                           const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                                                           const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                                                           const std::optional<Colour> &shfgc)
+{
+  record([=](auto *collector)
+  {
+    collector->collectFillAndShadow(level, colourFG, colourBG, fillPattern, fillFGTransparency, fillBGTransparency, shadowPattern, shfgc);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectGeometry(unsigned id, unsigned level, bool noFill, bool noLine, bool noShow)
+{
+  record([=](auto *collector)
+  {
+    collector->collectGeometry(id, level, noFill, noLine, noShow);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectMoveTo(unsigned id, unsigned level, double x, double y)
+{
+  record([=](auto *collector)
+  {
+    collector->collectMoveTo(id, level, x, y);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectLineTo(unsigned id, unsigned level, double x, double y)
+{
+  record([=](auto *collector)
+  {
+    collector->collectLineTo(id, level, x, y);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectArcTo(unsigned id, unsigned level, double x2, double y2, double bow)
+{
+  record([=](auto *collector)
+  {
+    collector->collectArcTo(id, level, x2, y2, bow);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectNURBSTo(unsigned id, unsigned level, double x2, double y2, unsigned char xType, unsigned char yType, unsigned degree,
+                                                     const std::vector<std::pair<double, double> > &ctrlPnts, const std::vector<double> &kntVec, const std::vector<double> &weights)
+{
+  record([=](auto *collector)
+  {
+    collector->collectNURBSTo(id, level, x2, y2, xType, yType, degree, ctrlPnts, kntVec, weights);
+  }, _getSize(ctrlPnts) + _getSize(kntVec) + _getSize(weights));
+}
+
+void libvisio::VSDRecordingCollector::collectNURBSTo(unsigned id, unsigned level, double x2, double y2, double knot, double knotPrev, double weight, double weightPrev, unsigned dataID)
+{
+  record([=](auto *collector)
+  {
+    collector->collectNURBSTo(id, level, x2, y2, knot, knotPrev, weight, weightPrev, dataID);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectNURBSTo(unsigned id, unsigned level, double x2, double y2, double knot, double knotPrev, double weight, double weightPrev, const NURBSData &data)
+{
+  record([=](auto *collector)
+  {
+    collector->collectNURBSTo(id, level, x2, y2, knot, knotPrev, weight, weightPrev, data);
+  }, _getSize(data.points) + _getSize(data.knots) + _getSize(data.weights));
+}
+
+void libvisio::VSDRecordingCollector::collectPolylineTo(unsigned id, unsigned level, double x, double y, unsigned char xType, unsigned char yType, const std::vector<std::pair<double, double> > &points)
+{
+  record([=](auto *collector)
+  {
+    collector->collectPolylineTo(id, level, x, y, xType, yType, points);
+  }, _getSize(points));
+}
+
+void libvisio::VSDRecordingCollector::collectPolylineTo(unsigned id, unsigned level, double x, double y, unsigned dataID)
+{
+  record([=](auto *collector)
+  {
+    collector->collectPolylineTo(id, level, x, y, dataID);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectPolylineTo(unsigned id, unsigned level, double x, double y, const PolylineData &data)
+{
+  record([=](auto *collector)
+  {
+    collector->collectPolylineTo(id, level, x, y, data);
+  }, _getSize(data.points));
+}
+
+void libvisio::VSDRecordingCollector::collectShapeData(unsigned id, unsigned level, unsigned char xType, unsigned char yType, unsigned degree, double lastKnot,
+                                                       std::vector<std::pair<double, double> > controlPoints, std::vector<double> knotVector, std::vector<double> weights)
+{
+  record([=](auto *collector)
+  {
+    collector->collectShapeData(id, level, xType, yType, degree, lastKnot, controlPoints, knotVector, weights);
+  }, _getSize(controlPoints) + _getSize(knotVector) + _getSize(weights));
+}
+
+void libvisio::VSDRecordingCollector::collectShapeData(unsigned id, unsigned level, unsigned char xType, unsigned char yType, std::vector<std::pair<double, double> > points)
+{
+  record([=](auto *collector)
+  {
+    collector->collectShapeData(id, level, xType, yType, points);
+  }, _getSize(points));
+}
+
+void libvisio::VSDRecordingCollector::collectXFormData(unsigned level, const XForm &xform)
+{
+  record([=](auto *collector)
+  {
+    collector->collectXFormData(level, xform);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectTxtXForm(unsigned level, const XForm &txtxform)
+{
+  record([=](auto *collector)
+  {
+    collector->collectTxtXForm(level, txtxform);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectShapesOrder(unsigned id, unsigned level, const std::vector<unsigned> &shapeIds)
+{
+  record([=](auto *collector)
+  {
+    collector->collectShapesOrder(id, level, shapeIds);
+  }, _getSize(shapeIds));
+}
+
+void libvisio::VSDRecordingCollector::collectForeignDataType(unsigned level, unsigned foreignType, unsigned foreignFormat, double offsetX, double offsetY, double width, double height)
+{
+  record([=](auto *collector)
+  {
+    collector->collectForeignDataType(level, foreignType, foreignFormat, offsetX, offsetY, width, height);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectPageProps(unsigned id, unsigned level, double pageWidth, double pageHeight, double shadowOffsetX, double shadowOffsetY, double scale,
+                                                       unsigned char drawingScaleUnit, const std::optional<unsigned> variationColorIndex, const std::optional<unsigned> variationStyleIndex)
+{
+  record([=](auto *collector)
+  {
+    collector->collectPageProps(id, level, pageWidth, pageHeight, shadowOffsetX, shadowOffsetY, scale, drawingScaleUnit, variationColorIndex,
+                                variationStyleIndex);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectPage(unsigned id, unsigned level, unsigned backgroundPageID, bool isBackgroundPage, const VSDName &pageName)
+{
+  record([=](auto *collector)
+  {
+    collector->collectPage(id, level, backgroundPageID, isBackgroundPage, pageName);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectShape(unsigned id, unsigned level, unsigned parent, unsigned masterPage, unsigned masterShape, unsigned lineStyle, unsigned fillStyle, unsigned textStyle, const VSDName &aShapeType)
+{
+  record([=](auto *collector)
+  {
+    collector->collectShape(id, level, parent, masterPage, masterShape, lineStyle, fillStyle, textStyle, aShapeType);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectSplineStart(unsigned id, unsigned level, double x, double y, double secondKnot, double firstKnot, double lastKnot, unsigned degree)
+{
+  record([=](auto *collector)
+  {
+    collector->collectSplineStart(id, level, x, y, secondKnot, firstKnot, lastKnot, degree);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectSplineKnot(unsigned id, unsigned level, double x, double y, double knot)
+{
+  record([=](auto *collector)
+  {
+    collector->collectSplineKnot(id, level, x, y, knot);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectSplineEnd()
+{
+  record([=](auto *collector)
+  {
+    collector->collectSplineEnd();
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectInfiniteLine(unsigned id, unsigned level, double x1, double y1, double x2, double y2)
+{
+  record([=](auto *collector)
+  {
+    collector->collectInfiniteLine(id, level, x1, y1, x2, y2);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectRelCubBezTo(unsigned id, unsigned level, double x, double y, double a, double b, double c, double d)
+{
+  record([=](auto *collector)
+  {
+    collector->collectRelCubBezTo(id, level, x, y, a, b, c, d);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectRelEllipticalArcTo(unsigned id, unsigned level, double x, double y, double a, double b, double c, double d)
+{
+  record([=](auto *collector)
+  {
+    collector->collectRelEllipticalArcTo(id, level, x, y, a, b, c, d);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectRelLineTo(unsigned id, unsigned level, double x, double y)
+{
+  record([=](auto *collector)
+  {
+    collector->collectRelLineTo(id, level, x, y);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectRelMoveTo(unsigned id, unsigned level, double x, double y)
+{
+  record([=](auto *collector)
+  {
+    collector->collectRelMoveTo(id, level, x, y);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectRelQuadBezTo(unsigned id, unsigned level, double x, double y, double a, double b)
+{
+  record([=](auto *collector)
+  {
+    collector->collectRelQuadBezTo(id, level, x, y, a, b);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectUnhandledChunk(unsigned id, unsigned level)
+{
+  record([=](auto *collector)
+  {
+    collector->collectUnhandledChunk(id, level);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectText(unsigned level, const librevenge::RVNGBinaryData &textStream, TextFormat format)
+{
+  record([=](auto *collector)
+  {
+    collector->collectText(level, textStream, format);
+  }, textStream.size());
+}
+
+void libvisio::VSDRecordingCollector::collectCharIX(unsigned id, unsigned level, unsigned charCount, const std::optional<VSDName> &font,
+                                                    const std::optional<Colour> &fontColour, const std::optional<double> &fontSize, const std::optional<bool> &bold,
+                                                    const std::optional<bool> &italic, const std::optional<bool> &underline, const std::optional<bool> &doubleunderline,
+                                                    const std::optional<bool> &strikeout, const std::optional<bool> &doublestrikeout, const std::optional<bool> &allcaps,
+                                                    const std::optional<bool> &initcaps, const std::optional<bool> &smallcaps, const std::optional<bool> &superscript,
+                                                    const std::optional<bool> &subscript, const std::optional<double> &scaleWidth)
+{
+  record([=](auto *collector)
+  {
+    collector->collectCharIX(id, level, charCount, font, fontColour, fontSize, bold, italic, underline, doubleunderline, strikeout, doublestrikeout,
+                             allcaps, initcaps, smallcaps, superscript, subscript, scaleWidth);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectDefaultCharStyle(unsigned charCount, const std::optional<VSDName> &font, const std::optional<Colour> &fontColour,
+                                                              const std::optional<double> &fontSize, const std::optional<bool> &bold, const std::optional<bool> &italic,
+                                                              const std::optional<bool> &underline, const std::optional<bool> &doubleunderline, const std::optional<bool> &strikeout,
+                                                              const std::optional<bool> &doublestrikeout, const std::optional<bool> &allcaps, const std::optional<bool> &initcaps,
+                                                              const std::optional<bool> &smallcaps, const std::optional<bool> &superscript, const std::optional<bool> &subscript,
+                                                              const std::optional<double> &scaleWidth)
+{
+  record([=](auto *collector)
+  {
+    collector->collectDefaultCharStyle(charCount, font, fontColour, fontSize, bold, italic, underline, doubleunderline, strikeout, doublestrikeout,
+                                       allcaps, initcaps, smallcaps, superscript, subscript, scaleWidth);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectParaIX(unsigned id, unsigned level, unsigned charCount, const std::optional<double> &indFirst,
+                                                    const std::optional<double> &indLeft, const std::optional<double> &indRight, const std::optional<double> &spLine,
+                                                    const std::optional<double> &spBefore, const std::optional<double> &spAfter, const std::optional<unsigned char> &align,
+                                                    const std::optional<unsigned char> &bullet, const std::optional<VSDName> &bulletStr,
+                                                    const std::optional<VSDName> &bulletFont, const std::optional<double> &bulletFontSize,
+                                                    const std::optional<double> &textPosAfterBullet, const std::optional<unsigned> &flags)
+{
+  record([=](auto *collector)
+  {
+    collector->collectParaIX(id, level, charCount, indFirst, indLeft, indRight, spLine, spBefore, spAfter, align, bullet, bulletStr, bulletFont,
+                             bulletFontSize, textPosAfterBullet, flags);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectDefaultParaStyle(unsigned charCount, const std::optional<double> &indFirst, const std::optional<double> &indLeft,
+                                                              const std::optional<double> &indRight, const std::optional<double> &spLine, const std::optional<double> &spBefore,
+                                                              const std::optional<double> &spAfter, const std::optional<unsigned char> &align,
+                                                              const std::optional<unsigned char> &bullet, const std::optional<VSDName> &bulletStr,
+                                                              const std::optional<VSDName> &bulletFont, const std::optional<double> &bulletFontSize,
+                                                              const std::optional<double> &textPosAfterBullet, const std::optional<unsigned> &flags)
+{
+  record([=](auto *collector)
+  {
+    collector->collectDefaultParaStyle(charCount, indFirst, indLeft, indRight, spLine, spBefore, spAfter, align, bullet, bulletStr, bulletFont,
+                                       bulletFontSize, textPosAfterBullet, flags);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectTextBlock(unsigned level, const std::optional<double> &leftMargin, const std::optional<double> &rightMargin,
+                                                       const std::optional<double> &topMargin, const std::optional<double> &bottomMargin,
+                                                       const std::optional<unsigned char> &verticalAlign, const std::optional<bool> &isBgFilled,
+                                                       const std::optional<Colour> &bgColour, const std::optional<double> &defaultTabStop,
+                                                       const std::optional<unsigned char> &textDirection)
+{
+  record([=](auto *collector)
+  {
+    collector->collectTextBlock(level, leftMargin, rightMargin, topMargin, bottomMargin, verticalAlign, isBgFilled, bgColour, defaultTabStop,
+                                textDirection);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectNameList(unsigned id, unsigned level)
+{
+  record([=](auto *collector)
+  {
+    collector->collectNameList(id, level);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectName(unsigned id, unsigned level,  const librevenge::RVNGBinaryData &name, TextFormat format)
+{
+  record([=](auto *collector)
+  {
+    collector->collectName(id, level, name, format);
+  }, name.size());
+}
+
+void libvisio::VSDRecordingCollector::collectPageSheet(unsigned id, unsigned level)
+{
+  record([=](auto *collector)
+  {
+    collector->collectPageSheet(id, level);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectMisc(unsigned level, const VSDMisc &misc)
+{
+  record([=](auto *collector)
+  {
+    collector->collectMisc(level, misc);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectLayer(unsigned id, unsigned level, const VSDLayer &layer)
+{
+  record([=](auto *collector)
+  {
+    collector->collectLayer(id, level, layer);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectLayerMem(unsigned level, const VSDName &layerMem)
+{
+  record([=](auto *collector)
+  {
+    collector->collectLayerMem(level, layerMem);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectTabsDataList(unsigned level, const std::map<unsigned, VSDTabSet> &tabSets)
+{
+  record([=](auto *collector)
+  {
+    collector->collectTabsDataList(level, tabSets);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectStyleSheet(unsigned id, unsigned level,unsigned parentLineStyle, unsigned parentFillStyle, unsigned parentTextStyle)
+{
+  record([=](auto *collector)
+  {
+    collector->collectStyleSheet(id, level, parentLineStyle, parentFillStyle, parentTextStyle);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectLineStyle(unsigned level, const std::optional<double> &strokeWidth, const std::optional<Colour> &c, const std::optional<unsigned char> &linePattern,
+                                                       const std::optional<unsigned char> &startMarker, const std::optional<unsigned char> &endMarker,
+                                                       const std::optional<unsigned char> &lineCap, const std::optional<double> &rounding,
+                                                       const std::optional<long> &qsLineColour, const std::optional<long> &qsLineMatrix)
+{
+  record([=](auto *collector)
+  {
+    collector->collectLineStyle(level, strokeWidth, c, linePattern, startMarker, endMarker, lineCap, rounding, qsLineColour, qsLineMatrix);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectFillStyle(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                                                       const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                                                       const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                                                       const std::optional<Colour> &shfgc, const std::optional<double> &shadowOffsetX, const std::optional<double> &shadowOffsetY,
+                                                       const std::optional<long> &qsFillColour, const std::optional<long> &qsShadowColour,
+                                                       const std::optional<long> &qsFillMatrix)
+{
+  record([=](auto *collector)
+  {
+    collector->collectFillStyle(level, colourFG, colourBG, fillPattern, fillFGTransparency, fillBGTransparency, shadowPattern, shfgc, shadowOffsetX,
+                                shadowOffsetY, qsFillColour, qsShadowColour, qsFillMatrix);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectFillStyle(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                                                       const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                                                       const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                                                       const std::optional<Colour> &shfgc)
+{
+  record([=](auto *collector)
+  {
+    collector->collectFillStyle(level, colourFG, colourBG, fillPattern, fillFGTransparency, fillBGTransparency, shadowPattern, shfgc);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectCharIXStyle(unsigned id, unsigned level, unsigned charCount, const std::optional<VSDName> &font,
+                                                         const std::optional<Colour> &fontColour, const std::optional<double> &fontSize, const std::optional<bool> &bold,
+                                                         const std::optional<bool> &italic, const std::optional<bool> &underline, const std::optional<bool> &doubleunderline,
+                                                         const std::optional<bool> &strikeout, const std::optional<bool> &doublestrikeout, const std::optional<bool> &allcaps,
+                                                         const std::optional<bool> &initcaps, const std::optional<bool> &smallcaps, const std::optional<bool> &superscript,
+                                                         const std::optional<bool> &subscript, const std::optional<double> &scaleWidth)
+{
+  record([=](auto *collector)
+  {
+    collector->collectCharIXStyle(id, level, charCount, font, fontColour, fontSize, bold, italic, underline, doubleunderline, strikeout,
+                                  doublestrikeout, allcaps, initcaps, smallcaps, superscript, subscript, scaleWidth);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectParaIXStyle(unsigned id, unsigned level, unsigned charCount, const std::optional<double> &indFirst,
+                                                         const std::optional<double> &indLeft, const std::optional<double> &indRight, const std::optional<double> &spLine,
+                                                         const std::optional<double> &spBefore, const std::optional<double> &spAfter, const std::optional<unsigned char> &align,
+                                                         const std::optional<unsigned char> &bullet, const std::optional<VSDName> &bulletStr,
+                                                         const std::optional<VSDName> &bulletFont, const std::optional<double> &bulletFontSize,
+                                                         const std::optional<double> &textPosAfterBullet, const std::optional<unsigned> &flags)
+{
+  record([=](auto *collector)
+  {
+    collector->collectParaIXStyle(id, level, charCount, indFirst, indLeft, indRight, spLine, spBefore, spAfter, align, bullet, bulletStr, bulletFont,
+                                  bulletFontSize, textPosAfterBullet, flags);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectTextBlockStyle(unsigned level, const std::optional<double> &leftMargin, const std::optional<double> &rightMargin,
+                                                            const std::optional<double> &topMargin, const std::optional<double> &bottomMargin,
+                                                            const std::optional<unsigned char> &verticalAlign, const std::optional<bool> &isBgFilled,
+                                                            const std::optional<Colour> &bgColour, const std::optional<double> &defaultTabStop,
+                                                            const std::optional<unsigned char> &textDirection)
+{
+  record([=](auto *collector)
+  {
+    collector->collectTextBlockStyle(level, leftMargin, rightMargin, topMargin, bottomMargin, verticalAlign, isBgFilled, bgColour, defaultTabStop,
+                                     textDirection);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectFieldList(unsigned id, unsigned level)
+{
+  record([=](auto *collector)
+  {
+    collector->collectFieldList(id, level);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectTextField(unsigned id, unsigned level, int nameId, int formatStringId)
+{
+  record([=](auto *collector)
+  {
+    collector->collectTextField(id, level, nameId, formatStringId);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectNumericField(unsigned id, unsigned level, unsigned short format, unsigned short cellType, double number, int formatStringId)
+{
+  record([=](auto *collector)
+  {
+    collector->collectNumericField(id, level, format, cellType, number, formatStringId);
+  });
+}
+
+void libvisio::VSDRecordingCollector::collectMetaData(const librevenge::RVNGPropertyList &metaData)
+{
+  record([=](auto *collector)
+  {
+    collector->collectMetaData(metaData);
+  });
+}
+
+void libvisio::VSDRecordingCollector::startPage(unsigned pageId)
+{
+  ++m_pageCount;
+  if (!m_isDiscarded)
+  {
+    if (m_isPageStarted)
+      m_arePagesSeparate = false;
+    m_pageCalls.push_back(std::make_pair(m_calls.size(), m_calls.size()));
+    m_isPageStarted = true;
+  }
+  record([=](auto *collector)
+  {
+    collector->startPage(pageId);
+  });
+}
+
+void libvisio::VSDRecordingCollector::endPage()
+{
+  record([=](auto *collector)
+  {
+    collector->endPage();
+  });
+  if (!m_isDiscarded && m_isPageStarted)
+  {
+    m_pageCalls.back().second = m_calls.size();
+    m_isPageStarted = false;
+  }
+}
+
+void libvisio::VSDRecordingCollector::endPages()
+{
+  record([=](auto *collector)
+  {
+    collector->endPages();
+  });
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
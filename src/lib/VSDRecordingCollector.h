@@ -0,0 +1,233 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef VSDRECORDINGCOLLECTOR_H
+#define VSDRECORDINGCOLLECTOR_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "VSDCollector.h"
+
+#define VSD_RECORDING_DEFAULT_SIZE (256UL * 1024UL * 1024UL)
+
+namespace libvisio
+{
+
+class VSDContentCollector;
+class VSDPages;
+class VSDStylesCollector;
+
+// Passes every call on to the styles collector straight away and keeps a
+// record of it, so that the calls can be replayed into the content collector
+// later without parsing the document again. Both ends are concrete types, so
+// the recorded calls do not go through the vtable. A record that grows past
+// its size ceiling is discarded, and the document has to be parsed again.
+class VSDRecordingCollector final : public VSDCollector
+{
+public:
+  explicit VSDRecordingCollector(VSDStylesCollector *collector, unsigned long maxSize = VSD_RECORDING_DEFAULT_SIZE);
+  ~VSDRecordingCollector() override;
+
+  void collectDocumentTheme(const VSDXTheme *theme) override;
+  void collectEllipticalArcTo(unsigned id, unsigned level, double x3, double y3, double x2, double y2, double angle, double ecc) override;
+  void collectForeignData(unsigned level, const librevenge::RVNGBinaryData &binaryData) override;
+  void collectOLEList(unsigned id, unsigned level) override;
+  void collectOLEData(unsigned id, unsigned level, const librevenge::RVNGBinaryData &oleData) override;
+  void collectEllipse(unsigned id, unsigned level, double cx, double cy, double xleft, double yleft, double xtop, double ytop) override;
+  void collectLine(unsigned level, const std::optional<double> &strokeWidth, const std::optional<Colour> &c, const std::optional<unsigned char> &linePattern,
+                   const std::optional<unsigned char> &startMarker, const std::optional<unsigned char> &endMarker,
+                   const std::optional<unsigned char> &lineCap, const std::optional<double> &rounding,
+                   const std::optional<long> &qsLineColour, const std::optional<long> &qsLineMatrix) override;
+  void collectFillAndShadow(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                            const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                            const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                            const std::optional<Colour> &shfgc, const std::optional<double> &shadowOffsetX, const std::optional<double> &shadowOffsetY,
+                            const std::optional<long> &qsFc, const std::optional<long> &qsSc, const std::optional<long> &qsLm) override;
+  void collectFillAndShadow(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                            const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                            const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                            const std::optional<Colour> &shfgc) override;
+  void collectGeometry(unsigned id, unsigned level, bool noFill, bool noLine, bool noShow) override;
+  void collectMoveTo(unsigned id, unsigned level, double x, double y) override;
+  void collectLineTo(unsigned id, unsigned level, double x, double y) override;
+  void collectArcTo(unsigned id, unsigned level, double x2, double y2, double bow) override;
+  void collectNURBSTo(unsigned id, unsigned level, double x2, double y2, unsigned char xType, unsigned char yType, unsigned degree,
+                      const std::vector<std::pair<double, double> > &ctrlPnts, const std::vector<double> &kntVec, const std::vector<double> &weights) override;
+  void collectNURBSTo(unsigned id, unsigned level, double x2, double y2, double knot, double knotPrev, double weight, double weightPrev, unsigned dataID) override;
+  void collectNURBSTo(unsigned id, unsigned level, double x2, double y2, double knot, double knotPrev, double weight, double weightPrev, const NURBSData &data) override;
+  void collectPolylineTo(unsigned id, unsigned level, double x, double y, unsigned char xType, unsigned char yType, const std::vector<std::pair<double, double> > &points) override;
+  void collectPolylineTo(unsigned id, unsigned level, double x, double y, unsigned dataID) override;
+  void collectPolylineTo(unsigned id, unsigned level, double x, double y, const PolylineData &data) override;
+  void collectShapeData(unsigned id, unsigned level, unsigned char xType, unsigned char yType, unsigned degree, double lastKnot,
+                        std::vector<std::pair<double, double> > controlPoints, std::vector<double> knotVector, std::vector<double> weights) override;
+  void collectShapeData(unsigned id, unsigned level, unsigned char xType, unsigned char yType, std::vector<std::pair<double, double> > points) override;
+  void collectXFormData(unsigned level, const XForm &xform) override;
+  void collectTxtXForm(unsigned level, const XForm &txtxform) override;
+  void collectShapesOrder(unsigned id, unsigned level, const std::vector<unsigned> &shapeIds) override;
+  void collectForeignDataType(unsigned level, unsigned foreignType, unsigned foreignFormat, double offsetX, double offsetY, double width, double height) override;
+  void collectPageProps(unsigned id, unsigned level, double pageWidth, double pageHeight, double shadowOffsetX, double shadowOffsetY, double scale,
+                        unsigned char drawingScaleUnit, const std::optional<unsigned> variationColorIndex, const std::optional<unsigned> variationStyleIndex) override;
+  void collectPage(unsigned id, unsigned level, unsigned backgroundPageID, bool isBackgroundPage, const VSDName &pageName) override;
+  void collectShape(unsigned id, unsigned level, unsigned parent, unsigned masterPage, unsigned masterShape, unsigned lineStyle, unsigned fillStyle, unsigned textStyle, const VSDName &aShapeType) override;
+  void collectSplineStart(unsigned id, unsigned level, double x, double y, double secondKnot, double firstKnot, double lastKnot, unsigned degree) override;
+  void collectSplineKnot(unsigned id, unsigned level, double x, double y, double knot) override;
+  void collectSplineEnd() override;
+  void collectInfiniteLine(unsigned id, unsigned level, double x1, double y1, double x2, double y2) override;
+  void collectRelCubBezTo(unsigned id, unsigned level, double x, double y, double a, double b, double c, double d) override;
+  void collectRelEllipticalArcTo(unsigned id, unsigned level, double x, double y, double a, double b, double c, double d) override;
+  void collectRelLineTo(unsigned id, unsigned level, double x, double y) override;
+  void collectRelMoveTo(unsigned id, unsigned level, double x, double y) override;
+  void collectRelQuadBezTo(unsigned id, unsigned level, double x, double y, double a, double b) override;
+
+  void collectUnhandledChunk(unsigned id, unsigned level) override;
+
+  void collectText(unsigned level, const librevenge::RVNGBinaryData &textStream, TextFormat format) override;
+  void collectCharIX(unsigned id, unsigned level, unsigned charCount, const std::optional<VSDName> &font,
+                     const std::optional<Colour> &fontColour, const std::optional<double> &fontSize, const std::optional<bool> &bold,
+                     const std::optional<bool> &italic, const std::optional<bool> &underline, const std::optional<bool> &doubleunderline,
+                     const std::optional<bool> &strikeout, const std::optional<bool> &doublestrikeout, const std::optional<bool> &allcaps,
+                     const std::optional<bool> &initcaps, const std::optional<bool> &smallcaps, const std::optional<bool> &superscript,
+                     const std::optional<bool> &subscript, const std::optional<double> &scaleWidth) override;
+  void collectDefaultCharStyle(unsigned charCount, const std::optional<VSDName> &font, const std::optional<Colour> &fontColour,
+                               const std::optional<double> &fontSize, const std::optional<bool> &bold, const std::optional<bool> &italic,
+                               const std::optional<bool> &underline, const std::optional<bool> &doubleunderline, const std::optional<bool> &strikeout,
+                               const std::optional<bool> &doublestrikeout, const std::optional<bool> &allcaps, const std::optional<bool> &initcaps,
+                               const std::optional<bool> &smallcaps, const std::optional<bool> &superscript, const std::optional<bool> &subscript,
+                               const std::optional<double> &scaleWidth) override;
+  void collectParaIX(unsigned id, unsigned level, unsigned charCount, const std::optional<double> &indFirst,
+                     const std::optional<double> &indLeft, const std::optional<double> &indRight, const std::optional<double> &spLine,
+                     const std::optional<double> &spBefore, const std::optional<double> &spAfter, const std::optional<unsigned char> &align,
+                     const std::optional<unsigned char> &bullet, const std::optional<VSDName> &bulletStr,
+                     const std::optional<VSDName> &bulletFont, const std::optional<double> &bulletFontSize,
+                     const std::optional<double> &textPosAfterBullet, const std::optional<unsigned> &flags) override;
+  void collectDefaultParaStyle(unsigned charCount, const std::optional<double> &indFirst, const std::optional<double> &indLeft,
+                               const std::optional<double> &indRight, const std::optional<double> &spLine, const std::optional<double> &spBefore,
+                               const std::optional<double> &spAfter, const std::optional<unsigned char> &align,
+                               const std::optional<unsigned char> &bullet, const std::optional<VSDName> &bulletStr,
+                               const std::optional<VSDName> &bulletFont, const std::optional<double> &bulletFontSize,
+                               const std::optional<double> &textPosAfterBullet, const std::optional<unsigned> &flags) override;
+  void collectTextBlock(unsigned level, const std::optional<double> &leftMargin, const std::optional<double> &rightMargin,
+                        const std::optional<double> &topMargin, const std::optional<double> &bottomMargin,
+                        const std::optional<unsigned char> &verticalAlign, const std::optional<bool> &isBgFilled,
+                        const std::optional<Colour> &bgColour, const std::optional<double> &defaultTabStop,
+                        const std::optional<unsigned char> &textDirection) override;
+  void collectNameList(unsigned id, unsigned level) override;
+  void collectName(unsigned id, unsigned level,  const librevenge::RVNGBinaryData &name, TextFormat format) override;
+  void collectPageSheet(unsigned id, unsigned level) override;
+  void collectMisc(unsigned level, const VSDMisc &misc) override;
+  void collectLayer(unsigned id, unsigned level, const VSDLayer &layer) override;
+  void collectLayerMem(unsigned level, const VSDName &layerMem) override;
+  void collectTabsDataList(unsigned level, const std::map<unsigned, VSDTabSet> &tabSets) override;
+
+  // Style collectors
+  void collectStyleSheet(unsigned id, unsigned level,unsigned parentLineStyle, unsigned parentFillStyle, unsigned parentTextStyle) override;
+  void collectLineStyle(unsigned level, const std::optional<double> &strokeWidth, const std::optional<Colour> &c, const std::optional<unsigned char> &linePattern,
+                        const std::optional<unsigned char> &startMarker, const std::optional<unsigned char> &endMarker,
+                        const std::optional<unsigned char> &lineCap, const std::optional<double> &rounding,
+                        const std::optional<long> &qsLineColour, const std::optional<long> &qsLineMatrix) override;
+  void collectFillStyle(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                        const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                        const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                        const std::optional<Colour> &shfgc, const std::optional<double> &shadowOffsetX, const std::optional<double> &shadowOffsetY,
+                        const std::optional<long> &qsFillColour, const std::optional<long> &qsShadowColour,
+                        const std::optional<long> &qsFillMatrix) override;
+  void collectFillStyle(unsigned level, const std::optional<Colour> &colourFG, const std::optional<Colour> &colourBG,
+                        const std::optional<unsigned char> &fillPattern, const std::optional<double> &fillFGTransparency,
+                        const std::optional<double> &fillBGTransparency, const std::optional<unsigned char> &shadowPattern,
+                        const std::optional<Colour> &shfgc) override;
+  void collectCharIXStyle(unsigned id, unsigned level, unsigned charCount, const std::optional<VSDName> &font,
+                          const std::optional<Colour> &fontColour, const std::optional<double> &fontSize, const std::optional<bool> &bold,
+                          const std::optional<bool> &italic, const std::optional<bool> &underline, const std::optional<bool> &doubleunderline,
+                          const std::optional<bool> &strikeout, const std::optional<bool> &doublestrikeout, const std::optional<bool> &allcaps,
+                          const std::optional<bool> &initcaps, const std::optional<bool> &smallcaps, const std::optional<bool> &superscript,
+                          const std::optional<bool> &subscript, const std::optional<double> &scaleWidth) override;
+  void collectParaIXStyle(unsigned id, unsigned level, unsigned charCount, const std::optional<double> &indFirst,
+                          const std::optional<double> &indLeft, const std::optional<double> &indRight, const std::optional<double> &spLine,
+                          const std::optional<double> &spBefore, const std::optional<double> &spAfter, const std::optional<unsigned char> &align,
+                          const std::optional<unsigned char> &bullet, const std::optional<VSDName> &bulletStr,
+                          const std::optional<VSDName> &bulletFont, const std::optional<double> &bulletFontSize,
+                          const std::optional<double> &textPosAfterBullet, const std::optional<unsigned> &flags) override;
+  void collectTextBlockStyle(unsigned level, const std::optional<double> &leftMargin, const std::optional<double> &rightMargin,
+                             const std::optional<double> &topMargin, const std::optional<double> &bottomMargin,
+                             const std::optional<unsigned char> &verticalAlign, const std::optional<bool> &isBgFilled,
+                             const std::optional<Colour> &bgColour, const std::optional<double> &defaultTabStop,
+                             const std::optional<unsigned char> &textDirection) override;
+
+  // Field list
+  void collectFieldList(unsigned id, unsigned level) override;
+  void collectTextField(unsigned id, unsigned level, int nameId, int formatStringId) override;
+  void collectNumericField(unsigned id, unsigned level, unsigned short format, unsigned short cellType, double number, int formatStringId) override;
+
+  // Metadata
+  void collectMetaData(const librevenge::RVNGPropertyList &metaData) override;
+
+  // Temporary hack
+  void startPage(unsigned pageId) override;
+  void endPage() override;
+  void endPages() override;
+
+  // Calls recorded after mark() can be dropped again by rewind(). Used for
+  // the parts of the document that a 2nd pass would not parse.
+  void mark();
+  void rewind();
+  // Throws the record away. Used when the recorded calls would differ from
+  // what a second parse of the document produces.
+  void discard();
+  bool isDiscarded() const
+  {
+    return m_isDiscarded;
+  }
+  unsigned getPageCount() const
+  {
+    return m_pageCount;
+  }
+  void replay(VSDContentCollector *collector) const;
+  typedef std::function<std::unique_ptr<VSDContentCollector> ()> ContentCollectorFactory_t;
+  // Collects the pages on up to threadCount threads, each with its own collector,
+  // and passes them on to collector in document order
+  void replay(VSDContentCollector *collector, const ContentCollectorFactory_t &createCollector, unsigned threadCount) const;
+
+private:
+  VSDRecordingCollector(const VSDRecordingCollector &);
+  VSDRecordingCollector &operator=(const VSDRecordingCollector &);
+
+  template<typename C>
+  void record(const C &call, std::size_t dataSize = 0);
+  template<typename T>
+  static std::size_t _getSize(const std::vector<T> &data)
+  {
+    return data.size() * sizeof(T);
+  }
+  void _replayPages(const ContentCollectorFactory_t &createCollector, std::size_t first, std::size_t last,
+                    std::vector<VSDPages> &pages, std::vector<std::exception_ptr> &errors) const;
+
+  VSDStylesCollector *m_collector;
+  std::vector<std::function<void (VSDContentCollector *)> > m_calls;
+  std::size_t m_mark;
+  // Estimated memory taken by the calls, in total and before the mark
+  unsigned long m_size;
+  unsigned long m_markSize;
+  unsigned long m_maxSize;
+  unsigned m_pageCount;
+  bool m_isDiscarded;
+  // Calls from startPage to endPage of each page
+  std::vector<std::pair<std::size_t, std::size_t> > m_pageCalls;
+  bool m_isPageStarted;
+  // Whether every page ended before the next one started
+  bool m_arePagesSeparate;
+};
+
+} // namespace libvisio
+
+#endif /* VSDRECORDINGCOLLECTOR_H */
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,54 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "VSDStreamCache.h"
+
+libvisio::VSDStreamCache::VSDStreamCache(unsigned long maxSize)
+  : m_buffers(), m_size(0), m_maxSize(maxSize)
+{
+}
+
+libvisio::VSDStreamCache::~VSDStreamCache()
+{
+}
+
+libvisio::VSDStreamCache::Buffer_t libvisio::VSDStreamCache::find(unsigned offset, unsigned length, unsigned short format) const
+{
+  auto iter = m_buffers.find(Key_t(offset, length, format));
+  if (iter != m_buffers.end())
+    return iter->second;
+  return Buffer_t();
+}
+
+bool libvisio::VSDStreamCache::insert(unsigned offset, unsigned length, unsigned short format, const Buffer_t &buffer)
+{
+  if (!buffer)
+    return false;
+  if (buffer->size() > m_maxSize || m_size > m_maxSize - buffer->size())
+    return false;
+  if (!m_buffers.insert(std::make_pair(Key_t(offset, length, format), buffer)).second)
+    return false;
+  m_size += buffer->size();
+  return true;
+}
+
+void libvisio::VSDStreamCache::clear()
+{
+  m_buffers.clear();
+  m_size = 0;
+}
+
+void libvisio::VSDStreamCache::setMaxSize(unsigned long maxSize)
+{
+  m_maxSize = maxSize;
+  if (m_size > m_maxSize)
+    clear();
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
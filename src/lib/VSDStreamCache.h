@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __VSDSTREAMCACHE_H__
+#define __VSDSTREAMCACHE_H__
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#define VSD_STREAM_CACHE_DEFAULT_SIZE (256UL * 1024UL * 1024UL)
+
+namespace libvisio
+{
+
+// Decompressed pointer streams of one document, keyed by the pointer's offset,
+// length and format. Streams that do not fit under the size ceiling are not
+// cached and have to be decompressed on demand.
+class VSDStreamCache
+{
+public:
+  typedef std::shared_ptr<const std::vector<unsigned char> > Buffer_t;
+
+  explicit VSDStreamCache(unsigned long maxSize = VSD_STREAM_CACHE_DEFAULT_SIZE);
+  ~VSDStreamCache();
+
+  Buffer_t find(unsigned offset, unsigned length, unsigned short format) const;
+  bool insert(unsigned offset, unsigned length, unsigned short format, const Buffer_t &buffer);
+  void clear();
+
+  void setMaxSize(unsigned long maxSize);
+  unsigned long getMaxSize() const
+  {
+    return m_maxSize;
+  }
+  unsigned long getSize() const
+  {
+    return m_size;
+  }
+
+private:
+  VSDStreamCache(const VSDStreamCache &);
+  VSDStreamCache &operator=(const VSDStreamCache &);
+
+  typedef std::tuple<unsigned, unsigned, unsigned short> Key_t;
+
+  std::map<Key_t, Buffer_t> m_buffers;
+  unsigned long m_size;
+  unsigned long m_maxSize;
+};
+
+} // namespace libvisio
+
+#endif // __VSDSTREAMCACHE_H__
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -11,6 +11,7 @@
 
 #include <set>
 #include <stack>
+#include <utility>
 #include "VSDTypes.h"
 
 namespace libvisio
@@ -51,13 +52,25 @@ T getOptionalStyle(const std::map<unsigned, unsigned> &styleMasters, const std::
   return style;
 }
 
+template<typename T>
+const T &getResolvedStyle(const std::map<unsigned, unsigned> &styleMasters, const std::map<unsigned, T> &styles,
+                          std::map<unsigned, T> &resolvedStyles, const unsigned styleIndex)
+{
+  auto iter = resolvedStyles.lower_bound(styleIndex);
+  if (iter == resolvedStyles.end() || iter->first != styleIndex)
+    iter = resolvedStyles.insert(iter, std::make_pair(styleIndex, getOptionalStyle(styleMasters, styles, styleIndex)));
+  return iter->second;
+}
+
 }
 
 }
 
 libvisio::VSDStyles::VSDStyles() :
   m_lineStyles(), m_fillStyles(), m_textBlockStyles(), m_charStyles(), m_paraStyles(),
-  m_lineStyleMasters(), m_fillStyleMasters(), m_textStyleMasters()
+  m_lineStyleMasters(), m_fillStyleMasters(), m_textStyleMasters(),
+  m_resolvedLineStyles(), m_resolvedFillStyles(), m_resolvedTextBlockStyles(), m_resolvedCharStyles(),
+  m_resolvedParaStyles(), m_themedFillStyles(), m_themedFillStylesTheme(nullptr)
 {
 }
 
@@ -67,74 +80,103 @@ libvisio::VSDStyles::~VSDStyles()
 
 void libvisio::VSDStyles::addLineStyle(unsigned lineStyleIndex, const VSDOptionalLineStyle &lineStyle)
 {
+  _clearCache();
   m_lineStyles[lineStyleIndex] = lineStyle;
 }
 
 void libvisio::VSDStyles::addFillStyle(unsigned fillStyleIndex, const VSDOptionalFillStyle &fillStyle)
 {
+  _clearCache();
   m_fillStyles[fillStyleIndex] = fillStyle;
 }
 
 void libvisio::VSDStyles::addTextBlockStyle(unsigned textStyleIndex, const VSDOptionalTextBlockStyle &textBlockStyle)
 {
+  _clearCache();
   m_textBlockStyles[textStyleIndex] = textBlockStyle;
 }
 
 void libvisio::VSDStyles::addCharStyle(unsigned textStyleIndex, const VSDOptionalCharStyle &charStyle)
 {
+  _clearCache();
   m_charStyles[textStyleIndex] = charStyle;
 }
 
 void libvisio::VSDStyles::addParaStyle(unsigned textStyleIndex, const VSDOptionalParaStyle &paraStyle)
 {
+  _clearCache();
   m_paraStyles[textStyleIndex] = paraStyle;
 }
 
 void libvisio::VSDStyles::addLineStyleMaster(unsigned lineStyleIndex, unsigned lineStyleMaster)
 {
+  _clearCache();
   m_lineStyleMasters[lineStyleIndex] = lineStyleMaster;
 }
 
 void libvisio::VSDStyles::addFillStyleMaster(unsigned fillStyleIndex, unsigned fillStyleMaster)
 {
+  _clearCache();
   m_fillStyleMasters[fillStyleIndex] = fillStyleMaster;
 }
 
 void libvisio::VSDStyles::addTextStyleMaster(unsigned textStyleIndex, unsigned textStyleMaster)
 {
+  _clearCache();
   m_textStyleMasters[textStyleIndex] = textStyleMaster;
 }
 
-libvisio::VSDOptionalLineStyle libvisio::VSDStyles::getOptionalLineStyle(unsigned lineStyleIndex) const
+const libvisio::VSDOptionalLineStyle &libvisio::VSDStyles::getOptionalLineStyle(unsigned lineStyleIndex) const
 {
-  return getOptionalStyle(m_lineStyleMasters, m_lineStyles, lineStyleIndex);
+  return getResolvedStyle(m_lineStyleMasters, m_lineStyles, m_resolvedLineStyles, lineStyleIndex);
 }
 
-libvisio::VSDOptionalFillStyle libvisio::VSDStyles::getOptionalFillStyle(unsigned fillStyleIndex) const
+const libvisio::VSDOptionalFillStyle &libvisio::VSDStyles::getOptionalFillStyle(unsigned fillStyleIndex) const
 {
-  return getOptionalStyle(m_fillStyleMasters, m_fillStyles, fillStyleIndex);
+  return getResolvedStyle(m_fillStyleMasters, m_fillStyles, m_resolvedFillStyles, fillStyleIndex);
+}
+
+const libvisio::VSDFillStyle &libvisio::VSDStyles::getFillStyle(unsigned fillStyleIndex, const libvisio::VSDXTheme *theme) const
+{
+  // Only the styles of one theme are kept
+  if (theme != m_themedFillStylesTheme)
+  {
+    m_themedFillStyles.clear();
+    m_themedFillStylesTheme = theme;
+  }
+  auto iter = m_themedFillStyles.lower_bound(fillStyleIndex);
+  if (iter == m_themedFillStyles.end() || iter->first != fillStyleIndex)
+  {
+    VSDFillStyle fillStyle;
+    fillStyle.override(getOptionalFillStyle(fillStyleIndex), theme);
+    iter = m_themedFillStyles.insert(iter, std::make_pair(fillStyleIndex, fillStyle));
+  }
+  return iter->second;
 }
 
-libvisio::VSDFillStyle libvisio::VSDStyles::getFillStyle(unsigned fillStyleIndex, const libvisio::VSDXTheme *theme) const
+const libvisio::VSDOptionalTextBlockStyle &libvisio::VSDStyles::getOptionalTextBlockStyle(unsigned textStyleIndex) const
 {
-  VSDFillStyle fillStyle;
-  fillStyle.override(getOptionalFillStyle(fillStyleIndex), theme);
-  return fillStyle;
+  return getResolvedStyle(m_textStyleMasters, m_textBlockStyles, m_resolvedTextBlockStyles, textStyleIndex);
 }
 
-libvisio::VSDOptionalTextBlockStyle libvisio::VSDStyles::getOptionalTextBlockStyle(unsigned textStyleIndex) const
+const libvisio::VSDOptionalCharStyle &libvisio::VSDStyles::getOptionalCharStyle(unsigned textStyleIndex) const
 {
-  return getOptionalStyle(m_textStyleMasters, m_textBlockStyles, textStyleIndex);
+  return getResolvedStyle(m_textStyleMasters, m_charStyles, m_resolvedCharStyles, textStyleIndex);
 }
 
-libvisio::VSDOptionalCharStyle libvisio::VSDStyles::getOptionalCharStyle(unsigned textStyleIndex) const
+const libvisio::VSDOptionalParaStyle &libvisio::VSDStyles::getOptionalParaStyle(unsigned textStyleIndex) const
 {
-  return getOptionalStyle(m_textStyleMasters, m_charStyles, textStyleIndex);
+  return getResolvedStyle(m_textStyleMasters, m_paraStyles, m_resolvedParaStyles, textStyleIndex);
 }
 
-libvisio::VSDOptionalParaStyle libvisio::VSDStyles::getOptionalParaStyle(unsigned textStyleIndex) const
+void libvisio::VSDStyles::_clearCache()
 {
-  return getOptionalStyle(m_textStyleMasters, m_paraStyles, textStyleIndex);
+  m_resolvedLineStyles.clear();
+  m_resolvedFillStyles.clear();
+  m_resolvedTextBlockStyles.clear();
+  m_resolvedCharStyles.clear();
+  m_resolvedParaStyles.clear();
+  m_themedFillStyles.clear();
 }
 
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
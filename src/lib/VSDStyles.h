@@ -525,14 +525,18 @@ public:
   void addFillStyleMaster(unsigned fillStyleIndex, unsigned fillStyleMaster);
   void addTextStyleMaster(unsigned textStyleIndex, unsigned textStyleMaster);
 
-  VSDOptionalLineStyle getOptionalLineStyle(unsigned lineStyleIndex) const;
-  VSDFillStyle getFillStyle(unsigned fillStyleIndex, const VSDXTheme *theme) const;
-  VSDOptionalFillStyle getOptionalFillStyle(unsigned fillStyleIndex) const;
-  VSDOptionalTextBlockStyle getOptionalTextBlockStyle(unsigned textStyleIndex) const;
-  VSDOptionalCharStyle getOptionalCharStyle(unsigned textStyleIndex) const;
-  VSDOptionalParaStyle getOptionalParaStyle(unsigned textStyleIndex) const;
+  // The returned references stay valid until the next style or style master is added.
+  // Those of getFillStyle also end with a call for another theme.
+  const VSDOptionalLineStyle &getOptionalLineStyle(unsigned lineStyleIndex) const;
+  const VSDFillStyle &getFillStyle(unsigned fillStyleIndex, const VSDXTheme *theme) const;
+  const VSDOptionalFillStyle &getOptionalFillStyle(unsigned fillStyleIndex) const;
+  const VSDOptionalTextBlockStyle &getOptionalTextBlockStyle(unsigned textStyleIndex) const;
+  const VSDOptionalCharStyle &getOptionalCharStyle(unsigned textStyleIndex) const;
+  const VSDOptionalParaStyle &getOptionalParaStyle(unsigned textStyleIndex) const;
 
 private:
+  void _clearCache();
+
   std::map<unsigned, VSDOptionalLineStyle> m_lineStyles;
   std::map<unsigned, VSDOptionalFillStyle> m_fillStyles;
   std::map<unsigned, VSDOptionalTextBlockStyle> m_textBlockStyles;
@@ -541,6 +545,15 @@ private:
   std::map<unsigned, unsigned> m_lineStyleMasters;
   std::map<unsigned, unsigned> m_fillStyleMasters;
   std::map<unsigned, unsigned> m_textStyleMasters;
+
+  // Styles resolved along their master chains
+  mutable std::map<unsigned, VSDOptionalLineStyle> m_resolvedLineStyles;
+  mutable std::map<unsigned, VSDOptionalFillStyle> m_resolvedFillStyles;
+  mutable std::map<unsigned, VSDOptionalTextBlockStyle> m_resolvedTextBlockStyles;
+  mutable std::map<unsigned, VSDOptionalCharStyle> m_resolvedCharStyles;
+  mutable std::map<unsigned, VSDOptionalParaStyle> m_resolvedParaStyles;
+  mutable std::map<unsigned, VSDFillStyle> m_themedFillStyles;
+  mutable const VSDXTheme *m_themedFillStylesTheme;
 };
 
 
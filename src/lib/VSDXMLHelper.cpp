@@ -91,7 +91,7 @@ void libvisio::VSDXRelationship::rebaseTarget(const char *baseDir)
 // VSDXRelationships
 
 libvisio::VSDXRelationships::VSDXRelationships(librevenge::RVNGInputStream *input)
-  : m_relsByType(), m_relsById()
+  : m_relsByType(), m_relsById(), m_ids()
 {
   if (input)
   {
@@ -124,6 +124,8 @@ libvisio::VSDXRelationships::VSDXRelationships(librevenge::RVNGInputStream *inpu
             {
               VSDXRelationship relationship(reader.get());
               m_relsByType[relationship.getType()] = relationship;
+              if (!m_relsById.count(relationship.getId()))
+                m_ids.push_back(relationship.getId());
               m_relsById[relationship.getId()] = relationship;
             }
           }
@@ -167,4 +169,18 @@ const libvisio::VSDXRelationship *libvisio::VSDXRelationships::getRelationshipBy
   return nullptr;
 }
 
+std::vector<const libvisio::VSDXRelationship *> libvisio::VSDXRelationships::getRelationshipsByType(const char *type) const
+{
+  std::vector<const VSDXRelationship *> rels;
+  if (!type)
+    return rels;
+  for (const auto &id : m_ids)
+  {
+    const VSDXRelationship &rel = m_relsById.find(id)->second;
+    if (rel.getType() == type)
+      rels.push_back(&rel);
+  }
+  return rels;
+}
+
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -13,6 +13,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <librevenge-stream/librevenge-stream.h>
 #include <libxml/xmlreader.h>
@@ -63,6 +64,8 @@ public:
 
   const VSDXRelationship *getRelationshipByType(const char *type) const;
   const VSDXRelationship *getRelationshipById(const char *id) const;
+  // All relationships of the type, in the order of the relationships part
+  std::vector<const VSDXRelationship *> getRelationshipsByType(const char *type) const;
 
   bool empty() const
   {
@@ -72,6 +75,7 @@ public:
 private:
   std::map<std::string, VSDXRelationship> m_relsByType;
   std::map<std::string, VSDXRelationship> m_relsById;
+  std::vector<std::string> m_ids;
 };
 
 } // namespace libvisio
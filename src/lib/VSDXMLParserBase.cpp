@@ -10,6 +10,8 @@
 #include "VSDXMLParserBase.h"
 
 #include <string.h>
+#include <vector>
+#include <libxml/parser.h>
 #include <libxml/xmlIO.h>
 #include <libxml/xmlstring.h>
 #include <librevenge-stream/librevenge-stream.h>
@@ -20,12 +22,141 @@
 #include "libvisio_utils.h"
 #include "libvisio_xml.h"
 #include "VSDContentCollector.h"
+#include "VSDRecordingCollector.h"
 #include "VSDStylesCollector.h"
 #include "VSDXMLHelper.h"
 #include "VSDXMLTokenMap.h"
 
 using std::shared_ptr;
 
+#define VSD_PAGE_SCAN_READ_SIZE 65536UL
+
+namespace
+{
+
+struct ScannedPage
+{
+  ScannedPage() : id(), backPage(), background(), rel() {}
+  shared_ptr<xmlChar> id;
+  shared_ptr<xmlChar> backPage;
+  shared_ptr<xmlChar> background;
+  // r:id of the Rel that points to the part with the page contents
+  shared_ptr<xmlChar> rel;
+};
+
+struct PageScanState
+{
+  PageScanState() : context(nullptr), pages(), depth(0), pageDepth(0), isInPage(false), isError(false) {}
+  xmlParserCtxtPtr context;
+  std::vector<ScannedPage> pages;
+  unsigned depth;
+  unsigned pageDepth;
+  bool isInPage;
+  bool isError;
+};
+
+shared_ptr<xmlChar> getScannedAttribute(const xmlChar **attributes, int nbAttributes, const char *prefix, const char *name, bool &isError)
+{
+  for (int i = 0; i < nbAttributes; ++i)
+  {
+    const xmlChar *const *const attribute = attributes + 5 * i;
+    if (!xmlStrEqual(attribute[1], BAD_CAST(prefix)) || !xmlStrEqual(attribute[0], BAD_CAST(name)))
+      continue;
+    // A reader would have resolved the references
+    if (memchr(attribute[3], '&', attribute[4] - attribute[3]))
+      isError = true;
+    return shared_ptr<xmlChar>(xmlStrndup(attribute[3], int(attribute[4] - attribute[3])), xmlFree);
+  }
+  return shared_ptr<xmlChar>();
+}
+
+extern "C"
+{
+
+  static void vsdxScanStartElementNs(void *context, const xmlChar *localname, const xmlChar *prefix, const xmlChar * /* URI */,
+                                     int /* nbNamespaces */, const xmlChar ** /* namespaces */, int nbAttributes, int /* nbDefaulted */,
+                                     const xmlChar **attributes)
+  {
+    auto *const state = static_cast<PageScanState *>(context);
+    ++state->depth;
+    if (state->isError || (state->isInPage && state->depth != state->pageDepth + 1))
+      return;
+    try
+    {
+      const int tokenId = prefix
+                          ? libvisio::VSDXMLTokenMap::getTokenId(BAD_CAST((std::string((const char *)prefix) + ":" + (const char *)localname).c_str()))
+                          : libvisio::VSDXMLTokenMap::getTokenId(localname);
+      if (state->isInPage)
+      {
+        if (XML_REL == tokenId && !state->pages.back().rel)
+          state->pages.back().rel = getScannedAttribute(attributes, nbAttributes, "r", "id", state->isError);
+        return;
+      }
+      if (XML_PAGE != tokenId)
+        return;
+      ScannedPage page;
+      page.id = getScannedAttribute(attributes, nbAttributes, nullptr, "ID", state->isError);
+      page.backPage = getScannedAttribute(attributes, nbAttributes, nullptr, "BackPage", state->isError);
+      page.background = getScannedAttribute(attributes, nbAttributes, nullptr, "Background", state->isError);
+      state->pages.push_back(page);
+      // Only the attributes of the pages and their Rel are needed
+      state->isInPage = true;
+      state->pageDepth = state->depth;
+    }
+    catch (...)
+    {
+      state->isError = true;
+    }
+    if (state->isError)
+      xmlStopParser(state->context);
+  }
+
+  static void vsdxScanEndElementNs(void *context, const xmlChar * /* localname */, const xmlChar * /* prefix */, const xmlChar * /* URI */)
+  {
+    auto *const state = static_cast<PageScanState *>(context);
+    if (state->isInPage && state->depth == state->pageDepth)
+      state->isInPage = false;
+    --state->depth;
+  }
+
+} // extern "C"
+
+// Finds the pages with a SAX parser that builds no nodes, false if the
+// document is not one that a reader would read through
+bool scanPageAttributes(librevenge::RVNGInputStream *input, std::vector<ScannedPage> &pages)
+{
+  xmlSAXHandler handler;
+  memset(&handler, 0, sizeof(handler));
+  handler.initialized = XML_SAX2_MAGIC;
+  handler.startElementNs = vsdxScanStartElementNs;
+  handler.endElementNs = vsdxScanEndElementNs;
+
+  PageScanState state;
+  const std::unique_ptr<xmlParserCtxt, void (*)(xmlParserCtxtPtr)> context(
+    xmlCreatePushParserCtxt(&handler, &state, nullptr, 0, nullptr), xmlFreeParserCtxt);
+  if (!context)
+    return false;
+  state.context = context.get();
+  xmlCtxtUseOptions(context.get(), XML_PARSE_NOBLANKS | XML_PARSE_NONET | XML_PARSE_NOWARNING | XML_PARSE_NOERROR);
+
+  while (!input->isEnd() && !state.isError && context->wellFormed)
+  {
+    unsigned long numBytesRead = 0;
+    const unsigned char *data = input->read(VSD_PAGE_SCAN_READ_SIZE, numBytesRead);
+    if (!numBytesRead)
+      break;
+    xmlParseChunk(context.get(), reinterpret_cast<const char *>(data), int(numBytesRead), 0);
+  }
+  if (!state.isError && context->wellFormed)
+    xmlParseChunk(context.get(), nullptr, 0, 1);
+  if (state.isError || !context->wellFormed || !context->nsWellFormed)
+    return false;
+  pages.swap(state.pages);
+  return true;
+}
+
+} // anonymous namespace
+
 libvisio::VSDXMLParserBase::VSDXMLParserBase()
   : m_collector(), m_stencils(), m_currentStencil(), m_shape(),
     m_isStencilStarted(false), m_currentStencilID(MINUS_ONE),
@@ -34,7 +165,8 @@ libvisio::VSDXMLParserBase::VSDXMLParserBase()
     m_currentBinaryData(), m_shapeStack(), m_shapeLevelStack(),
     m_isShapeStarted(false), m_isPageStarted(false), m_currentGeometryList(nullptr),
     m_currentGeometryListIndex(MINUS_ONE), m_fonts(), m_currentTabSet(nullptr),
-    m_watcher(nullptr)
+    m_watcher(nullptr), m_singlePass(true), m_maxRecordSize(VSD_RECORDING_DEFAULT_SIZE), m_recorder(nullptr), m_isFirstPass(false),
+    m_pageSelection(), m_pagesOutput(nullptr), m_parseOptions()
 {
   initColours();
 }
@@ -1854,6 +1986,43 @@ void libvisio::VSDXMLParserBase::_flushShape()
   m_collector->collectUnhandledChunk(0, m_currentShapeLevel);
 }
 
+void libvisio::VSDXMLParserBase::setSinglePass(bool singlePass)
+{
+  m_singlePass = singlePass;
+}
+
+// Recording more than this falls back to a 2nd pass
+void libvisio::VSDXMLParserBase::setMaxRecordSize(unsigned long maxSize)
+{
+  m_maxRecordSize = maxSize;
+}
+
+void libvisio::VSDXMLParserBase::setPageSelection(const VSDPageSelection &pageSelection)
+{
+  m_pageSelection = pageSelection;
+}
+
+void libvisio::VSDXMLParserBase::setPagesOutput(VSDPages *pages)
+{
+  m_pagesOutput = pages;
+}
+
+void libvisio::VSDXMLParserBase::setParseOptions(const VisioParseOptions &options)
+{
+  m_parseOptions = options;
+}
+
+bool libvisio::VSDXMLParserBase::replay(const VSDRecordingCollector &recordingCollector, VSDContentCollector &contentCollector,
+                                        const std::function<std::unique_ptr<VSDContentCollector> ()> &createCollector) try
+{
+  recordingCollector.replay(&contentCollector, createCollector, m_parseOptions.getThreadCount());
+  return true;
+}
+catch (...)
+{
+  return false;
+}
+
 void libvisio::VSDXMLParserBase::_handleLevelChange(unsigned level)
 {
   m_currentLevel = level;
@@ -1878,8 +2047,18 @@ void libvisio::VSDXMLParserBase::handlePagesEnd(xmlTextReaderPtr /* reader */)
 void libvisio::VSDXMLParserBase::handlePageStart(xmlTextReaderPtr reader)
 {
   m_isShapeStarted = false;
-  if (!m_extractStencils)
-    readPage(reader);
+  if (m_extractStencils)
+    return;
+  if (m_pageSelection.isActive())
+  {
+    const shared_ptr<xmlChar> id(xmlTextReaderGetAttribute(reader, BAD_CAST("ID")), xmlFree);
+    if (id && !m_pageSelection.isPageNeeded((unsigned)xmlStringToLong(id)))
+    {
+      skipElement(reader);
+      return;
+    }
+  }
+  readPage(reader);
 }
 
 void libvisio::VSDXMLParserBase::handlePageEnd(xmlTextReaderPtr /* reader */)
@@ -1905,7 +2084,11 @@ void libvisio::VSDXMLParserBase::handleMastersStart(xmlTextReaderPtr reader)
     if (m_extractStencils)
       m_isStencilStarted = false;
     else
+    {
       m_isStencilStarted = true;
+      if (m_recorder)
+        m_recorder->mark();
+    }
   }
 }
 
@@ -1915,7 +2098,18 @@ void libvisio::VSDXMLParserBase::handleMastersEnd(xmlTextReaderPtr /* reader */)
   if (m_extractStencils)
     m_collector->endPages();
   else
+  {
     m_isStencilStarted = false;
+    // A 2nd pass skips the masters if there are any, and reads the pages
+    // that precede them with the masters known.
+    if (m_recorder && m_stencils.count())
+    {
+      if (m_recorder->getPageCount())
+        m_recorder->discard();
+      else
+        m_recorder->rewind();
+    }
+  }
 }
 
 void libvisio::VSDXMLParserBase::handleMasterStart(xmlTextReaderPtr reader)
@@ -1976,6 +2170,102 @@ void libvisio::VSDXMLParserBase::skipPages(xmlTextReaderPtr reader)
   while ((XML_PAGES != tokenId || XML_READER_TYPE_END_ELEMENT != tokenType) && 1 == ret);
 }
 
+int libvisio::VSDXMLParserBase::skipElement(xmlTextReaderPtr reader)
+{
+  if (xmlTextReaderIsEmptyElement(reader))
+    return 1;
+  const int depth = xmlTextReaderDepth(reader);
+  int ret = 1;
+  do
+  {
+    ret = xmlTextReaderRead(reader);
+  }
+  while ((XML_READER_TYPE_END_ELEMENT != xmlTextReaderNodeType(reader) || depth != xmlTextReaderDepth(reader)) && 1 == ret);
+  return ret;
+}
+
+void libvisio::VSDXMLParserBase::scanPages(librevenge::RVNGInputStream *input, std::vector<std::string> *pageRels)
+{
+  if (m_pageSelection.isResolved())
+    return;
+
+  // A well-formed document is scanned without building any nodes; other ones
+  // are read like the parser reads them, so that the same pages are found
+  std::vector<ScannedPage> pages;
+  if (scanPageAttributes(input, pages))
+  {
+    for (const auto &page : pages)
+    {
+      if (page.id)
+        m_pageSelection.addPage((unsigned)xmlStringToLong(page.id), page.background ? xmlStringToBool(page.background) : false,
+                                (unsigned)(page.backPage ? xmlStringToLong(page.backPage) : -1));
+    }
+    m_pageSelection.resolve();
+    if (pageRels)
+    {
+      for (const auto &page : pages)
+      {
+        if (page.id && page.rel && m_pageSelection.isPageNeeded((unsigned)xmlStringToLong(page.id)))
+          pageRels->push_back((const char *)page.rel.get());
+      }
+    }
+    input->seek(0, librevenge::RVNG_SEEK_SET);
+    return;
+  }
+  input->seek(0, librevenge::RVNG_SEEK_SET);
+
+  auto reader = xmlReaderForStream(input);
+  if (reader)
+  {
+    int ret = xmlTextReaderRead(reader.get());
+    while (1 == ret)
+    {
+      if (XML_READER_TYPE_ELEMENT == xmlTextReaderNodeType(reader.get()) && XML_PAGE == getElementToken(reader.get()))
+      {
+        const shared_ptr<xmlChar> id(xmlTextReaderGetAttribute(reader.get(), BAD_CAST("ID")), xmlFree);
+        const shared_ptr<xmlChar> bgndPage(xmlTextReaderGetAttribute(reader.get(), BAD_CAST("BackPage")), xmlFree);
+        const shared_ptr<xmlChar> background(xmlTextReaderGetAttribute(reader.get(), BAD_CAST("Background")), xmlFree);
+        if (id)
+          m_pageSelection.addPage((unsigned)xmlStringToLong(id), background ? xmlStringToBool(background) : false,
+                                  (unsigned)(bgndPage ? xmlStringToLong(bgndPage) : -1));
+        // Only the attributes of the pages are needed
+        ret = xmlTextReaderNext(reader.get());
+      }
+      else
+        ret = xmlTextReaderRead(reader.get());
+    }
+  }
+  m_pageSelection.resolve();
+  input->seek(0, librevenge::RVNG_SEEK_SET);
+}
+
+bool libvisio::VSDXMLParserBase::_isSkeletonScan() const
+{
+  // Only a 1st pass that is not recorded for replay can skip the shape content,
+  // as the 2nd pass reads it again. Masters are not read in the 2nd pass.
+  return m_isFirstPass && !m_isStencilStarted && (!m_recorder || m_recorder->isDiscarded());
+}
+
+bool libvisio::VSDXMLParserBase::_isContentElement(int tokenId) const
+{
+  switch (tokenId)
+  {
+  case XML_GEOM:
+  case XML_GEOMETRY:
+  case XML_FOREIGNDATA:
+  case XML_TEXT:
+    return true;
+  case XML_PARA:
+  case XML_PARAGRAPH:
+  case XML_CHAR:
+  case XML_CHARACTER:
+  case XML_TABS:
+    return !m_isInStyles;
+  default:
+    return false;
+  }
+}
+
 int libvisio::VSDXMLParserBase::readNURBSData(std::optional<NURBSData> &data, xmlTextReaderPtr reader)
 {
   NURBSData tmpData;
@@ -2073,13 +2363,20 @@ int libvisio::VSDXMLParserBase::readPolylineData(std::optional<PolylineData> &da
 }
 
 
+const xmlChar *libvisio::VSDXMLParserBase::readConstStringData(xmlTextReaderPtr reader, std::unique_ptr<xmlChar, void (*)(void *)> &copy)
+{
+  copy.reset(readStringData(reader));
+  return copy.get();
+}
+
 int libvisio::VSDXMLParserBase::readDoubleData(double &value, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readDoubleData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readDoubleData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
       value = xmlStringToDouble(stringValue);
     return 1;
   }
@@ -2088,13 +2385,14 @@ int libvisio::VSDXMLParserBase::readDoubleData(double &value, xmlTextReaderPtr r
 
 int libvisio::VSDXMLParserBase::readStringData(libvisio::VSDName &text, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readStringData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readStringData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
     {
-      text.m_data = librevenge::RVNGBinaryData(stringValue.get(), xmlStrlen(stringValue.get()));
+      text.m_data = librevenge::RVNGBinaryData(stringValue, xmlStrlen(stringValue));
       text.m_format = VSD_TEXT_UTF8;
     }
     return 1;
@@ -2104,11 +2402,12 @@ int libvisio::VSDXMLParserBase::readStringData(libvisio::VSDName &text, xmlTextR
 
 int libvisio::VSDXMLParserBase::readDoubleData(std::optional<double> &value, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readDoubleData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readDoubleData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
       value = xmlStringToDouble(stringValue);
     return 1;
   }
@@ -2117,11 +2416,12 @@ int libvisio::VSDXMLParserBase::readDoubleData(std::optional<double> &value, xml
 
 int libvisio::VSDXMLParserBase::readLongData(long &value, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readLongData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readLongData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
       value = xmlStringToLong(stringValue);
     return 1;
   }
@@ -2130,11 +2430,12 @@ int libvisio::VSDXMLParserBase::readLongData(long &value, xmlTextReaderPtr reade
 
 int libvisio::VSDXMLParserBase::readLongData(std::optional<long> &value, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readLongData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readLongData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
       value = xmlStringToLong(stringValue);
     return 1;
   }
@@ -2143,11 +2444,12 @@ int libvisio::VSDXMLParserBase::readLongData(std::optional<long> &value, xmlText
 
 int libvisio::VSDXMLParserBase::readBoolData(bool &value, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readBoolData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readBoolData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
       value = xmlStringToBool(stringValue);
     return 1;
   }
@@ -2156,11 +2458,12 @@ int libvisio::VSDXMLParserBase::readBoolData(bool &value, xmlTextReaderPtr reade
 
 int libvisio::VSDXMLParserBase::readBoolData(std::optional<bool> &value, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readBoolData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readBoolData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
       value = xmlStringToBool(stringValue);
     return 1;
   }
@@ -2195,11 +2498,12 @@ int libvisio::VSDXMLParserBase::readByteData(std::optional<unsigned char> &value
 
 int libvisio::VSDXMLParserBase::readExtendedColourData(Colour &value, long &idx, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readColourData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readColourData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
     {
       try
       {
@@ -2241,11 +2545,12 @@ int libvisio::VSDXMLParserBase::readExtendedColourData(std::optional<Colour> &va
  */
 bool libvisio::VSDXMLParserBase::readColourOrColourIndex(Colour &value, long &idx, xmlTextReaderPtr reader)
 {
-  const shared_ptr<xmlChar> stringValue(readStringData(reader), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const stringValue = readConstStringData(reader, copy);
   if (stringValue)
   {
-    VSD_DEBUG_MSG(("VSDXMLParserBase::readExtendedColourData stringValue %s\n", (const char *)stringValue.get()));
-    if (!xmlStrEqual(stringValue.get(), BAD_CAST("Themed")))
+    VSD_DEBUG_MSG(("VSDXMLParserBase::readExtendedColourData stringValue %s\n", (const char *)stringValue));
+    if (!xmlStrEqual(stringValue, BAD_CAST("Themed")))
     {
       try
       {
@@ -2270,9 +2575,10 @@ int libvisio::VSDXMLParserBase::readExtendedColourData(Colour &value, xmlTextRea
 unsigned libvisio::VSDXMLParserBase::getIX(xmlTextReaderPtr reader)
 {
   auto ix = MINUS_ONE;
-  const std::shared_ptr<xmlChar> ixString(xmlTextReaderGetAttribute(reader, BAD_CAST("IX")), xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *const ixString = xmlReaderConstAttribute(reader, "IX", copy);
   if (ixString)
-    ix = (unsigned)xmlStringToLong(ixString.get());
+    ix = (unsigned)xmlStringToLong(ixString);
   return ix;
 }
 
@@ -10,21 +10,28 @@
 #ifndef __VSDXMLPARSERBASE_H__
 #define __VSDXMLPARSERBASE_H__
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <stack>
 #include <string>
 #include <optional>
+#include <vector>
+#include <libvisio/VisioDocument.h>
 #include "VSDXMLHelper.h"
 #include "VSDCharacterList.h"
 #include "VSDParagraphList.h"
 #include "VSDShapeList.h"
+#include "VSDPageSelection.h"
 #include "VSDStencils.h"
 
 namespace libvisio
 {
 
 class VSDCollector;
+class VSDContentCollector;
+class VSDPages;
+class VSDRecordingCollector;
 class XMLErrorWatcher;
 
 class VSDXMLParserBase
@@ -34,6 +41,11 @@ public:
   virtual ~VSDXMLParserBase();
   virtual bool parseMain() = 0;
   virtual bool extractStencils() = 0;
+  void setSinglePass(bool singlePass);
+  void setMaxRecordSize(unsigned long maxSize);
+  void setPageSelection(const VSDPageSelection &pageSelection);
+  void setPagesOutput(VSDPages *pages);
+  void setParseOptions(const VisioParseOptions &options);
 
 protected:
   // Protected data
@@ -65,6 +77,14 @@ protected:
 
   XMLErrorWatcher *m_watcher;
 
+  bool m_singlePass;
+  unsigned long m_maxRecordSize;
+  VSDRecordingCollector *m_recorder;
+  bool m_isFirstPass;
+  VSDPageSelection m_pageSelection;
+  VSDPages *m_pagesOutput;
+  VisioParseOptions m_parseOptions;
+
   // Helper functions
 
   int readByteData(unsigned char &value, xmlTextReaderPtr reader);
@@ -86,9 +106,15 @@ protected:
   void readTriggerId(unsigned &id, xmlTextReaderPtr reader);
 
   virtual xmlChar *readStringData(xmlTextReaderPtr reader) = 0;
+  // Like readStringData, but copies the value into copy only if the reader does not hold it
+  virtual const xmlChar *readConstStringData(xmlTextReaderPtr reader, std::unique_ptr<xmlChar, void (*)(void *)> &copy);
   unsigned getIX(xmlTextReaderPtr reader);
   virtual void _handleLevelChange(unsigned level);
   void _flushShape();
+  bool _isSkeletonScan() const;
+  bool _isContentElement(int tokenId) const;
+  bool replay(const VSDRecordingCollector &recordingCollector, VSDContentCollector &contentCollector,
+              const std::function<std::unique_ptr<VSDContentCollector> ()> &createCollector);
 
   virtual int getElementToken(xmlTextReaderPtr reader) = 0;
   virtual int getElementDepth(xmlTextReaderPtr reader) = 0;
@@ -138,6 +164,11 @@ protected:
   void handleMasterEnd(xmlTextReaderPtr reader);
   void skipPages(xmlTextReaderPtr reader);
   void skipMasters(xmlTextReaderPtr reader);
+  int skipElement(xmlTextReaderPtr reader);
+  // Resolves the page selection. If pageRels is given, it gets the ids of
+  // the relationships to the parts of the needed pages, where the scan
+  // finds them.
+  void scanPages(librevenge::RVNGInputStream *input, std::vector<std::string> *pageRels = nullptr);
 
 private:
   VSDXMLParserBase(const VSDXMLParserBase &);
@@ -0,0 +1,269 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "VSDXPackage.h"
+
+#include "VSDInternalStream.h"
+
+#define VSDX_PART_READ_SIZE 65536UL
+
+namespace
+{
+
+std::string getTargetBaseDirectory(const std::string &target)
+{
+  std::string::size_type position = target.find_last_of('/');
+  if (position == std::string::npos || !position)
+    return std::string();
+  return target.substr(0, position + 1);
+}
+
+std::string getRelationshipsForTarget(const std::string &target)
+{
+  std::string relStr(target);
+  std::string::size_type position = relStr.find_last_of('/');
+  if (position == std::string::npos)
+    position = 0;
+  relStr.insert(position ? position+1 : position, "_rels/");
+  relStr.append(".rels");
+  return relStr;
+}
+
+} // anonymous namespace
+
+libvisio::VSDXPackage::VSDXPackage(librevenge::RVNGInputStream *input, unsigned long maxSize)
+  : m_input(input), m_parts(), m_missingParts(), m_partsInFlight(), m_relationships(), m_size(0), m_maxSize(maxSize),
+    m_isPrefetchStopped(false), m_mutex(), m_inputMutex(), m_condition(), m_prefetchThread()
+{
+}
+
+libvisio::VSDXPackage::~VSDXPackage()
+{
+  stopPrefetching();
+}
+
+libvisio::VSDXPackage::Buffer_t libvisio::VSDXPackage::getPartData(const std::string &name)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_condition.wait(lock, [this, &name]()
+  {
+    return !m_partsInFlight.count(name);
+  });
+  auto iter = m_parts.find(name);
+  if (iter != m_parts.end())
+    return iter->second;
+  if (m_missingParts.count(name))
+    return Buffer_t();
+
+  m_partsInFlight.insert(name);
+  lock.unlock();
+  Buffer_t buffer;
+  try
+  {
+    buffer = _readPart(name);
+  }
+  catch (...)
+  {
+    lock.lock();
+    m_partsInFlight.erase(name);
+    m_condition.notify_all();
+    throw;
+  }
+  lock.lock();
+  m_partsInFlight.erase(name);
+  if (!buffer)
+    m_missingParts.insert(name);
+  else if (buffer->size() <= m_maxSize && m_size <= m_maxSize - buffer->size())
+  {
+    m_parts.insert(std::make_pair(name, buffer));
+    m_size += buffer->size();
+  }
+  m_condition.notify_all();
+  return buffer;
+}
+
+libvisio::RVNGInputStreamPtr_t libvisio::VSDXPackage::getPart(const std::string &name)
+{
+  const Buffer_t buffer = getPartData(name);
+  if (!buffer)
+    return RVNGInputStreamPtr_t();
+  return std::make_shared<VSDInternalStream>(buffer);
+}
+
+const libvisio::VSDXRelationships &libvisio::VSDXPackage::getRelationships(const std::string &name)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_relationships.find(name);
+    if (iter != m_relationships.end())
+      return iter->second;
+  }
+
+  // The .rels part is only needed to build the relationships, so it is not kept
+  const std::string relName = getRelationshipsForTarget(name);
+  const RVNGInputStreamPtr_t relStream(_openPart(relName));
+  std::unique_ptr<VSDXRelationships> rels(new VSDXRelationships(relStream.get()));
+  rels->rebaseTargets(getTargetBaseDirectory(name).c_str());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // If the other thread got there first, its relationships are the same
+  return m_relationships.insert(std::make_pair(name, *rels)).first->second;
+}
+
+void libvisio::VSDXPackage::prefetch(const std::string &name, bool withPages)
+{
+  if (m_prefetchThread.joinable())
+    return;
+  _startPrefetching(std::vector<std::string>(1, name), withPages);
+}
+
+void libvisio::VSDXPackage::prefetchParts(const std::vector<std::string> &names)
+{
+  stopPrefetching();
+  _startPrefetching(names, true);
+}
+
+void libvisio::VSDXPackage::stopPrefetching()
+{
+  if (!m_prefetchThread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isPrefetchStopped = true;
+  }
+  m_prefetchThread.join();
+}
+
+void libvisio::VSDXPackage::clear()
+{
+  stopPrefetching();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_parts.clear();
+  m_missingParts.clear();
+  m_relationships.clear();
+  m_size = 0;
+}
+
+unsigned long libvisio::VSDXPackage::getSize() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+libvisio::RVNGInputStreamPtr_t libvisio::VSDXPackage::_openPart(const std::string &name)
+{
+  std::lock_guard<std::mutex> inputLock(m_inputMutex);
+  if (!m_input || !m_input->isStructured())
+    return RVNGInputStreamPtr_t();
+  m_input->seek(0, librevenge::RVNG_SEEK_SET);
+  const RVNGInputStreamPtr_t stream(m_input->getSubStreamByName(name.c_str()));
+  m_input->seek(0, librevenge::RVNG_SEEK_SET);
+  return stream;
+}
+
+libvisio::VSDXPackage::Buffer_t libvisio::VSDXPackage::_readPart(const std::string &name)
+{
+  // Only opening the part needs m_input; the parser and the prefetching
+  // thread inflate their parts side by side
+  const RVNGInputStreamPtr_t stream(_openPart(name));
+  if (!stream)
+    return Buffer_t();
+
+  auto buffer = std::make_shared<std::vector<unsigned char> >();
+  while (true)
+  {
+    unsigned long numBytesRead = 0;
+    const unsigned char *data = stream->read(VSDX_PART_READ_SIZE, numBytesRead);
+    if (numBytesRead)
+      buffer->insert(buffer->end(), data, data + numBytesRead);
+    if (!numBytesRead || stream->isEnd())
+      break;
+  }
+  return buffer;
+}
+
+bool libvisio::VSDXPackage::_isCached(const std::string &name) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_parts.count(name) || m_missingParts.count(name);
+}
+
+void libvisio::VSDXPackage::_startPrefetching(const std::vector<std::string> &names, bool withPages)
+{
+  if (names.empty() || !m_input || !m_input->isStructured())
+    return;
+  m_isPrefetchStopped = false;
+  try
+  {
+    m_prefetchThread = std::thread([this, names, withPages]()
+    {
+      std::set<std::string> visited;
+      try
+      {
+        for (const auto &name : names)
+        {
+          if (!_prefetchParts(name, withPages, visited))
+            break;
+        }
+      }
+      catch (...)
+      {
+      }
+    });
+  }
+  catch (...)
+  {
+    // Without the thread, the parser reads every part itself
+  }
+}
+
+// Returns false once prefetching should stop: when asked to, or when
+// the parts do not fit under the size ceiling any more
+bool libvisio::VSDXPackage::_prefetchParts(const std::string &name, bool withPages, std::set<std::string> &visited)
+{
+  static const char PAGE_TYPE[] = "http://schemas.microsoft.com/visio/2010/relationships/page";
+  // The parts the parser reads, in the order it gets to them
+  static const char *const PREFETCHED_TYPES[] =
+  {
+    "http://schemas.openxmlformats.org/officeDocument/2006/relationships/theme",
+    "http://schemas.microsoft.com/visio/2010/relationships/masters",
+    "http://schemas.microsoft.com/visio/2010/relationships/master",
+    "http://schemas.microsoft.com/visio/2010/relationships/pages",
+    PAGE_TYPE,
+    "http://schemas.openxmlformats.org/officeDocument/2006/relationships/image",
+    "http://schemas.openxmlformats.org/officeDocument/2006/relationships/oleObject"
+  };
+
+  if (!visited.insert(name).second)
+    return true;
+  const VSDXRelationships &rels = getRelationships(name);
+  for (const char *type : PREFETCHED_TYPES)
+  {
+    if (!withPages && type == PAGE_TYPE)
+      continue;
+    for (const VSDXRelationship *rel : rels.getRelationshipsByType(type))
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_isPrefetchStopped)
+          return false;
+      }
+      const std::string &target = rel->getTarget();
+      if (!visited.count(target))
+      {
+        getPartData(target);
+        if (!_isCached(target) || !_prefetchParts(target, withPages, visited))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,95 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __VSDXPACKAGE_H__
+#define __VSDXPACKAGE_H__
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <librevenge-stream/librevenge-stream.h>
+#include "VSDXMLHelper.h"
+#include "libvisio_utils.h"
+
+#define VSDX_PACKAGE_CACHE_DEFAULT_SIZE (256UL * 1024UL * 1024UL)
+
+namespace libvisio
+{
+
+// The parts of an OPC package, each read from the zip container once.
+// Every part looked up is remembered, together with whether it exists and
+// its relationships with targets rebased to the part's directory. Part data
+// are kept while they fit under the size ceiling; larger ones are read
+// again on the next lookup.
+//
+// The package can read the parts a part refers to ahead of the parser, on
+// a thread of its own; lookups are safe while that thread runs.
+class VSDXPackage
+{
+public:
+  typedef std::shared_ptr<const std::vector<unsigned char> > Buffer_t;
+
+  explicit VSDXPackage(librevenge::RVNGInputStream *input, unsigned long maxSize = VSDX_PACKAGE_CACHE_DEFAULT_SIZE);
+  ~VSDXPackage();
+
+  // The data of the part, nullptr if there is no such part
+  Buffer_t getPartData(const std::string &name);
+  // A stream over the data of the part, nullptr if there is no such part
+  RVNGInputStreamPtr_t getPart(const std::string &name);
+  const VSDXRelationships &getRelationships(const std::string &name);
+
+  // Starts reading the parts that the part refers to, directly or through
+  // other parts, in the order the parser reaches them. The pages are left
+  // out unless withPages is set, for when only some of them are needed.
+  void prefetch(const std::string &name, bool withPages = true);
+  // Stops the reading started before and reads these parts instead, with
+  // the parts they refer to
+  void prefetchParts(const std::vector<std::string> &names);
+  void stopPrefetching();
+
+  void clear();
+
+  unsigned long getSize() const;
+
+private:
+  VSDXPackage(const VSDXPackage &);
+  VSDXPackage &operator=(const VSDXPackage &);
+
+  RVNGInputStreamPtr_t _openPart(const std::string &name);
+  Buffer_t _readPart(const std::string &name);
+  bool _isCached(const std::string &name) const;
+  void _startPrefetching(const std::vector<std::string> &names, bool withPages);
+  bool _prefetchParts(const std::string &name, bool withPages, std::set<std::string> &visited);
+
+  librevenge::RVNGInputStream *m_input;
+  std::map<std::string, Buffer_t> m_parts;
+  std::set<std::string> m_missingParts;
+  // Parts being read, by the parser or the prefetching thread
+  std::set<std::string> m_partsInFlight;
+  std::map<std::string, VSDXRelationships> m_relationships;
+  unsigned long m_size;
+  unsigned long m_maxSize;
+  bool m_isPrefetchStopped;
+  mutable std::mutex m_mutex;
+  // Guards m_input, which the parser and the prefetching thread share.
+  // A part is only opened under it; its substream is read on its own.
+  std::mutex m_inputMutex;
+  std::condition_variable m_condition;
+  std::thread m_prefetchThread;
+};
+
+} // namespace libvisio
+
+#endif // __VSDXPACKAGE_H__
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,209 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "VSDXParsedParts.h"
+
+#include <limits.h>
+#include <algorithm>
+#include <libxml/SAX2.h>
+#include <libxml/parser.h>
+#include <libxml/xmlerror.h>
+#include <libxml/xmlversion.h>
+
+namespace
+{
+
+#if LIBXML_VERSION >= 21200
+typedef const xmlError *XMLErrorPtr_t;
+#else
+typedef xmlErrorPtr XMLErrorPtr_t;
+#endif
+
+struct ParseState
+{
+  explicit ParseState(const std::vector<unsigned char> &d) : data(d), emptyElements(), isError(false) {}
+  const std::vector<unsigned char> &data;
+  // Whether each element, in document order, was written as <x/>
+  std::vector<bool> emptyElements;
+  bool isError;
+};
+
+extern "C"
+{
+
+  static void vsdxStartElementNs(void *context, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+                                 int nbNamespaces, const xmlChar **namespaces, int nbAttributes, int nbDefaulted, const xmlChar **attributes)
+  {
+    xmlSAX2StartElementNs(context, localname, prefix, URI, nbNamespaces, namespaces, nbAttributes, nbDefaulted, attributes);
+    auto *const parserContext = static_cast<xmlParserCtxtPtr>(context);
+    auto *const state = static_cast<ParseState *>(parserContext->_private);
+    // The start tag is reported before its end is consumed. Data in an
+    // encoding that is not ASCII compatible never match, so the part is
+    // then read by the parser as usual.
+    const long consumed = xmlByteConsumed(parserContext);
+    const bool isEmpty = consumed >= 0 && std::size_t(consumed) + 1 < state->data.size()
+                         && '/' == state->data[std::size_t(consumed)] && '>' == state->data[std::size_t(consumed) + 1];
+    state->emptyElements.push_back(isEmpty);
+  }
+
+  static void vsdxStructuredErrorFunc(void *context, XMLErrorPtr_t error)
+  {
+    if (context && error && error->level >= XML_ERR_ERROR)
+      static_cast<ParseState *>(context)->isError = true;
+  }
+
+} // extern "C"
+
+// A reader walking the tree reports every element without children like <x/>,
+// so <x></x> would not read like it does from the part data.
+bool isWalkable(xmlDocPtr document, const std::vector<bool> &emptyElements)
+{
+  if (document->intSubset || document->extSubset)
+    return false;
+  std::size_t element = 0;
+  xmlNodePtr node = document->children;
+  while (node)
+  {
+    if (XML_ENTITY_REF_NODE == node->type)
+      return false;
+    if (XML_ELEMENT_NODE == node->type)
+    {
+      if (element >= emptyElements.size())
+        return false;
+      const bool isEmpty = emptyElements[element++];
+      if (node->children)
+      {
+        node = node->children;
+        continue;
+      }
+      if (!isEmpty)
+        return false;
+    }
+    while (node && !node->next)
+      node = node->parent;
+    if (node)
+      node = node->next;
+  }
+  return element == emptyElements.size();
+}
+
+libvisio::VSDXParsedParts::Document_t parsePart(const std::vector<unsigned char> &data)
+{
+  libvisio::VSDXParsedParts::Document_t document(nullptr, xmlFreeDoc);
+  if (data.empty() || data.size() > INT_MAX)
+    return document;
+  const std::unique_ptr<xmlParserCtxt, void (*)(xmlParserCtxtPtr)> context(xmlNewParserCtxt(), xmlFreeParserCtxt);
+  if (!context || !context->sax)
+    return document;
+
+  // The options xmlReaderForStream uses without recovery; the tree is only read, so text may be stored compactly.
+  // Errors are reported to the handler of this thread, which is one of ours.
+  ParseState state(data);
+  context->_private = &state;
+  context->sax->startElementNs = vsdxStartElementNs;
+  xmlSetStructuredErrorFunc(&state, vsdxStructuredErrorFunc);
+  document.reset(xmlCtxtReadMemory(context.get(), reinterpret_cast<const char *>(data.data()), int(data.size()), nullptr, nullptr,
+                                   XML_PARSE_NOBLANKS | XML_PARSE_NONET | XML_PARSE_NOWARNING | XML_PARSE_COMPACT));
+  xmlSetStructuredErrorFunc(nullptr, nullptr);
+  if (document && (state.isError || !isWalkable(document.get(), state.emptyElements)))
+    document.reset();
+  return document;
+}
+
+} // anonymous namespace
+
+libvisio::VSDXParsedParts::VSDXParsedParts(const std::vector<std::pair<std::string, VSDXPackage::Buffer_t> > &parts, unsigned threadCount)
+  : m_parts(), m_partIndices(), m_nextPart(0), m_firstNeeded(0), m_window(2 * std::size_t(threadCount)),
+    m_isStopped(false), m_mutex(), m_condition(), m_threads()
+{
+  xmlInitParser();
+  m_parts.reserve(parts.size());
+  for (const auto &part : parts)
+  {
+    if (!part.second || m_partIndices.count(part.first))
+      continue;
+    m_partIndices[part.first] = m_parts.size();
+    m_parts.push_back(Part(part.first, part.second));
+  }
+
+  const std::size_t count = std::min<std::size_t>(threadCount, m_parts.size());
+  try
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      m_threads.push_back(std::thread(&VSDXParsedParts::_parseParts, this));
+  }
+  catch (...)
+  {
+    // Whatever threads started parse the parts; with none, the parser reads them itself
+  }
+}
+
+libvisio::VSDXParsedParts::~VSDXParsedParts()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopped = true;
+  }
+  m_condition.notify_all();
+  for (auto &thread : m_threads)
+    thread.join();
+}
+
+libvisio::VSDXParsedParts::Document_t libvisio::VSDXParsedParts::take(const std::string &name)
+{
+  auto index = m_partIndices.find(name);
+  if (index == m_partIndices.end() || m_threads.empty())
+    return Document_t(nullptr, xmlFreeDoc);
+  Part &part = m_parts[index->second];
+  const std::size_t partIndex = index->second;
+  m_partIndices.erase(index);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_firstNeeded = std::max(m_firstNeeded, partIndex);
+  m_condition.notify_all();
+  m_condition.wait(lock, [&part]()
+  {
+    return part.isParsed;
+  });
+  m_firstNeeded = std::max(m_firstNeeded, partIndex + 1);
+  m_condition.notify_all();
+  return std::move(part.document);
+}
+
+void libvisio::VSDXParsedParts::_parseParts()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_condition.wait(lock, [this]()
+    {
+      return m_isStopped || m_nextPart >= m_parts.size() || m_nextPart < m_firstNeeded + m_window;
+    });
+    if (m_isStopped || m_nextPart >= m_parts.size())
+      return;
+    Part &part = m_parts[m_nextPart++];
+    lock.unlock();
+
+    Document_t document(nullptr, xmlFreeDoc);
+    try
+    {
+      document = parsePart(*part.data);
+    }
+    catch (...)
+    {
+    }
+
+    lock.lock();
+    part.document = std::move(document);
+    part.isParsed = true;
+    m_condition.notify_all();
+  }
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,74 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __VSDXPARSEDPARTS_H__
+#define __VSDXPARSEDPARTS_H__
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <libxml/tree.h>
+#include "VSDXPackage.h"
+
+namespace libvisio
+{
+
+// XML parts parsed into trees on worker threads, a few parts ahead of the
+// parser, which then only walks the trees. A part whose tree would not read
+// exactly like the part itself is not handed out; the parser reads that one
+// from its data as usual.
+class VSDXParsedParts
+{
+public:
+  typedef std::unique_ptr<xmlDoc, void (*)(xmlDocPtr)> Document_t;
+
+  VSDXParsedParts(const std::vector<std::pair<std::string, VSDXPackage::Buffer_t> > &parts, unsigned threadCount);
+  ~VSDXParsedParts();
+
+  // Waits for the tree of the part, nullptr if it is not available
+  Document_t take(const std::string &name);
+
+private:
+  VSDXParsedParts(const VSDXParsedParts &);
+  VSDXParsedParts &operator=(const VSDXParsedParts &);
+
+  struct Part
+  {
+    Part(const std::string &n, const VSDXPackage::Buffer_t &d)
+      : name(n), data(d), document(nullptr, xmlFreeDoc), isParsed(false) {}
+
+    std::string name;
+    VSDXPackage::Buffer_t data;
+    Document_t document;
+    bool isParsed;
+  };
+
+  void _parseParts();
+
+  std::vector<Part> m_parts;
+  std::map<std::string, std::size_t> m_partIndices;
+  // Parts are parsed in order, at most m_window parts ahead of the parser
+  std::size_t m_nextPart;
+  std::size_t m_firstNeeded;
+  std::size_t m_window;
+  bool m_isStopped;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace libvisio
+
+#endif // __VSDXPARSEDPARTS_H__
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -9,6 +9,8 @@
 
 #include "VSDXParser.h"
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string.h>
 #include <libxml/xmlIO.h>
@@ -17,44 +19,22 @@
 #include "libvisio_utils.h"
 #include "libvisio_xml.h"
 #include "VSDContentCollector.h"
+#include "VSDRecordingCollector.h"
 #include "VSDStylesCollector.h"
 #include "VSDXMLHelper.h"
 #include "VSDXMLTokenMap.h"
 #include "VSDXMetaData.h"
-
-namespace
-{
-static std::string getTargetBaseDirectory(const char *target)
-{
-  std::string str(target);
-  std::string::size_type position = str.find_last_of('/');
-  if (position == std::string::npos)
-    position = 0;
-  str.erase(position ? position+1 : position);
-  return str;
-}
-
-std::string getRelationshipsForTarget(const char *target)
-{
-  std::string relStr(target ? target : "");
-  std::string::size_type position = relStr.find_last_of('/');
-  if (position == std::string::npos)
-    position = 0;
-  relStr.insert(position ? position+1 : position, "_rels/");
-  relStr.append(".rels");
-  return relStr;
-}
-
-} // anonymous namespace
-
+#include "VSDXParsedParts.h"
 
 libvisio::VSDXParser::VSDXParser(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter)
   : VSDXMLParserBase(),
     m_input(input),
+    m_package(input),
     m_painter(painter),
     m_currentDepth(0),
     m_rels(nullptr),
-    m_currentTheme()
+    m_currentTheme(),
+    m_parsedPages(nullptr)
 {
 }
 
@@ -67,8 +47,7 @@ bool libvisio::VSDXParser::parseMain() try
   if (!m_input || !m_input->isStructured())
     return false;
 
-  RVNGInputStreamPtr_t tmpInput;
-  tmpInput.reset(m_input->getSubStreamByName("_rels/.rels"));
+  const RVNGInputStreamPtr_t tmpInput(m_package.getPart("_rels/.rels"));
   if (!tmpInput)
     return false;
 
@@ -84,25 +63,59 @@ bool libvisio::VSDXParser::parseMain() try
   std::vector<std::list<unsigned> > documentPageShapeOrders;
 
   VSDStylesCollector stylesCollector(groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders);
-  m_collector = &stylesCollector;
-  if (!parseDocument(m_input, rel->getTarget().c_str()))
+  VSDRecordingCollector recordingCollector(&stylesCollector, m_maxRecordSize);
+  if (m_singlePass)
+  {
+    // Record the calls the content collector would get from a 2nd pass,
+    // starting with the metadata
+    m_recorder = &recordingCollector;
+    m_collector = &recordingCollector;
+    parseMetaData(rootRels);
+  }
+  else
+    m_collector = &stylesCollector;
+  m_isFirstPass = true;
+  if (!parseDocument(rel->getTarget().c_str()))
+  {
+    m_isFirstPass = false;
+    m_recorder = nullptr;
     return false;
+  }
+  m_isFirstPass = false;
+  m_recorder = nullptr;
 
   VSDStyles styles = stylesCollector.getStyleSheets();
   const std::optional<unsigned> varColInd = stylesCollector.getvariationColorIndex();
   const std::optional<unsigned> varStyInd = stylesCollector.getvariationStyleIndex();
 
   VSDContentCollector contentCollector(m_painter, groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders, styles, m_stencils, varColInd, varStyInd);
+  contentCollector.setPageSelection(m_pageSelection);
+  contentCollector.setPagesOutput(m_pagesOutput);
+  contentCollector.setParseOptions(m_parseOptions);
   m_collector = &contentCollector;
-  parseMetaData(m_input, rootRels);
+  if (m_singlePass && !recordingCollector.isDiscarded())
+  {
+    const auto createCollector = [&]()
+    {
+      std::unique_ptr<VSDContentCollector> collector(
+        new VSDContentCollector(nullptr, groupXFormsSequence, groupMembershipsSequence, documentPageShapeOrders, styles, m_stencils, varColInd, varStyInd));
+      collector->setParseOptions(m_parseOptions);
+      return collector;
+    };
+    return replay(recordingCollector, contentCollector, createCollector);
+  }
+
+  parseMetaData(rootRels);
 
-  if (!parseDocument(m_input, rel->getTarget().c_str()))
+  if (!parseDocument(rel->getTarget().c_str()))
     return false;
 
   return true;
 }
 catch (...)
 {
+  m_isFirstPass = false;
+  m_recorder = nullptr;
   return false;
 }
 
@@ -112,33 +125,27 @@ bool libvisio::VSDXParser::extractStencils()
   return parseMain();
 }
 
-bool libvisio::VSDXParser::parseDocument(librevenge::RVNGInputStream *input, const char *name)
+bool libvisio::VSDXParser::parseDocument(const char *name)
 {
-  if (!input)
-    return false;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return false;
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
-  input->seek(0, librevenge::RVNG_SEEK_SET);
+  const RVNGInputStreamPtr_t stream(m_package.getPart(name));
   if (!stream)
     return false;
-  const RVNGInputStreamPtr_t relStream(input->getSubStreamByName(getRelationshipsForTarget(name).c_str()));
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  VSDXRelationships rels(relStream.get());
-  rels.rebaseTargets(getTargetBaseDirectory(name).c_str());
+  const VSDXRelationships &rels = m_package.getRelationships(name);
+  // Inflate the parts the document refers to while the parser is busy with the earlier ones
+  // When only some pages are needed, they are prefetched once parsePages knows which
+  if (m_parseOptions.getThreadCount() > 1)
+    m_package.prefetch(name, !m_pageSelection.isActive() || m_extractStencils);
 
   const VSDXRelationship *rel = rels.getRelationshipByType("http://schemas.openxmlformats.org/officeDocument/2006/relationships/theme");
   if (rel)
   {
-    if (!parseTheme(input, rel->getTarget().c_str()))
+    if (!parseTheme(rel->getTarget().c_str()))
     {
       VSD_DEBUG_MSG(("Could not parse theme\n"));
       m_collector->collectDocumentTheme(nullptr);
     }
     else
       m_collector->collectDocumentTheme(&m_currentTheme);
-    input->seek(0, librevenge::RVNG_SEEK_SET);
   }
 
   processXmlDocument(stream.get(), rels);
@@ -146,114 +153,165 @@ bool libvisio::VSDXParser::parseDocument(librevenge::RVNGInputStream *input, con
   rel = rels.getRelationshipByType("http://schemas.microsoft.com/visio/2010/relationships/masters");
   if (rel)
   {
-    if (!parseMasters(input, rel->getTarget().c_str()))
+    if (!parseMasters(rel->getTarget().c_str()))
     {
       VSD_DEBUG_MSG(("Could not parse masters\n"));
     }
-    input->seek(0, librevenge::RVNG_SEEK_SET);
   }
 
   rel = rels.getRelationshipByType("http://schemas.microsoft.com/visio/2010/relationships/pages");
   if (rel)
   {
-    if (!parsePages(input, rel->getTarget().c_str()))
+    if (!parsePages(rel->getTarget().c_str()))
     {
       VSD_DEBUG_MSG(("Could not parse pages\n"));
     }
-    input->seek(0, librevenge::RVNG_SEEK_SET);
   }
 
   return true;
 }
 
-bool libvisio::VSDXParser::parseMasters(librevenge::RVNGInputStream *input, const char *name)
+bool libvisio::VSDXParser::parseMasters(const char *name)
 {
-  if (!input)
-    return false;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return false;
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
+  const RVNGInputStreamPtr_t stream(m_package.getPart(name));
   if (!stream)
     return false;
-  const RVNGInputStreamPtr_t relStream(input->getSubStreamByName(getRelationshipsForTarget(name).c_str()));
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  VSDXRelationships rels(relStream.get());
-  rels.rebaseTargets(getTargetBaseDirectory(name).c_str());
 
-  processXmlDocument(stream.get(), rels);
+  processXmlDocument(stream.get(), m_package.getRelationships(name));
 
   return true;
 }
 
-bool libvisio::VSDXParser::parseMaster(librevenge::RVNGInputStream *input, const char *name)
+bool libvisio::VSDXParser::parseMaster(const char *name)
 {
-  if (!input)
-    return false;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return false;
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
+  const RVNGInputStreamPtr_t stream(m_package.getPart(name));
   if (!stream)
     return false;
-  const RVNGInputStreamPtr_t relStream(input->getSubStreamByName(getRelationshipsForTarget(name).c_str()));
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  VSDXRelationships rels(relStream.get());
-  rels.rebaseTargets(getTargetBaseDirectory(name).c_str());
 
-  processXmlDocument(stream.get(), rels);
+  processXmlDocument(stream.get(), m_package.getRelationships(name));
 
   return true;
 }
 
-bool libvisio::VSDXParser::parsePages(librevenge::RVNGInputStream *input, const char *name)
+void libvisio::VSDXParser::parseMasterPart(const std::string &name)
 {
-  if (!input)
-    return false;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return false;
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
+  if (!m_isStencilStarted || !m_currentStencil)
+  {
+    parseMaster(name.c_str());
+    return;
+  }
+
+  auto part = m_masterParts.find(name);
+  if (part == m_masterParts.end())
+  {
+    // Read the part into a stencil of its own; NaN marks the shadow offsets it does not set
+    std::unique_ptr<VSDStencil> stencil(std::move(m_currentStencil));
+    m_currentStencil.reset(new VSDStencil());
+    m_currentStencil->m_shadowOffsetX = std::numeric_limits<double>::quiet_NaN();
+    m_currentStencil->m_shadowOffsetY = std::numeric_limits<double>::quiet_NaN();
+    try
+    {
+      parseMaster(name.c_str());
+    }
+    catch (...)
+    {
+      m_currentStencil = std::move(stencil);
+      throw;
+    }
+    part = m_masterParts.insert(std::make_pair(name, m_currentStencil ? *m_currentStencil : VSDStencil())).first;
+    m_currentStencil = std::move(stencil);
+  }
+
+  const VSDStencil &partStencil = part->second;
+  for (const auto &shape : partStencil.m_shapes)
+    m_currentStencil->addStencilShape(shape.first, shape.second);
+  if (partStencil.m_firstShapeId != MINUS_ONE)
+    m_currentStencil->setFirstShape(partStencil.m_firstShapeId);
+  if (!std::isnan(partStencil.m_shadowOffsetX))
+    m_currentStencil->m_shadowOffsetX = partStencil.m_shadowOffsetX;
+  if (!std::isnan(partStencil.m_shadowOffsetY))
+    m_currentStencil->m_shadowOffsetY = partStencil.m_shadowOffsetY;
+}
+
+bool libvisio::VSDXParser::parsePages(const char *name)
+{
+  const RVNGInputStreamPtr_t stream(m_package.getPart(name));
   if (!stream)
     return false;
-  const RVNGInputStreamPtr_t relStream(input->getSubStreamByName(getRelationshipsForTarget(name).c_str()));
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  VSDXRelationships rels(relStream.get());
-  rels.rebaseTargets(getTargetBaseDirectory(name).c_str());
+  const VSDXRelationships &rels = m_package.getRelationships(name);
 
-  processXmlDocument(stream.get(), rels);
+  if (m_pageSelection.isActive() && !m_extractStencils)
+  {
+    std::vector<std::string> pageRels;
+    scanPages(stream.get(), &pageRels);
+    if (m_parseOptions.getThreadCount() > 1)
+    {
+      std::vector<std::string> pageParts;
+      for (const auto &id : pageRels)
+      {
+        const VSDXRelationship *rel = rels.getRelationshipById(id.c_str());
+        if (rel && rel->getType() == "http://schemas.microsoft.com/visio/2010/relationships/page")
+          pageParts.push_back(rel->getTarget());
+      }
+      if (!pageParts.empty())
+        m_package.prefetchParts(pageParts);
+    }
+  }
+
+  // With more threads, the page parts are parsed ahead on them
+  std::unique_ptr<VSDXParsedParts> parsedPages;
+  if (m_parseOptions.getThreadCount() > 1 && !m_extractStencils && !m_pageSelection.isActive())
+  {
+    std::vector<std::pair<std::string, VSDXPackage::Buffer_t> > pages;
+    for (const VSDXRelationship *rel : rels.getRelationshipsByType("http://schemas.microsoft.com/visio/2010/relationships/page"))
+      pages.push_back(std::make_pair(rel->getTarget(), m_package.getPartData(rel->getTarget())));
+    parsedPages.reset(new VSDXParsedParts(pages, m_parseOptions.getThreadCount()));
+  }
+
+  m_parsedPages = parsedPages.get();
+  try
+  {
+    processXmlDocument(stream.get(), rels);
+  }
+  catch (...)
+  {
+    m_parsedPages = nullptr;
+    throw;
+  }
+  m_parsedPages = nullptr;
 
   return true;
 }
 
-bool libvisio::VSDXParser::parsePage(librevenge::RVNGInputStream *input, const char *name)
+bool libvisio::VSDXParser::parsePage(const char *name)
 {
-  if (!input)
-    return false;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return false;
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
+  if (m_parsedPages)
+  {
+    const VSDXParsedParts::Document_t document = m_parsedPages->take(name);
+    if (document)
+    {
+      const std::unique_ptr<xmlTextReader, void (*)(xmlTextReaderPtr)> reader(xmlReaderWalker(document.get()), xmlFreeTextReader);
+      if (reader)
+      {
+        XMLErrorWatcher watcher;
+        processXmlReader(reader.get(), watcher, m_package.getRelationships(name));
+        return true;
+      }
+    }
+  }
+
+  const RVNGInputStreamPtr_t stream(m_package.getPart(name));
   if (!stream)
     return false;
-  const RVNGInputStreamPtr_t relStream(input->getSubStreamByName(getRelationshipsForTarget(name).c_str()));
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  VSDXRelationships rels(relStream.get());
-  rels.rebaseTargets(getTargetBaseDirectory(name).c_str());
 
-  processXmlDocument(stream.get(), rels);
+  processXmlDocument(stream.get(), m_package.getRelationships(name));
 
   return true;
 }
 
-bool libvisio::VSDXParser::parseTheme(librevenge::RVNGInputStream *input, const char *name)
+bool libvisio::VSDXParser::parseTheme(const char *name)
 {
-  if (!input)
-    return false;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return false;
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
+  const RVNGInputStreamPtr_t stream(m_package.getPart(name));
   if (!stream)
     return false;
 
@@ -262,19 +320,13 @@ bool libvisio::VSDXParser::parseTheme(librevenge::RVNGInputStream *input, const
   return true;
 }
 
-void libvisio::VSDXParser::parseMetaData(librevenge::RVNGInputStream *input, libvisio::VSDXRelationships &rels) try
+void libvisio::VSDXParser::parseMetaData(const VSDXRelationships &rels) try
 {
-  if (!input)
-    return;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  if (!input->isStructured())
-    return;
-
   VSDXMetaData metaData;
   const libvisio::VSDXRelationship *coreProp = rels.getRelationshipByType("http://schemas.openxmlformats.org/package/2006/relationships/metadata/core-properties");
   if (coreProp)
   {
-    const RVNGInputStreamPtr_t stream(input->getSubStreamByName(coreProp->getTarget().c_str()));
+    const RVNGInputStreamPtr_t stream(m_package.getPart(coreProp->getTarget()));
     if (stream)
     {
       metaData.parse(stream.get());
@@ -284,7 +336,7 @@ void libvisio::VSDXParser::parseMetaData(librevenge::RVNGInputStream *input, lib
   const libvisio::VSDXRelationship *extendedProp = rels.getRelationshipByType("http://schemas.openxmlformats.org/officeDocument/2006/relationships/extended-properties");
   if (extendedProp)
   {
-    const RVNGInputStreamPtr_t stream(input->getSubStreamByName(extendedProp->getTarget().c_str()));
+    const RVNGInputStreamPtr_t stream(m_package.getPart(extendedProp->getTarget()));
     if (stream)
     {
       metaData.parse(stream.get());
@@ -297,36 +349,41 @@ catch (...)
   // Ignore any exceptions in metadata. They are not important enough to stop parsing.
 }
 
-void libvisio::VSDXParser::processXmlDocument(librevenge::RVNGInputStream *input, VSDXRelationships &rels)
+void libvisio::VSDXParser::processXmlDocument(librevenge::RVNGInputStream *input, const VSDXRelationships &rels)
 {
   if (!input)
     return;
 
-  m_rels = &rels;
-
   XMLErrorWatcher watcher;
 
   auto reader = xmlReaderForStream(input, &watcher, false);
   if (!reader)
     return;
 
+  processXmlReader(reader.get(), watcher, rels);
+}
+
+void libvisio::VSDXParser::processXmlReader(xmlTextReaderPtr reader, XMLErrorWatcher &watcher, const VSDXRelationships &rels)
+{
   XMLErrorWatcher *oldWatcher = m_watcher;
+  const VSDXRelationships *oldRels = m_rels;
   try
   {
     m_watcher = &watcher;
+    m_rels = &rels;
 
-    int ret = xmlTextReaderRead(reader.get());
+    int ret = xmlTextReaderRead(reader);
     while (1 == ret && !watcher.isError())
     {
-      int tokenId = VSDXMLTokenMap::getTokenId(xmlTextReaderConstName(reader.get()));
-      int tokenType = xmlTextReaderNodeType(reader.get());
+      int tokenId = VSDXMLTokenMap::getTokenId(xmlTextReaderConstName(reader));
+      int tokenType = xmlTextReaderNodeType(reader);
 
       switch (tokenId)
       {
       case XML_REL:
         if (XML_READER_TYPE_ELEMENT == tokenType)
         {
-          std::shared_ptr<xmlChar> id(xmlTextReaderGetAttribute(reader.get(), BAD_CAST("r:id")), xmlFree);
+          std::shared_ptr<xmlChar> id(xmlTextReaderGetAttribute(reader, BAD_CAST("r:id")), xmlFree);
           if (id)
           {
             const VSDXRelationship *rel = rels.getRelationshipById((char *)id.get());
@@ -339,17 +396,17 @@ void libvisio::VSDXParser::processXmlDocument(librevenge::RVNGInputStream *input
                 const auto inserted = m_visitedParts.insert(target);
                 if (inserted.second)
                 {
-                  m_currentDepth += xmlTextReaderDepth(reader.get());
+                  m_currentDepth += xmlTextReaderDepth(reader);
                   try
                   {
-                    parseMaster(m_input, target.c_str());
+                    parseMasterPart(target);
                   }
                   catch (...)
                   {
                     m_visitedParts.erase(inserted.first);
                     throw;
                   }
-                  m_currentDepth -= xmlTextReaderDepth(reader.get());
+                  m_currentDepth -= xmlTextReaderDepth(reader);
                   m_visitedParts.erase(inserted.first);
                 }
               }
@@ -359,42 +416,44 @@ void libvisio::VSDXParser::processXmlDocument(librevenge::RVNGInputStream *input
                 const auto inserted = m_visitedParts.insert(target);
                 if (inserted.second)
                 {
-                  m_currentDepth += xmlTextReaderDepth(reader.get());
+                  m_currentDepth += xmlTextReaderDepth(reader);
                   try
                   {
-                    parsePage(m_input, target.c_str());
+                    parsePage(target.c_str());
                   }
                   catch (...)
                   {
                     m_visitedParts.erase(inserted.first);
                     throw;
                   }
-                  m_currentDepth -= xmlTextReaderDepth(reader.get());
+                  m_currentDepth -= xmlTextReaderDepth(reader);
                   m_visitedParts.erase(inserted.first);
                 }
               }
               else if (type == "http://schemas.openxmlformats.org/officeDocument/2006/relationships/image")
               {
-                extractBinaryData(m_input, rel->getTarget().c_str());
+                extractBinaryData(rel->getTarget().c_str());
               }
               else
-                processXmlNode(reader.get());
+                processXmlNode(reader);
             }
           }
         }
         break;
       default:
-        processXmlNode(reader.get());
+        processXmlNode(reader);
         break;
       }
-      ret = xmlTextReaderRead(reader.get());
+      ret = xmlTextReaderRead(reader);
     }
 
     m_watcher = oldWatcher;
+    m_rels = oldRels;
   }
   catch (...)
   {
     m_watcher = oldWatcher;
+    m_rels = oldRels;
     throw;
   }
 }
@@ -556,26 +615,13 @@ void libvisio::VSDXParser::processXmlNode(xmlTextReaderPtr reader)
 #endif
 }
 
-#define VSDX_DATA_READ_SIZE 4096UL
-
-void libvisio::VSDXParser::extractBinaryData(librevenge::RVNGInputStream *input, const char *name)
+void libvisio::VSDXParser::extractBinaryData(const char *name)
 {
   m_currentBinaryData.clear();
-  if (!input || !input->isStructured())
-    return;
-  input->seek(0, librevenge::RVNG_SEEK_SET);
-  const RVNGInputStreamPtr_t stream(input->getSubStreamByName(name));
-  if (!stream)
+  const VSDXPackage::Buffer_t buffer = m_package.getPartData(name);
+  if (!buffer || buffer->empty())
     return;
-  while (true)
-  {
-    unsigned long numBytesRead;
-    const unsigned char *buffer = stream->read(VSDX_DATA_READ_SIZE, numBytesRead);
-    if (numBytesRead)
-      m_currentBinaryData.append(buffer, numBytesRead);
-    if (stream->isEnd())
-      break;
-  }
+  m_currentBinaryData.append(buffer->data(), buffer->size());
   VSD_DEBUG_MSG(("%s\n", m_currentBinaryData.getBase64Data().cstr()));
 }
 
@@ -590,41 +636,47 @@ xmlChar *libvisio::VSDXParser::readStringData(xmlTextReaderPtr reader)
   return nullptr;
 }
 
+const xmlChar *libvisio::VSDXParser::readConstStringData(xmlTextReaderPtr reader, std::unique_ptr<xmlChar, void (*)(void *)> &copy)
+{
+  return xmlReaderConstAttribute(reader, "V", copy);
+}
+
 int libvisio::VSDXParser::getElementToken(xmlTextReaderPtr reader)
 {
   int tokenId = VSDXMLTokenMap::getTokenId(xmlTextReaderConstName(reader));
   if (XML_READER_TYPE_END_ELEMENT == xmlTextReaderNodeType(reader))
     return tokenId;
 
-  std::unique_ptr<xmlChar, decltype(xmlFree)> stringValue(nullptr, xmlFree);
+  std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+  const xmlChar *stringValue = nullptr;
 
   switch (tokenId)
   {
   case XML_CELL:
-    stringValue.reset(xmlTextReaderGetAttribute(reader, BAD_CAST("N")));
+    stringValue = xmlReaderConstAttribute(reader, "N", copy);
     if (stringValue)
     {
-      tokenId = VSDXMLTokenMap::getTokenId(stringValue.get());
+      tokenId = VSDXMLTokenMap::getTokenId(stringValue);
       if (tokenId == XML_TOKEN_INVALID)
       {
-        if (*stringValue.get() == 'P' && !strncmp((char *)stringValue.get(), "Position", 8))
+        if (*stringValue == 'P' && !strncmp((const char *)stringValue, "Position", 8))
           tokenId = XML_POSITION;
-        else if (*stringValue.get() == 'A' && !strncmp((char *)stringValue.get(), "Alignment", 9))
+        else if (*stringValue == 'A' && !strncmp((const char *)stringValue, "Alignment", 9))
           tokenId = XML_ALIGNMENT;
       }
     }
     break;
   case XML_ROW:
-    stringValue.reset(xmlTextReaderGetAttribute(reader, BAD_CAST("N")));
+    stringValue = xmlReaderConstAttribute(reader, "N", copy);
     if (!stringValue)
-      stringValue.reset(xmlTextReaderGetAttribute(reader, BAD_CAST("T")));
+      stringValue = xmlReaderConstAttribute(reader, "T", copy);
     if (stringValue)
-      tokenId = VSDXMLTokenMap::getTokenId(stringValue.get());
+      tokenId = VSDXMLTokenMap::getTokenId(stringValue);
     break;
   case XML_SECTION:
-    stringValue.reset(xmlTextReaderGetAttribute(reader, BAD_CAST("N")));
+    stringValue = xmlReaderConstAttribute(reader, "N", copy);
     if (stringValue)
-      tokenId = VSDXMLTokenMap::getTokenId(stringValue.get());
+      tokenId = VSDXMLTokenMap::getTokenId(stringValue);
     break;
   default:
     break;
@@ -1000,6 +1052,11 @@ void libvisio::VSDXParser::readShapeProperties(xmlTextReaderPtr reader)
       VSD_DEBUG_MSG(("VSDXParser::readShapeProperties: unknown token %s\n", xmlTextReaderConstName(reader)));
     }
     tokenType = xmlTextReaderNodeType(reader);
+    if (XML_READER_TYPE_ELEMENT == tokenType && _isSkeletonScan() && _isContentElement(tokenId))
+    {
+      ret = skipElement(reader);
+      continue;
+    }
     switch (tokenId)
     {
     case XML_PINX:
@@ -1520,7 +1577,7 @@ void libvisio::VSDXParser::getBinaryData(xmlTextReaderPtr reader)
       {
         if ("http://schemas.openxmlformats.org/officeDocument/2006/relationships/image" == rel->getType()
             || "http://schemas.openxmlformats.org/officeDocument/2006/relationships/oleObject" == rel->getType())
-          extractBinaryData(m_input, rel->getTarget().c_str());
+          extractBinaryData(rel->getTarget().c_str());
       }
     }
   }
@@ -10,16 +10,19 @@
 #ifndef __VSDXPARSER_H__
 #define __VSDXPARSER_H__
 
+#include <map>
 #include <set>
 #include <string>
 #include <librevenge/librevenge.h>
 #include "VSDXTheme.h"
 #include "VSDXMLParserBase.h"
+#include "VSDXPackage.h"
 
 namespace libvisio
 {
 
 class VSDCollector;
+class VSDXParsedParts;
 
 class VSDXParser : public VSDXMLParserBase
 {
@@ -44,6 +47,7 @@ private:
   // Helper functions
 
   xmlChar *readStringData(xmlTextReaderPtr reader) override;
+  const xmlChar *readConstStringData(xmlTextReaderPtr reader, std::unique_ptr<xmlChar, void (*)(void *)> &copy) override;
 
   int getElementToken(xmlTextReaderPtr reader) override;
   int getElementDepth(xmlTextReaderPtr reader) override;
@@ -52,19 +56,21 @@ private:
 
   // Functions parsing the Visio 2013 OPC document structure
 
-  bool parseDocument(librevenge::RVNGInputStream *input, const char *name);
-  bool parseMasters(librevenge::RVNGInputStream *input, const char *name);
-  bool parseMaster(librevenge::RVNGInputStream *input, const char *name);
-  bool parsePages(librevenge::RVNGInputStream *input, const char *name);
-  bool parsePage(librevenge::RVNGInputStream *input, const char *name);
-  bool parseTheme(librevenge::RVNGInputStream *input, const char *name);
-  void parseMetaData(librevenge::RVNGInputStream *input, VSDXRelationships &rels);
-  void processXmlDocument(librevenge::RVNGInputStream *input, VSDXRelationships &rels);
+  bool parseDocument(const char *name);
+  bool parseMasters(const char *name);
+  bool parseMaster(const char *name);
+  void parseMasterPart(const std::string &name);
+  bool parsePages(const char *name);
+  bool parsePage(const char *name);
+  bool parseTheme(const char *name);
+  void parseMetaData(const VSDXRelationships &rels);
+  void processXmlDocument(librevenge::RVNGInputStream *input, const VSDXRelationships &rels);
+  void processXmlReader(xmlTextReaderPtr reader, XMLErrorWatcher &watcher, const VSDXRelationships &rels);
   void processXmlNode(xmlTextReaderPtr reader);
 
   // Functions reading the Visio 2013 OPC document content
 
-  void extractBinaryData(librevenge::RVNGInputStream *input, const char *name);
+  void extractBinaryData(const char *name);
 
   void readPageSheetProperties(xmlTextReaderPtr reader);
 
@@ -84,12 +90,17 @@ private:
   // Private data
 
   librevenge::RVNGInputStream *m_input;
+  VSDXPackage m_package;
   librevenge::RVNGDrawingInterface *m_painter;
   int m_currentDepth;
-  VSDXRelationships *m_rels;
+  const VSDXRelationships *m_rels;
   VSDXTheme m_currentTheme;
   // parsePage / parseMaster targets currently on the recursion stack
   std::set<std::string> m_visitedParts;
+  // Stencil read from each master part, by part name
+  std::map<std::string, VSDStencil> m_masterParts;
+  // Page parts being parsed ahead while the page list is read
+  VSDXParsedParts *m_parsedPages;
 };
 
 } // namespace libvisio
@@ -85,7 +85,9 @@ class VSDXTheme
 {
 public:
   VSDXTheme();
+  VSDXTheme(const VSDXTheme &theme) = default;
   ~VSDXTheme();
+  VSDXTheme &operator=(const VSDXTheme &theme) = default;
   bool parse(librevenge::RVNGInputStream *input);
   std::optional<Colour> getThemeColour(unsigned value, unsigned variationIndex = 0) const;
   std::optional<Colour> getStyleColour(unsigned value, unsigned variationIndex = 0) const;
@@ -93,9 +95,6 @@ public:
   size_t getFillStyleLstSize() const { return m_fillStyleLst.size(); }
 
 private:
-  VSDXTheme(const VSDXTheme &);
-  VSDXTheme &operator=(const VSDXTheme &);
-
   std::optional<Colour> readSrgbClr(xmlTextReaderPtr reader);
   std::optional<Colour> readSysClr(xmlTextReaderPtr reader);
   std::optional<Colour> readSchemeClr(xmlTextReaderPtr reader);
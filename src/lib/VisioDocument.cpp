@@ -12,11 +12,13 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include <librevenge/librevenge.h>
 #include "libvisio_utils.h"
 #include "libvisio_xml.h"
 #include "VDXParser.h"
+#include "VSDPages.h"
 #include "VSDParser.h"
 #include "VSDXParser.h"
 #include "VSD5Parser.h"
@@ -74,7 +76,7 @@ catch (...)
   return false;
 }
 
-static bool parseBinaryVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, bool isStencilExtraction) try
+static bool parseBinaryVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, bool isStencilExtraction, const libvisio::VSDPageSelection &pageSelection, const libvisio::VisioParseOptions &options = libvisio::VisioParseOptions(), libvisio::VSDPages *pagesOutput = nullptr) try
 {
   VSD_DEBUG_MSG(("Parsing Binary Visio Document\n"));
   input->seek(0, librevenge::RVNG_SEEK_SET);
@@ -108,6 +110,9 @@ static bool parseBinaryVisioDocument(librevenge::RVNGInputStream *input, libreve
     break;
   }
 
+  parser->setPageSelection(pageSelection);
+  parser->setParseOptions(options);
+  parser->setPagesOutput(pagesOutput);
   if (isStencilExtraction)
     return parser->extractStencils();
   else
@@ -144,11 +149,14 @@ catch (...)
   return false;
 }
 
-static bool parseOpcVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, bool isStencilExtraction) try
+static bool parseOpcVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, bool isStencilExtraction, const libvisio::VSDPageSelection &pageSelection, const libvisio::VisioParseOptions &options = libvisio::VisioParseOptions(), libvisio::VSDPages *pagesOutput = nullptr) try
 {
   VSD_DEBUG_MSG(("Parsing Visio Document based on Open Packaging Convention\n"));
   input->seek(0, librevenge::RVNG_SEEK_SET);
   libvisio::VSDXParser parser(input, painter);
+  parser.setPageSelection(pageSelection);
+  parser.setParseOptions(options);
+  parser.setPagesOutput(pagesOutput);
   if (isStencilExtraction && parser.extractStencils())
     return true;
   else if (!isStencilExtraction && parser.parseMain())
@@ -189,11 +197,14 @@ catch (...)
   return false;
 }
 
-static bool parseXmlVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, bool isStencilExtraction) try
+static bool parseXmlVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, bool isStencilExtraction, const libvisio::VSDPageSelection &pageSelection, const libvisio::VisioParseOptions &options = libvisio::VisioParseOptions(), libvisio::VSDPages *pagesOutput = nullptr) try
 {
   VSD_DEBUG_MSG(("Parsing Visio DrawingML Document\n"));
   input->seek(0, librevenge::RVNG_SEEK_SET);
   libvisio::VDXParser parser(input, painter);
+  parser.setPageSelection(pageSelection);
+  parser.setParseOptions(options);
+  parser.setPagesOutput(pagesOutput);
   if (isStencilExtraction && parser.extractStencils())
     return true;
   else if (!isStencilExtraction && parser.parseMain())
@@ -205,6 +216,29 @@ catch (...)
   return false;
 }
 
+static bool parseVisioDocument(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const libvisio::VSDPageSelection &pageSelection, const libvisio::VisioParseOptions &options, libvisio::VSDPages *pagesOutput = nullptr)
+{
+  if (isBinaryVisioDocument(input))
+  {
+    if (parseBinaryVisioDocument(input, painter, false, pageSelection, options, pagesOutput))
+      return true;
+    return false;
+  }
+  if (isOpcVisioDocument(input))
+  {
+    if (parseOpcVisioDocument(input, painter, false, pageSelection, options, pagesOutput))
+      return true;
+    return false;
+  }
+  if (isXmlVisioDocument(input))
+  {
+    if (parseXmlVisioDocument(input, painter, false, pageSelection, options, pagesOutput))
+      return true;
+    return false;
+  }
+  return false;
+}
+
 } // anonymous namespace
 
 
@@ -241,25 +275,85 @@ VSDAPI bool libvisio::VisioDocument::parse(librevenge::RVNGInputStream *input, l
   if (!input || !painter)
     return false;
 
-  if (isBinaryVisioDocument(input))
-  {
-    if (parseBinaryVisioDocument(input, painter, false))
-      return true;
+  return parseVisioDocument(input, painter, libvisio::VSDPageSelection(), libvisio::VisioParseOptions());
+}
+
+/**
+Parses the input stream content like parse(), with the given options.
+\param input The input stream
+\param painter A WPGPainterInterface implementation
+\param options The options, e.g. how curves are output
+\return A value that indicates whether the parsing was successful
+*/
+VSDAPI bool libvisio::VisioDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const VisioParseOptions &options)
+{
+  if (!input || !painter)
     return false;
-  }
-  if (isOpcVisioDocument(input))
-  {
-    if (parseOpcVisioDocument(input, painter, false))
-      return true;
+
+  return parseVisioDocument(input, painter, libvisio::VSDPageSelection(), options);
+}
+
+/**
+Parses the input stream content like parse(), but only the pages whose positions are listed in
+the page selection. Pages are numbered from 0, foreground pages in the order of the document
+first, followed by background pages. Background pages needed by the selected pages are parsed
+as well, but they are only output if they are selected themselves.
+\param input The input stream
+\param painter A WPGPainterInterface implementation
+\param pageSelection The positions of the pages to output
+\return A value that indicates whether the parsing was successful
+*/
+VSDAPI bool libvisio::VisioDocument::parsePages(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const std::vector<unsigned> &pageSelection)
+{
+  if (!input || !painter || pageSelection.empty())
     return false;
-  }
-  if (isXmlVisioDocument(input))
-  {
-    if (parseXmlVisioDocument(input, painter, false))
-      return true;
+
+  return parseVisioDocument(input, painter, libvisio::VSDPageSelection(pageSelection), libvisio::VisioParseOptions());
+}
+
+/**
+Parses the selected pages like parsePages(), with the given options.
+\param input The input stream
+\param painter A WPGPainterInterface implementation
+\param pageSelection The positions of the pages to output
+\param options The options, e.g. how curves are output
+\return A value that indicates whether the parsing was successful
+*/
+VSDAPI bool libvisio::VisioDocument::parsePages(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const std::vector<unsigned> &pageSelection, const VisioParseOptions &options)
+{
+  if (!input || !painter || pageSelection.empty())
     return false;
-  }
-  return false;
+
+  return parseVisioDocument(input, painter, libvisio::VSDPageSelection(pageSelection), options);
+}
+
+/**
+Parses the input stream content once and keeps the result, so that it can be output several
+times, to several painters, without parsing it again.
+\param input The input stream
+\return A handle to the loaded document, or a null pointer if the parsing was not successful
+*/
+VSDAPI std::shared_ptr<const libvisio::VisioDocumentHandle> libvisio::VisioDocument::load(librevenge::RVNGInputStream *input)
+{
+  return load(input, VisioParseOptions());
+}
+
+/**
+Loads the input stream content like load(), with the given options.
+\param input The input stream
+\param options The options, e.g. how curves are output
+\return A handle to the loaded document, or a null pointer if the parsing was not successful
+*/
+VSDAPI std::shared_ptr<const libvisio::VisioDocumentHandle> libvisio::VisioDocument::load(librevenge::RVNGInputStream *input, const VisioParseOptions &options)
+{
+  if (!input)
+    return std::shared_ptr<const VisioDocumentHandle>();
+
+  std::unique_ptr<VSDPages> pages(new VSDPages());
+  if (!parseVisioDocument(input, nullptr, libvisio::VSDPageSelection(), options, pages.get()))
+    return std::shared_ptr<const VisioDocumentHandle>();
+
+  return std::shared_ptr<const VisioDocumentHandle>(new VisioDocumentHandle(std::move(pages)));
 }
 
 /**
@@ -277,19 +371,19 @@ VSDAPI bool libvisio::VisioDocument::parseStencils(librevenge::RVNGInputStream *
 
   if (isBinaryVisioDocument(input))
   {
-    if (parseBinaryVisioDocument(input, painter, true))
+    if (parseBinaryVisioDocument(input, painter, true, libvisio::VSDPageSelection()))
       return true;
     return false;
   }
   if (isOpcVisioDocument(input))
   {
-    if (parseOpcVisioDocument(input, painter, true))
+    if (parseOpcVisioDocument(input, painter, true, libvisio::VSDPageSelection()))
       return true;
     return false;
   }
   if (isXmlVisioDocument(input))
   {
-    if (parseXmlVisioDocument(input, painter, true))
+    if (parseXmlVisioDocument(input, painter, true, libvisio::VSDPageSelection()))
       return true;
     return false;
   }
@@ -0,0 +1,59 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <libvisio/libvisio.h>
+
+#include <utility>
+
+#include "VSDPages.h"
+
+libvisio::VisioDocumentHandle::VisioDocumentHandle(std::unique_ptr<const VSDPages> pages)
+  : m_pages(std::move(pages))
+{
+}
+
+VSDAPI libvisio::VisioDocumentHandle::~VisioDocumentHandle()
+{
+}
+
+/**
+Outputs the whole loaded document, the same way VisioDocument::parse() would.
+The handle is not modified, so several threads can draw it at the same time.
+\param painter A WPGPainterInterface implementation
+\return A value that indicates whether the drawing was successful
+*/
+VSDAPI bool libvisio::VisioDocumentHandle::draw(librevenge::RVNGDrawingInterface *painter) const
+{
+  if (!painter)
+    return false;
+
+  m_pages->draw(painter);
+  return true;
+}
+
+/**
+Outputs one page of the loaded document, drawn on its background pages, as a document
+of its own. Pages are numbered from 0 in the order draw() outputs them.
+\param painter A WPGPainterInterface implementation
+\param index The position of the page
+\return A value that indicates whether the page exists and was drawn
+*/
+VSDAPI bool libvisio::VisioDocumentHandle::drawPage(librevenge::RVNGDrawingInterface *painter, unsigned index) const
+{
+  return m_pages->drawPage(painter, index);
+}
+
+/**
+\return The number of pages draw() outputs
+*/
+VSDAPI unsigned libvisio::VisioDocumentHandle::pageCount() const
+{
+  return m_pages->getPageCount();
+}
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,112 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <libvisio/libvisio.h>
+
+namespace libvisio
+{
+
+class VisioParseOptionsImpl
+{
+public:
+  VisioParseOptionsImpl()
+    : m_curveTolerance(0.001), m_isCurveToleranceRelative(false),
+      m_curveOutput(VisioParseOptions::CURVES_AS_BEZIER), m_threadCount(1) {}
+
+  double m_curveTolerance;
+  bool m_isCurveToleranceRelative;
+  VisioParseOptions::CurveOutput m_curveOutput;
+  unsigned m_threadCount;
+};
+
+} // namespace libvisio
+
+VSDAPI libvisio::VisioParseOptions::VisioParseOptions()
+  : m_impl(new VisioParseOptionsImpl())
+{
+}
+
+VSDAPI libvisio::VisioParseOptions::VisioParseOptions(const VisioParseOptions &other)
+  : m_impl(new VisioParseOptionsImpl(*other.m_impl))
+{
+}
+
+VSDAPI libvisio::VisioParseOptions::~VisioParseOptions()
+{
+}
+
+VSDAPI libvisio::VisioParseOptions &libvisio::VisioParseOptions::operator=(const VisioParseOptions &other)
+{
+  *m_impl = *other.m_impl;
+  return *this;
+}
+
+/**
+Sets the largest distance between a spline and the line segments that approximate it.
+\param tolerance The distance, in inches, or as a fraction of the size of the spline
+\param isRelative Whether the distance is a fraction of the size of the spline
+*/
+VSDAPI void libvisio::VisioParseOptions::setCurveTolerance(double tolerance, bool isRelative)
+{
+  m_impl->m_curveTolerance = tolerance;
+  m_impl->m_isCurveToleranceRelative = isRelative;
+}
+
+/**
+\return The largest distance between a spline and the line segments that approximate it
+*/
+VSDAPI double libvisio::VisioParseOptions::getCurveTolerance() const
+{
+  return m_impl->m_curveTolerance;
+}
+
+/**
+\return Whether the curve tolerance is a fraction of the size of the spline rather than inches
+*/
+VSDAPI bool libvisio::VisioParseOptions::isCurveToleranceRelative() const
+{
+  return m_impl->m_isCurveToleranceRelative;
+}
+
+/**
+Chooses how splines are output. CURVES_AS_BEZIER is the default.
+\param curveOutput The kind of segments the splines become
+*/
+VSDAPI void libvisio::VisioParseOptions::setCurveOutput(CurveOutput curveOutput)
+{
+  m_impl->m_curveOutput = curveOutput;
+}
+
+/**
+\return The kind of segments the splines become
+*/
+VSDAPI libvisio::VisioParseOptions::CurveOutput libvisio::VisioParseOptions::getCurveOutput() const
+{
+  return m_impl->m_curveOutput;
+}
+
+/**
+Sets the number of threads that the pages of a document are collected on and,
+for VSDX, the page parts are parsed on. 0 and 1, the default, do everything on
+the calling thread.
+\param threadCount The number of threads
+*/
+VSDAPI void libvisio::VisioParseOptions::setThreadCount(unsigned threadCount)
+{
+  m_impl->m_threadCount = threadCount;
+}
+
+/**
+\return The number of threads that parsing may use
+*/
+VSDAPI unsigned libvisio::VisioParseOptions::getThreadCount() const
+{
+  return m_impl->m_threadCount;
+}
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -143,6 +143,23 @@ void libvisio::appendUCS4(librevenge::RVNGString &text, UChar32 ucs4Character)
   text.append((char *)outbuf);
 }
 
+void libvisio::appendUCS4(std::string &text, UChar32 ucs4Character)
+{
+  // The buffer ends up in a librevenge::RVNGString, which stops at NUL
+  if (!ucs4Character)
+    return;
+
+  // Convert carriage returns to new line characters
+  if (ucs4Character == (UChar32) 0x0d || ucs4Character == (UChar32) 0x0e)
+    ucs4Character = (UChar32) '\n';
+
+  unsigned char outbuf[U8_MAX_LENGTH];
+  int i = 0;
+  U8_APPEND_UNSAFE(&outbuf[0], i, ucs4Character);
+
+  text.append((char *)outbuf, i);
+}
+
 void libvisio::debugPrint(const char *format, ...)
 {
   va_list args;
@@ -15,6 +15,7 @@
 #endif
 
 #include <memory>
+#include <string>
 
 #include "VSDTypes.h"
 
@@ -73,6 +74,7 @@ const librevenge::RVNGString getColourString(const Colour &c);
 unsigned long getRemainingLength(librevenge::RVNGInputStream *input);
 
 void appendUCS4(librevenge::RVNGString &text, UChar32 ucs4Character);
+void appendUCS4(std::string &text, UChar32 ucs4Character);
 
 void debugPrint(const char *format, ...) VSD_ATTRIBUTE_PRINTF(1, 2);
 
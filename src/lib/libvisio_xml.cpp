@@ -14,6 +14,10 @@
 #endif
 #include <boost/lexical_cast.hpp>
 
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+
 #include "VSDTypes.h"
 #include "libvisio_utils.h"
 
@@ -79,6 +83,79 @@ extern "C"
 
 } // extern "C"
 
+// Reads a plain decimal number whose digits fit in the mantissa of a double and
+// whose power of ten is exact. Then one multiplication or division rounds the
+// value correctly, to the same double that lexical_cast gives. Returns false
+// for anything else, including everything that lexical_cast would reject.
+bool parseExactDouble(const char *s, double &value)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  static const double POWERS_OF_TEN[] =
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const uint64_t maxMantissa = uint64_t(1) << 53;
+
+  const char *p = s;
+  const bool isNegative = '-' == *p;
+  if ('-' == *p || '+' == *p)
+    ++p;
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  for (; '0' <= *p && '9' >= *p; ++p)
+  {
+    mantissa = 10 * mantissa + unsigned(*p - '0');
+    if (mantissa > maxMantissa)
+      return false;
+    hasDigits = true;
+  }
+  if ('.' == *p)
+  {
+    for (++p; '0' <= *p && '9' >= *p; ++p)
+    {
+      mantissa = 10 * mantissa + unsigned(*p - '0');
+      if (mantissa > maxMantissa)
+        return false;
+      --exponent;
+      hasDigits = true;
+    }
+  }
+  if (!hasDigits)
+    return false;
+  if ('e' == *p || 'E' == *p)
+  {
+    ++p;
+    const bool isExponentNegative = '-' == *p;
+    if ('-' == *p || '+' == *p)
+      ++p;
+    if ('0' > *p || '9' < *p)
+      return false;
+    int explicitExponent = 0;
+    for (; '0' <= *p && '9' >= *p; ++p)
+    {
+      explicitExponent = 10 * explicitExponent + (*p - '0');
+      if (explicitExponent > 1000)
+        return false;
+    }
+    exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+  }
+  if (*p || exponent < -22 || exponent > 22)
+    return false;
+
+  value = 0 > exponent ? double(mantissa) / POWERS_OF_TEN[-exponent] : double(mantissa) * POWERS_OF_TEN[exponent];
+  if (isNegative)
+    value = -value;
+  return true;
+#else
+  // Without exact double arithmetic, the result might be rounded twice
+  (void)s;
+  (void)value;
+  return false;
+#endif
+}
+
 } // anonymous namespace
 
 XMLErrorWatcher::XMLErrorWatcher()
@@ -112,6 +189,31 @@ xmlReaderForStream(librevenge::RVNGInputStream *input, XMLErrorWatcher *const wa
   return reader;
 }
 
+const xmlChar *xmlReaderConstAttribute(xmlTextReaderPtr reader, const char *name, std::unique_ptr<xmlChar, void (*)(void *)> &copy)
+{
+  copy.reset();
+  // Qualified names and namespace declarations are left to libxml2
+  const bool isPlainName = !strchr(name, ':') && strcmp(name, "xmlns");
+  const xmlNode *const node = isPlainName && XML_READER_TYPE_ELEMENT == xmlTextReaderNodeType(reader) ? xmlTextReaderCurrentNode(reader) : nullptr;
+  if (node && XML_ELEMENT_NODE == node->type)
+  {
+    const xmlAttr *attr = node->properties;
+    while (attr && (attr->ns || !xmlStrEqual(attr->name, BAD_CAST(name))))
+      attr = attr->next;
+    if (attr)
+    {
+      const xmlNode *const value = attr->children;
+      if (value && !value->next && (XML_TEXT_NODE == value->type || XML_CDATA_SECTION_NODE == value->type))
+        return value->content;
+    }
+    // A missing attribute might still have a default in the DTD
+    else if (!node->doc || (!node->doc->intSubset && !node->doc->extSubset))
+      return nullptr;
+  }
+  copy.reset(xmlTextReaderGetAttribute(reader, BAD_CAST(name)));
+  return copy.get();
+}
+
 Colour xmlStringToColour(const xmlChar *s)
 {
   if (xmlStrEqual(s, BAD_CAST("Themed")))
@@ -177,6 +279,9 @@ double xmlStringToDouble(const xmlChar *s) try
   if (xmlStrEqual(s, BAD_CAST("Themed")))
     return 0.0;
 
+  double value = 0.0;
+  if (s && parseExactDouble((const char *)s, value))
+    return value;
   return boost::lexical_cast<double, const char *>((const char *)s);
 }
 catch (const boost::bad_lexical_cast &)
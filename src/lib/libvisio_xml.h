@@ -41,6 +41,11 @@ private:
 std::unique_ptr<xmlTextReader, void (*)(xmlTextReaderPtr)>
 xmlReaderForStream(librevenge::RVNGInputStream *input, XMLErrorWatcher *watcher = nullptr, bool recover = true);
 
+// get an attribute of the current element like xmlTextReaderGetAttribute does,
+// but without a copy if the element holds the value as a single string; the
+// value is valid until the reader moves on
+const xmlChar *xmlReaderConstAttribute(xmlTextReaderPtr reader, const char *name, std::unique_ptr<xmlChar, void (*)(void *)> &copy);
+
 Colour xmlStringToColour(const xmlChar *s);
 Colour xmlStringToColour(const std::shared_ptr<xmlChar> &s);
 
@@ -0,0 +1,220 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "VSDBinaryReader.h"
+
+namespace test
+{
+
+class VSDBinaryReaderTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDBinaryReaderTest);
+  CPPUNIT_TEST(testReadValues);
+  CPPUNIT_TEST(testShortRead);
+  CPPUNIT_TEST(testStaysBad);
+  CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testSkipZeroBytes);
+  CPPUNIT_TEST(testNoData);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testReadValues();
+  void testShortRead();
+  void testStaysBad();
+  void testRead();
+  void testSeek();
+  void testSkipZeroBytes();
+  void testNoData();
+};
+
+void VSDBinaryReaderTest::setUp()
+{
+}
+
+void VSDBinaryReaderTest::tearDown()
+{
+}
+
+void VSDBinaryReaderTest::testReadValues()
+{
+  const unsigned char data[] =
+  {
+    0x81,
+    0x02, 0x81,
+    0xfe, 0xff,
+    0x04, 0x03, 0x02, 0x81,
+    0xfe, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x3f
+  };
+  libvisio::VSDBinaryReader reader(data, sizeof(data));
+  CPPUNIT_ASSERT_EQUAL(sizeof(data), size_t(reader.getSize()));
+
+  CPPUNIT_ASSERT_EQUAL(uint8_t(0x81), reader.readU8());
+  CPPUNIT_ASSERT_EQUAL(uint16_t(0x8102), reader.readU16());
+  CPPUNIT_ASSERT_EQUAL(int16_t(-2), reader.readS16());
+  CPPUNIT_ASSERT_EQUAL(uint32_t(0x81020304), reader.readU32());
+  CPPUNIT_ASSERT_EQUAL(int32_t(-2), reader.readS32());
+  CPPUNIT_ASSERT_EQUAL(1.5, reader.readDouble());
+  CPPUNIT_ASSERT(reader.isGood());
+  CPPUNIT_ASSERT(reader.isEnd());
+  CPPUNIT_ASSERT_EQUAL(0ul, reader.getRemainingLength());
+}
+
+void VSDBinaryReaderTest::testShortRead()
+{
+  const unsigned char data[] = { 0x01, 0x02, 0x03 };
+
+  // A value that does not fit reads as 0 and moves to the end
+  libvisio::VSDBinaryReader reader(data, sizeof(data));
+  CPPUNIT_ASSERT_EQUAL(uint16_t(0x0201), reader.readU16());
+  CPPUNIT_ASSERT_EQUAL(uint16_t(0), reader.readU16());
+  CPPUNIT_ASSERT(!reader.isGood());
+  CPPUNIT_ASSERT(reader.isEnd());
+  CPPUNIT_ASSERT_EQUAL(3ul, reader.tell());
+
+  libvisio::VSDBinaryReader reader32(data, sizeof(data));
+  CPPUNIT_ASSERT_EQUAL(uint32_t(0), reader32.readU32());
+  CPPUNIT_ASSERT(!reader32.isGood());
+
+  libvisio::VSDBinaryReader readerDouble(data, sizeof(data));
+  CPPUNIT_ASSERT_EQUAL(0.0, readerDouble.readDouble());
+  CPPUNIT_ASSERT(!readerDouble.isGood());
+
+  // Reading up to the end is not an error
+  libvisio::VSDBinaryReader reader8(data, sizeof(data));
+  reader8.skip(2);
+  CPPUNIT_ASSERT_EQUAL(uint8_t(0x03), reader8.readU8());
+  CPPUNIT_ASSERT(reader8.isGood());
+  CPPUNIT_ASSERT_EQUAL(uint8_t(0), reader8.readU8());
+  CPPUNIT_ASSERT(!reader8.isGood());
+}
+
+void VSDBinaryReaderTest::testStaysBad()
+{
+  const unsigned char data[] = { 0x01, 0x02, 0x03, 0x04 };
+  libvisio::VSDBinaryReader reader(data, sizeof(data));
+  reader.skip(3);
+  CPPUNIT_ASSERT_EQUAL(uint32_t(0), reader.readU32());
+  CPPUNIT_ASSERT(!reader.isGood());
+
+  // Values read after a failure are not used, even if they are there
+  reader.seek(0);
+  CPPUNIT_ASSERT_EQUAL(0ul, reader.tell());
+  CPPUNIT_ASSERT_EQUAL(uint8_t(0), reader.readU8());
+  CPPUNIT_ASSERT(!reader.isGood());
+}
+
+void VSDBinaryReaderTest::testRead()
+{
+  const unsigned char data[] = "abcdef";
+  libvisio::VSDBinaryReader reader(data, 6);
+
+  unsigned long numBytesRead = 0;
+  const unsigned char *p = reader.read(4, numBytesRead);
+  CPPUNIT_ASSERT_EQUAL(4ul, numBytesRead);
+  CPPUNIT_ASSERT(p == data);
+
+  // A short read is not an error
+  p = reader.read(4, numBytesRead);
+  CPPUNIT_ASSERT_EQUAL(2ul, numBytesRead);
+  CPPUNIT_ASSERT(p == data + 4);
+  CPPUNIT_ASSERT(reader.isGood());
+  CPPUNIT_ASSERT(reader.isEnd());
+
+  p = reader.read(1, numBytesRead);
+  CPPUNIT_ASSERT_EQUAL(0ul, numBytesRead);
+  CPPUNIT_ASSERT(!p);
+  CPPUNIT_ASSERT(reader.isGood());
+}
+
+void VSDBinaryReaderTest::testSeek()
+{
+  const unsigned char data[] = { 0x01, 0x02, 0x03, 0x04 };
+  libvisio::VSDBinaryReader reader(data, sizeof(data));
+
+  reader.seek(2);
+  CPPUNIT_ASSERT_EQUAL(2ul, reader.tell());
+  CPPUNIT_ASSERT_EQUAL(uint8_t(0x03), reader.readU8());
+
+  reader.seek(-1);
+  CPPUNIT_ASSERT_EQUAL(0ul, reader.tell());
+  reader.seek(5);
+  CPPUNIT_ASSERT_EQUAL(4ul, reader.tell());
+  CPPUNIT_ASSERT(reader.isEnd());
+
+  reader.skip(-3);
+  CPPUNIT_ASSERT_EQUAL(1ul, reader.tell());
+  reader.skip(-2);
+  CPPUNIT_ASSERT_EQUAL(0ul, reader.tell());
+  reader.skip(10);
+  CPPUNIT_ASSERT_EQUAL(4ul, reader.tell());
+
+  // Seeking is never an error
+  CPPUNIT_ASSERT(reader.isGood());
+}
+
+void VSDBinaryReaderTest::testSkipZeroBytes()
+{
+  // Non-zero bytes at every position around the word boundaries
+  for (unsigned position = 0; position < 20; ++position)
+  {
+    std::vector<unsigned char> data(20, 0);
+    data[position] = 1;
+    for (unsigned start = 0; start <= position; ++start)
+    {
+      libvisio::VSDBinaryReader reader(&data[0], data.size());
+      reader.seek(start);
+      reader.skipZeroBytes();
+      CPPUNIT_ASSERT_EQUAL((unsigned long)position, reader.tell());
+    }
+  }
+
+  // Only zeros up to the end
+  for (unsigned size = 0; size < 20; ++size)
+  {
+    const std::vector<unsigned char> data(size + 1, 0);
+    libvisio::VSDBinaryReader reader(&data[0], size);
+    reader.skipZeroBytes();
+    CPPUNIT_ASSERT_EQUAL((unsigned long)size, reader.tell());
+    CPPUNIT_ASSERT(reader.isEnd());
+    CPPUNIT_ASSERT(reader.isGood());
+  }
+}
+
+void VSDBinaryReaderTest::testNoData()
+{
+  libvisio::VSDBinaryReader reader(nullptr, 10);
+  CPPUNIT_ASSERT_EQUAL(0ul, reader.getSize());
+  CPPUNIT_ASSERT(reader.isEnd());
+  reader.skipZeroBytes();
+  CPPUNIT_ASSERT_EQUAL(0ul, reader.tell());
+  unsigned long numBytesRead = 1;
+  CPPUNIT_ASSERT(!reader.read(1, numBytesRead));
+  CPPUNIT_ASSERT_EQUAL(0ul, numBytesRead);
+  CPPUNIT_ASSERT(reader.isGood());
+  CPPUNIT_ASSERT_EQUAL(uint8_t(0), reader.readU8());
+  CPPUNIT_ASSERT(!reader.isGood());
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDBinaryReaderTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,120 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "VSDChunkTypes.h"
+
+namespace test
+{
+
+class VSDChunkTypesTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDChunkTypesTest);
+  CPPUNIT_TEST(testVSD11ChunkTypes);
+  CPPUNIT_TEST(testVSD6ChunkTypes);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testVSD11ChunkTypes();
+  void testVSD6ChunkTypes();
+};
+
+void VSDChunkTypesTest::setUp()
+{
+}
+
+void VSDChunkTypesTest::tearDown()
+{
+}
+
+namespace
+{
+
+// The conditions the chunk headers were read with before there were tables
+
+bool hasVSD11Trailer(unsigned chunkType)
+{
+  return chunkType == 0x71 || chunkType == 0x70 || chunkType == 0x6b || chunkType == 0x6a ||
+         chunkType == 0x69 || chunkType == 0x66 || chunkType == 0x65 || chunkType == 0x2c;
+}
+
+bool hasVSD11Separator(unsigned chunkType)
+{
+  const unsigned trailerChunks[14] = {0x64, 0x65, 0x66, 0x69, 0x6a, 0x6b, 0x6f, 0x71,
+                                      0x92, 0xa9, 0xb4, 0xb6, 0xb9, 0xc7
+                                     };
+  for (unsigned trailerChunk : trailerChunks)
+  {
+    if (chunkType == trailerChunk)
+      return true;
+  }
+  return false;
+}
+
+bool hasVSD11NoTrailer(unsigned chunkType)
+{
+  return chunkType == 0x1f || chunkType == 0xc9 || chunkType == 0x2d || chunkType == 0xd1;
+}
+
+bool hasVSD6Trailer(unsigned chunkType)
+{
+  return chunkType == 0x76 || chunkType == 0x73 || chunkType == 0x72 || chunkType == 0x71 ||
+         chunkType == 0x70 || chunkType == 0x6f || chunkType == 0x6e || chunkType == 0x6d ||
+         chunkType == 0x6c || chunkType == 0x6b || chunkType == 0x6a || chunkType == 0x69 ||
+         chunkType == 0x68 || chunkType == 0x67 || chunkType == 0x66 || chunkType == 0x65 ||
+         chunkType == 0x64 || chunkType == 0x2c || chunkType == 0xd;
+}
+
+bool hasVSD6NoTrailer(unsigned chunkType)
+{
+  return chunkType == 0x1f || chunkType == 0xc9;
+}
+
+const unsigned LARGE_CHUNK_TYPES[] = { 0x100, 0x171, 0x10071, 0x7fffffff, 0xffffffff };
+
+}
+
+void VSDChunkTypesTest::testVSD11ChunkTypes()
+{
+  for (unsigned chunkType = 0; chunkType < 0x200; ++chunkType)
+  {
+    const unsigned char flags = libvisio::getChunkTypeFlags(libvisio::VSD11_CHUNK_TYPES, chunkType);
+    CPPUNIT_ASSERT_EQUAL(hasVSD11Trailer(chunkType), bool(flags & libvisio::CHUNK_TRAILER));
+    CPPUNIT_ASSERT_EQUAL(hasVSD11Separator(chunkType), bool(flags & libvisio::CHUNK_SEPARATOR));
+    CPPUNIT_ASSERT_EQUAL(hasVSD11NoTrailer(chunkType), bool(flags & libvisio::CHUNK_NO_TRAILER));
+  }
+  for (unsigned chunkType : LARGE_CHUNK_TYPES)
+    CPPUNIT_ASSERT_EQUAL(0, int(libvisio::getChunkTypeFlags(libvisio::VSD11_CHUNK_TYPES, chunkType)));
+}
+
+void VSDChunkTypesTest::testVSD6ChunkTypes()
+{
+  for (unsigned chunkType = 0; chunkType < 0x200; ++chunkType)
+  {
+    const unsigned char flags = libvisio::getChunkTypeFlags(libvisio::VSD6_CHUNK_TYPES, chunkType);
+    CPPUNIT_ASSERT_EQUAL(hasVSD6Trailer(chunkType), bool(flags & libvisio::CHUNK_TRAILER));
+    CPPUNIT_ASSERT(!(flags & libvisio::CHUNK_SEPARATOR));
+    CPPUNIT_ASSERT_EQUAL(hasVSD6NoTrailer(chunkType), bool(flags & libvisio::CHUNK_NO_TRAILER));
+  }
+  for (unsigned chunkType : LARGE_CHUNK_TYPES)
+    CPPUNIT_ASSERT_EQUAL(0, int(libvisio::getChunkTypeFlags(libvisio::VSD6_CHUNK_TYPES, chunkType)));
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDChunkTypesTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,292 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <libxml/xmlwriter.h>
+
+#include <unicode/ucnv.h>
+#include <unicode/utf.h>
+
+#include "VSDContentCollector.h"
+#include "VSDGeometryList.h"
+#include "VSDStencils.h"
+#include "VSDStyles.h"
+#include "VSDTypes.h"
+#include "libvisio_utils.h"
+#include "xmldrawinggenerator.h"
+
+namespace test
+{
+
+namespace
+{
+
+// The levels the XML parsers use for a shape on a page and for its content
+#define SHAPE_LEVEL 1
+#define SHAPE_CONTENT_LEVEL 3
+
+/// The geometry of a quarter circle from (1, 0) to (0, 1), with its control point relative to the shape size
+libvisio::VSDGeometryList makeArcGeometry()
+{
+  libvisio::VSDGeometryList geometry;
+  geometry.addGeometry(0, SHAPE_CONTENT_LEVEL, true, false, false);
+  geometry.addMoveTo(1, SHAPE_CONTENT_LEVEL, 1.0, 0.0);
+  const std::vector<std::pair<double, double> > controlPoints(1, std::make_pair(1.0, 1.0));
+  std::vector<double> knotVector(3, 0.0);
+  knotVector.push_back(1.0);
+  std::vector<double> weights(3, 1.0);
+  weights[1] = 0.7071067811865476;
+  geometry.addNURBSTo(2, SHAPE_CONTENT_LEVEL, 0.0, 1.0, 0, 0, 2, controlPoints, knotVector, weights);
+  return geometry;
+}
+
+libvisio::XForm makeXForm(double pinX, double size)
+{
+  libvisio::XForm xform;
+  xform.pinX = pinX;
+  xform.pinY = 1.0;
+  xform.width = size;
+  xform.height = size;
+  return xform;
+}
+
+/// Instance sizes, in drawing order; a curve flattened for one size must not be reused for another
+const double SIZES[] = { 1.0, 1.0, 2.0, 1.0 };
+const unsigned SIZE_COUNT = sizeof(SIZES) / sizeof(SIZES[0]);
+
+/// Draws a page with an arc per size, then returns the XML of the page.
+/// The arcs are instances of a master, unless withOwnGeometry.
+std::string drawArcs(bool withOwnGeometry)
+{
+  libvisio::VSDShape master;
+  master.m_xform = makeXForm(0.0, 1.0);
+  master.m_geometries[0] = makeArcGeometry();
+  libvisio::VSDStencil stencil;
+  stencil.addStencilShape(0, master);
+  libvisio::VSDStencils stencils;
+  stencils.addStencil(0, stencil);
+
+  std::list<unsigned> shapeOrder;
+  for (unsigned i = 0; i < SIZE_COUNT; ++i)
+    shapeOrder.push_back(i + 1);
+  std::vector<std::map<unsigned, libvisio::XForm> > groupXFormsSequence(1);
+  std::vector<std::map<unsigned, unsigned> > groupMembershipsSequence(1);
+  std::vector<std::list<unsigned> > documentPageShapeOrders(1, shapeOrder);
+  libvisio::VSDStyles styles;
+
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlTextWriterPtr writer = xmlNewTextWriterMemory(buffer, 0);
+  {
+    libvisio::XmlDrawingGenerator painter(writer);
+    libvisio::VSDContentCollector collector(&painter, groupXFormsSequence, groupMembershipsSequence,
+                                            documentPageShapeOrders, styles, stencils, std::optional<unsigned>(), std::optional<unsigned>());
+    collector.startPage(0);
+    collector.collectPage(0, 0, MINUS_ONE, false, libvisio::VSDName());
+    collector.collectPageProps(0, 0, 8.5, 11.0, 0.0, 0.0, 1.0, 0, std::optional<unsigned>(), std::optional<unsigned>());
+    for (unsigned i = 0; i < SIZE_COUNT; ++i)
+    {
+      const unsigned masterPage = withOwnGeometry ? MINUS_ONE : 0;
+      const unsigned masterShape = withOwnGeometry ? MINUS_ONE : 0;
+      collector.collectShape(i + 1, SHAPE_LEVEL, 0, masterPage, masterShape, MINUS_ONE, MINUS_ONE, MINUS_ONE, libvisio::VSDName());
+      collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(2.0 * i + 1.0, SIZES[i]));
+      if (withOwnGeometry)
+      {
+        libvisio::VSDGeometryList geometry = makeArcGeometry();
+        geometry.handle(&collector);
+      }
+      collector.collectUnhandledChunk(0, SHAPE_LEVEL);
+    }
+    collector.endPage();
+    collector.endPages();
+  }
+  xmlTextWriterFlush(writer);
+  const std::string xml(reinterpret_cast<const char *>(xmlBufferContent(buffer)), xmlBufferLength(buffer));
+  xmlFreeTextWriter(writer);
+  xmlBufferFree(buffer);
+  return xml;
+}
+
+/// Keeps the names of the pages that reach it
+class PageNameGenerator : public libvisio::XmlDrawingGenerator
+{
+  // disable copying
+  PageNameGenerator(const PageNameGenerator &other);
+  PageNameGenerator &operator=(const PageNameGenerator &other);
+
+public:
+  PageNameGenerator(xmlTextWriterPtr writer)
+    : libvisio::XmlDrawingGenerator(writer), m_pageNames()
+  {
+  }
+
+  void startPage(const librevenge::RVNGPropertyList &propList)
+  {
+    m_pageNames.push_back(propList["draw:name"] ? propList["draw:name"]->getStr().cstr() : "");
+    libvisio::XmlDrawingGenerator::startPage(propList);
+  }
+
+  std::vector<std::string> m_pageNames;
+};
+
+/// Returns the UTF-8 names of pages named names, each in its format.
+/// All pages are in one document, so that the converters are reused.
+std::vector<std::string> convertPageNames(const std::vector<std::pair<std::string, libvisio::TextFormat> > &names)
+{
+  std::vector<std::map<unsigned, libvisio::XForm> > groupXFormsSequence(names.size());
+  std::vector<std::map<unsigned, unsigned> > groupMembershipsSequence(names.size());
+  std::vector<std::list<unsigned> > documentPageShapeOrders(names.size());
+  libvisio::VSDStyles styles;
+  libvisio::VSDStencils stencils;
+
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlTextWriterPtr writer = xmlNewTextWriterMemory(buffer, 0);
+  std::vector<std::string> pageNames;
+  {
+    PageNameGenerator painter(writer);
+    {
+      libvisio::VSDContentCollector collector(&painter, groupXFormsSequence, groupMembershipsSequence,
+                                              documentPageShapeOrders, styles, stencils, std::optional<unsigned>(), std::optional<unsigned>());
+      for (unsigned i = 0; i < names.size(); ++i)
+      {
+        const librevenge::RVNGBinaryData data(reinterpret_cast<const unsigned char *>(names[i].first.data()), names[i].first.size());
+        collector.startPage(i);
+        collector.collectPage(i, 0, MINUS_ONE, false, libvisio::VSDName(data, names[i].second));
+        collector.endPage();
+      }
+      collector.endPages();
+    }
+    pageNames = painter.m_pageNames;
+  }
+  xmlFreeTextWriter(writer);
+  xmlBufferFree(buffer);
+  return pageNames;
+}
+
+/// Decodes text with a new ICU converter, character by character, as all formats but symbol were decoded before
+std::string decodeWithICU(const std::string &text, const char *codePage, bool isUTF16)
+{
+  std::string result;
+  UErrorCode status = U_ZERO_ERROR;
+  UConverter *conv = ucnv_open(codePage, &status);
+  CPPUNIT_ASSERT(U_SUCCESS(status) && conv);
+  const char *src = text.data();
+  const char *const srcLimit = src + text.size();
+  while (src < srcLimit)
+  {
+    const UChar32 ucs4Character = ucnv_getNextUChar(conv, &src, srcLimit, &status);
+    if (U_SUCCESS(status) && U_IS_UNICODE_CHAR(ucs4Character))
+      libvisio::appendUCS4(result, 0x1e == ucs4Character && !isUTF16 ? 0xfffc : ucs4Character);
+  }
+  ucnv_close(conv);
+  return result;
+}
+
+struct EncodedText
+{
+  const char *text;
+  unsigned length;
+  libvisio::TextFormat format;
+  const char *codePage;
+};
+
+#define ENCODED_TEXT(text, format, codePage) { text, sizeof(text) - 1, format, codePage }
+
+const EncodedText ENCODED_TEXTS[] =
+{
+  ENCODED_TEXT("P\0a\0g\0e\0", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  ENCODED_TEXT("\xe9\0\xac\x20\x42\x30", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  // A surrogate pair
+  ENCODED_TEXT("a\0\x3d\xd8\x00\xdea\0", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  // A lead surrogate followed by a character that is not a trail surrogate, and at the end
+  ENCODED_TEXT("\x3d\xd8" "a\0\x3d\xd8", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  // A trail surrogate on its own
+  ENCODED_TEXT("a\0\x00\xde" "b\0", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  // Odd lengths, the last with a truncated lead surrogate
+  ENCODED_TEXT("a\0b", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  ENCODED_TEXT("a\0\x3d\xd8" "b", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  // A noncharacter and a field placeholder
+  ENCODED_TEXT("a\0\xfe\xff\x1e\0", libvisio::VSD_TEXT_UTF16, "UTF-16LE"),
+  ENCODED_TEXT("Page\x1e", libvisio::VSD_TEXT_ANSI, "windows-1252"),
+  ENCODED_TEXT("caf\xe9 \x80", libvisio::VSD_TEXT_ANSI, "windows-1252"),
+  ENCODED_TEXT("\xcf\xf0\xe8", libvisio::VSD_TEXT_RUSSIAN, "windows-1251"),
+  ENCODED_TEXT("\xe1\xe2\xe3", libvisio::VSD_TEXT_GREEK, "windows-1253"),
+  // windows-932 remaps these two control codes
+  ENCODED_TEXT("a\x1a" "b\x1c" "c\x7f", libvisio::VSD_TEXT_JAPANESE, "windows-932"),
+  ENCODED_TEXT("\x82\xa0\x82\xa2", libvisio::VSD_TEXT_JAPANESE, "windows-932"),
+  // A truncated lead byte must not join the next text
+  ENCODED_TEXT("a\x82", libvisio::VSD_TEXT_JAPANESE, "windows-932"),
+  ENCODED_TEXT("\xa0" "b", libvisio::VSD_TEXT_JAPANESE, "windows-932"),
+  ENCODED_TEXT("\xb0\xa1", libvisio::VSD_TEXT_KOREAN, "windows-949"),
+  ENCODED_TEXT("\xc4\xe3", libvisio::VSD_TEXT_CHINESE_SIMPLIFIED, "windows-936"),
+  ENCODED_TEXT("plain", libvisio::VSD_TEXT_CHINESE_TRADITIONAL, "windows-950")
+};
+
+}
+
+class VSDContentCollectorTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDContentCollectorTest);
+  CPPUNIT_TEST(testMasterCurves);
+  CPPUNIT_TEST(testTextConversion);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testMasterCurves();
+  void testTextConversion();
+};
+
+void VSDContentCollectorTest::setUp()
+{
+}
+
+void VSDContentCollectorTest::tearDown()
+{
+}
+
+// Instances of a master with a curve are drawn like shapes with the same curve of their own
+void VSDContentCollectorTest::testMasterCurves()
+{
+  const std::string instances = drawArcs(false);
+  CPPUNIT_ASSERT(instances.find("pathAction") != std::string::npos);
+  CPPUNIT_ASSERT_EQUAL(drawArcs(true), instances);
+}
+
+// Text is decoded as ICU decodes it, also where it is not decoded by ICU
+void VSDContentCollectorTest::testTextConversion()
+{
+  std::vector<std::pair<std::string, libvisio::TextFormat> > names;
+  for (const auto &encodedText : ENCODED_TEXTS)
+    names.push_back(std::make_pair(std::string(encodedText.text, encodedText.length), encodedText.format));
+  const std::vector<std::string> pageNames = convertPageNames(names);
+  CPPUNIT_ASSERT_EQUAL(names.size(), pageNames.size());
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    const std::string expected = decodeWithICU(names[i].first, ENCODED_TEXTS[i].codePage, names[i].second == libvisio::VSD_TEXT_UTF16);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(names[i].first, expected, pageNames[i]);
+  }
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDContentCollectorTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -8,6 +8,7 @@
  */
 
 #include <algorithm>
+#include <vector>
 
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
@@ -29,11 +30,21 @@ private:
   CPPUNIT_TEST_SUITE(VSDInternalStreamTest);
   CPPUNIT_TEST(testRead);
   CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testSharedBuffer);
+  CPPUNIT_TEST(testDecompress);
+  CPPUNIT_TEST(testDecompressShortDistance);
+  CPPUNIT_TEST(testDecompressTrailingReference);
+  CPPUNIT_TEST(testView);
   CPPUNIT_TEST_SUITE_END();
 
 private:
   void testRead();
   void testSeek();
+  void testSharedBuffer();
+  void testDecompress();
+  void testDecompressShortDistance();
+  void testDecompressTrailingReference();
+  void testView();
 };
 
 void VSDInternalStreamTest::setUp()
@@ -99,6 +110,232 @@ void VSDInternalStreamTest::testSeek()
   CPPUNIT_ASSERT((sizeof(data) - 1) == strm.tell());
 }
 
+void VSDInternalStreamTest::testSharedBuffer()
+{
+  const unsigned char data[] = "abc dee fgh";
+  librevenge::RVNGBinaryData binData(data, sizeof(data));
+  VSDInternalStream strm(binData.getDataStream(), binData.size());
+
+  VSDInternalStream shared(strm.getBuffer());
+  CPPUNIT_ASSERT(strm.getBuffer() == shared.getBuffer());
+  CPPUNIT_ASSERT(sizeof(data) == shared.getSize());
+
+  strm.seek(4, librevenge::RVNG_SEEK_SET);
+  CPPUNIT_ASSERT(0 == shared.tell());
+
+  unsigned long readBytes = 0;
+  const unsigned char *s = shared.read(sizeof(data), readBytes);
+  CPPUNIT_ASSERT(sizeof(data) == readBytes);
+  CPPUNIT_ASSERT(std::equal(data, data + sizeof(data), s));
+  CPPUNIT_ASSERT(shared.isEnd());
+  CPPUNIT_ASSERT(!strm.isEnd());
+
+  VSDInternalStream empty(std::shared_ptr<const std::vector<unsigned char> >{});
+  CPPUNIT_ASSERT(0 == empty.getSize());
+  CPPUNIT_ASSERT(empty.isEnd());
+}
+
+void VSDInternalStreamTest::testDecompress()
+{
+  // literals, an overlapping back-reference, a reference into the
+  // zero-filled initial window, a literal and a plain back-reference
+  const unsigned char data[] = { 0x27, 'a', 'b', 'c', 0xee, 0xf3, 0x52, 0x00, 'z', 0xf1, 0xf0 };
+  const unsigned char expected[] = { 'a', 'b', 'c', 'a', 'b', 'c', 'a', 'b', 'c', 0, 0, 0, 'z', 'a', 'b', 'c' };
+  librevenge::RVNGBinaryData binData(data, sizeof(data));
+  VSDInternalStream strm(binData.getDataStream(), binData.size(), true);
+
+  unsigned long readBytes = 0;
+  const unsigned char *s = strm.read(sizeof(expected) + 1, readBytes);
+  CPPUNIT_ASSERT_EQUAL(sizeof(expected), size_t(readBytes));
+  CPPUNIT_ASSERT(std::equal(expected, expected + sizeof(expected), s));
+  CPPUNIT_ASSERT(strm.isEnd());
+}
+
+namespace
+{
+
+// Decompresses byte by byte through the 4 KiB window, like the stream did
+// before it copied in blocks
+std::vector<unsigned char> referenceDecompress(const std::vector<unsigned char> &input)
+{
+  std::vector<unsigned char> output;
+  unsigned char window[4096] = { 0 };
+  unsigned pos = 0;
+  unsigned offset = 0;
+  while (offset < input.size())
+  {
+    const unsigned flag = input[offset++];
+    if (offset > input.size() - 1)
+      break;
+    for (unsigned bit = 0; bit < 8 && offset < input.size(); ++bit)
+    {
+      if (flag & (1u << bit))
+      {
+        window[pos & 4095] = input[offset++];
+        output.push_back(window[pos & 4095]);
+        pos++;
+      }
+      else
+      {
+        if (offset > input.size() - 2)
+          break;
+        const unsigned char addr1 = input[offset++];
+        const unsigned char addr2 = input[offset++];
+        const unsigned length = (addr2 & 15) + 3;
+        unsigned pointer = (((unsigned)addr2 & 0xF0) << 4) | addr1;
+        if (pointer > 4078)
+          pointer -= 4078;
+        else
+          pointer += 18;
+        for (unsigned j = 0; j < length; ++j)
+        {
+          window[(pos + j) & 4095] = window[(pointer + j) & 4095];
+          output.push_back(window[(pointer + j) & 4095]);
+        }
+        pos += length;
+      }
+    }
+  }
+  return output;
+}
+
+// Builds compressed data token by token
+class CompressedData
+{
+public:
+  CompressedData() : m_data(), m_flagPos(0), m_bit(8), m_outputSize(0) {}
+
+  void literal(unsigned char c)
+  {
+    _nextToken(true);
+    m_data.push_back(c);
+    ++m_outputSize;
+  }
+
+  void reference(unsigned distance, unsigned length)
+  {
+    _nextToken(false);
+    // The window position distance bytes back, in the numbering of the format
+    const unsigned position = (m_outputSize - distance) & 4095;
+    const unsigned pointer = position >= 18 ? position - 18 : position + 4078;
+    m_data.push_back((unsigned char)(pointer & 0xff));
+    m_data.push_back((unsigned char)(((pointer >> 4) & 0xf0) | (length - 3)));
+    m_outputSize += length;
+  }
+
+  const std::vector<unsigned char> &getData() const
+  {
+    return m_data;
+  }
+
+private:
+  void _nextToken(bool isLiteral)
+  {
+    if (m_bit == 8)
+    {
+      m_flagPos = m_data.size();
+      m_data.push_back(0);
+      m_bit = 0;
+    }
+    if (isLiteral)
+      m_data[m_flagPos] |= (unsigned char)(1u << m_bit);
+    ++m_bit;
+  }
+
+  std::vector<unsigned char> m_data;
+  std::size_t m_flagPos;
+  unsigned m_bit;
+  unsigned m_outputSize;
+};
+
+std::vector<unsigned char> decompress(const std::vector<unsigned char> &data)
+{
+  librevenge::RVNGBinaryData binData(data.data(), data.size());
+  VSDInternalStream strm(binData.getDataStream(), binData.size(), true);
+  return std::vector<unsigned char>(strm.getData(), strm.getData() + strm.getSize());
+}
+
+}
+
+// Back-references closer than the longest match overlap the bytes they produce
+void VSDInternalStreamTest::testDecompressShortDistance()
+{
+  for (unsigned distance = 1; distance <= 20; ++distance)
+  {
+    for (unsigned length = 3; length <= 18; ++length)
+    {
+      CompressedData data;
+      for (unsigned i = 0; i < 21; ++i)
+        data.literal((unsigned char)('A' + i));
+      data.reference(distance, length);
+      data.literal('z');
+      data.reference(distance, 18);
+      data.literal('y');
+
+      const std::vector<unsigned char> expected = referenceDecompress(data.getData());
+      CPPUNIT_ASSERT_EQUAL(size_t(21 + length + 1 + 18 + 1), expected.size());
+      CPPUNIT_ASSERT(expected == decompress(data.getData()));
+    }
+  }
+}
+
+// The output ends right after a back-reference, after literals and in a grown buffer
+void VSDInternalStreamTest::testDecompressTrailingReference()
+{
+  for (unsigned length = 3; length <= 18; ++length)
+  {
+    CompressedData data;
+    data.literal('a');
+    data.reference(1, length);
+    const std::vector<unsigned char> expected = referenceDecompress(data.getData());
+    CPPUNIT_ASSERT_EQUAL(size_t(1 + length), expected.size());
+    CPPUNIT_ASSERT(expected == decompress(data.getData()));
+  }
+
+  // Every 2 bytes of input give 18 bytes of output, many times the initial guess
+  CompressedData data;
+  for (unsigned i = 0; i < 7; ++i)
+    data.literal((unsigned char)('0' + i));
+  for (unsigned i = 0; i < 1000; ++i)
+    data.reference(7 + i % 11, 18);
+  const std::vector<unsigned char> expected = referenceDecompress(data.getData());
+  CPPUNIT_ASSERT_EQUAL(size_t(7 + 18 * 1000), expected.size());
+  CPPUNIT_ASSERT(expected == decompress(data.getData()));
+
+  // References reaching before the start read the zero-filled window
+  CompressedData initial;
+  initial.reference(4096, 18);
+  initial.literal('x');
+  initial.reference(30, 18);
+  CPPUNIT_ASSERT(referenceDecompress(initial.getData()) == decompress(initial.getData()));
+}
+
+void VSDInternalStreamTest::testView()
+{
+  const unsigned char data[] = "abc dee fgh";
+  const auto buffer = std::make_shared<const std::vector<unsigned char> >(data, data + sizeof(data));
+  VSDInternalStream strm(buffer, 4, 3);
+
+  CPPUNIT_ASSERT(3 == strm.getSize());
+  unsigned long readBytes = 0;
+  const unsigned char *s = strm.read(10, readBytes);
+  CPPUNIT_ASSERT(3 == readBytes);
+  CPPUNIT_ASSERT_EQUAL(buffer->data() + 4, s);
+  CPPUNIT_ASSERT(strm.isEnd());
+
+  CPPUNIT_ASSERT(1 == strm.seek(1, librevenge::RVNG_SEEK_END));
+  CPPUNIT_ASSERT(3 == strm.tell());
+  CPPUNIT_ASSERT(0 == strm.seek(-1, librevenge::RVNG_SEEK_END));
+  s = strm.read(1, readBytes);
+  CPPUNIT_ASSERT('e' == s[0]);
+
+  VSDInternalStream truncated(buffer, 8, 100);
+  CPPUNIT_ASSERT(sizeof(data) - 8 == truncated.getSize());
+  VSDInternalStream outside(buffer, 100, 3);
+  CPPUNIT_ASSERT(0 == outside.getSize());
+  CPPUNIT_ASSERT(outside.isEnd());
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(VSDInternalStreamTest);
 
 }
@@ -0,0 +1,192 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory>
+#include <string>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <libxml/xmlwriter.h>
+
+#include "VSDOutputElementList.h"
+#include "xmldrawinggenerator.h"
+
+namespace test
+{
+
+namespace
+{
+
+/// Returns the XML that drawing elementList produces.
+std::string drawToXml(const libvisio::VSDOutputElementList &elementList)
+{
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlTextWriterPtr writer = xmlNewTextWriterMemory(buffer, 0);
+  xmlTextWriterStartElement(writer, reinterpret_cast<const xmlChar *>("list"));
+  {
+    libvisio::XmlDrawingGenerator painter(writer);
+    elementList.draw(&painter);
+  }
+  xmlTextWriterEndElement(writer);
+  xmlTextWriterFlush(writer);
+  const std::string xml(reinterpret_cast<const char *>(xmlBufferContent(buffer)), xmlBufferLength(buffer));
+  xmlFreeTextWriter(writer);
+  xmlBufferFree(buffer);
+  return xml;
+}
+
+librevenge::RVNGPropertyList makeStyle(const char *colour)
+{
+  librevenge::RVNGPropertyList style;
+  style.insert("draw:fill", "solid");
+  style.insert("draw:fill-color", colour);
+  return style;
+}
+
+}
+
+class VSDOutputElementListTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDOutputElementListTest);
+  CPPUNIT_TEST(testDrawOrder);
+  CPPUNIT_TEST(testCopyOutlivesSource);
+  CPPUNIT_TEST(testCopyIsIndependent);
+  CPPUNIT_TEST(testAppend);
+  CPPUNIT_TEST(testAppendSelf);
+  CPPUNIT_TEST(testConsecutiveSpaces);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testDrawOrder();
+  void testCopyOutlivesSource();
+  void testCopyIsIndependent();
+  void testAppend();
+  void testAppendSelf();
+  void testConsecutiveSpaces();
+};
+
+void VSDOutputElementListTest::setUp()
+{
+}
+
+void VSDOutputElementListTest::tearDown()
+{
+}
+
+void VSDOutputElementListTest::testDrawOrder()
+{
+  libvisio::VSDOutputElementList elementList;
+  CPPUNIT_ASSERT(elementList.empty());
+  elementList.addStartLayer(librevenge::RVNGPropertyList());
+  elementList.addStyle(makeStyle("#ff0000"));
+  elementList.addStartTextObject(librevenge::RVNGPropertyList());
+  elementList.addOpenParagraph(librevenge::RVNGPropertyList());
+  elementList.addOpenSpan(librevenge::RVNGPropertyList());
+  elementList.addInsertText("text");
+  elementList.addInsertTab();
+  elementList.addInsertLineBreak();
+  elementList.addCloseSpan();
+  elementList.addCloseParagraph();
+  elementList.addEndTextObject();
+  elementList.addEndLayer();
+  CPPUNIT_ASSERT(!elementList.empty());
+
+  CPPUNIT_ASSERT_EQUAL(std::string("<list><layer><setStyle draw:fill=\"solid\" draw:fill-color=\"#ff0000\"/>"
+                                   "<textObject><paragraph><span><insertText>text</insertText><insertTab/><insertLineBreak/>"
+                                   "</span></paragraph></textObject></layer></list>"),
+                       drawToXml(elementList));
+}
+
+void VSDOutputElementListTest::testCopyOutlivesSource()
+{
+  std::unique_ptr<libvisio::VSDOutputElementList> source(new libvisio::VSDOutputElementList());
+  source->addStyle(makeStyle("#ff0000"));
+  source->addInsertText("text");
+  const std::string expected = drawToXml(*source);
+
+  const libvisio::VSDOutputElementList copy(*source);
+  libvisio::VSDOutputElementList assigned;
+  assigned = *source;
+  libvisio::VSDOutputElementList appended;
+  appended.append(*source);
+  source.reset();
+
+  CPPUNIT_ASSERT_EQUAL(expected, drawToXml(copy));
+  CPPUNIT_ASSERT_EQUAL(expected, drawToXml(assigned));
+  CPPUNIT_ASSERT_EQUAL(expected, drawToXml(appended));
+}
+
+void VSDOutputElementListTest::testCopyIsIndependent()
+{
+  libvisio::VSDOutputElementList source;
+  source.addStyle(makeStyle("#ff0000"));
+  const std::string expected = drawToXml(source);
+
+  libvisio::VSDOutputElementList copy(source);
+  source.addStyle(makeStyle("#00ff00"));
+  CPPUNIT_ASSERT_EQUAL(expected, drawToXml(copy));
+
+  // What the copy adds goes into its own payloads
+  copy.addStyle(makeStyle("#0000ff"));
+  CPPUNIT_ASSERT_EQUAL(std::string("<list><setStyle draw:fill=\"solid\" draw:fill-color=\"#ff0000\"/>"
+                                   "<setStyle draw:fill=\"solid\" draw:fill-color=\"#00ff00\"/></list>"),
+                       drawToXml(source));
+  CPPUNIT_ASSERT_EQUAL(std::string("<list><setStyle draw:fill=\"solid\" draw:fill-color=\"#ff0000\"/>"
+                                   "<setStyle draw:fill=\"solid\" draw:fill-color=\"#0000ff\"/></list>"),
+                       drawToXml(copy));
+}
+
+void VSDOutputElementListTest::testAppend()
+{
+  libvisio::VSDOutputElementList first;
+  first.addStyle(makeStyle("#ff0000"));
+  libvisio::VSDOutputElementList second;
+  second.addInsertText("second");
+  libvisio::VSDOutputElementList third;
+  third.addInsertText("third");
+
+  // Appending a list that shares payloads keeps all of them
+  second.append(third);
+  first.append(second);
+  first.append(libvisio::VSDOutputElementList());
+  first.addInsertText("first");
+  CPPUNIT_ASSERT_EQUAL(std::string("<list><setStyle draw:fill=\"solid\" draw:fill-color=\"#ff0000\"/>"
+                                   "<insertText>second</insertText><insertText>third</insertText>"
+                                   "<insertText>first</insertText></list>"),
+                       drawToXml(first));
+}
+
+void VSDOutputElementListTest::testAppendSelf()
+{
+  libvisio::VSDOutputElementList elementList;
+  elementList.addInsertText("text");
+  elementList.append(elementList);
+  CPPUNIT_ASSERT_EQUAL(std::string("<list><insertText>text</insertText><insertText>text</insertText></list>"),
+                       drawToXml(elementList));
+}
+
+void VSDOutputElementListTest::testConsecutiveSpaces()
+{
+  libvisio::VSDOutputElementList elementList;
+  elementList.addInsertText("a   b");
+  CPPUNIT_ASSERT_EQUAL(std::string("<list><insertText>a </insertText><insertSpace/><insertSpace/><insertText>b</insertText></list>"),
+                       drawToXml(elementList));
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDOutputElementListTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,235 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <libxml/xmlwriter.h>
+
+#include "VSDContentCollector.h"
+#include "VSDPages.h"
+#include "VSDStencils.h"
+#include "VSDStyles.h"
+#include "VSDTypes.h"
+#include "xmldrawinggenerator.h"
+
+namespace test
+{
+
+namespace
+{
+
+/// Counts the document and page calls that reach it
+class CountingGenerator : public libvisio::XmlDrawingGenerator
+{
+  // disable copying
+  CountingGenerator(const CountingGenerator &other);
+  CountingGenerator &operator=(const CountingGenerator &other);
+
+public:
+  CountingGenerator(xmlTextWriterPtr writer)
+    : libvisio::XmlDrawingGenerator(writer), m_documentsStarted(0), m_documentsEnded(0), m_pagesStarted(0)
+  {
+  }
+
+  void startDocument(const librevenge::RVNGPropertyList &propList)
+  {
+    ++m_documentsStarted;
+    libvisio::XmlDrawingGenerator::startDocument(propList);
+  }
+
+  void endDocument()
+  {
+    ++m_documentsEnded;
+    libvisio::XmlDrawingGenerator::endDocument();
+  }
+
+  void startPage(const librevenge::RVNGPropertyList &propList)
+  {
+    ++m_pagesStarted;
+    libvisio::XmlDrawingGenerator::startPage(propList);
+  }
+
+  unsigned m_documentsStarted;
+  unsigned m_documentsEnded;
+  unsigned m_pagesStarted;
+};
+
+libvisio::VSDPage makePage(unsigned id, unsigned backgroundId = MINUS_ONE)
+{
+  libvisio::VSDPage page;
+  page.m_currentPageID = id;
+  page.m_backgroundPageID = backgroundId;
+  return page;
+}
+
+}
+
+class VSDPagesTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDPagesTest);
+  CPPUNIT_TEST(testEndStreamingTwice);
+  CPPUNIT_TEST(testAddPageAfterEnd);
+  CPPUNIT_TEST(testCancelStreaming);
+  CPPUNIT_TEST(testCancelStreamingNotStarted);
+  CPPUNIT_TEST(testCollectorEndPagesTwice);
+  CPPUNIT_TEST(testCollectorFailure);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testEndStreamingTwice();
+  void testAddPageAfterEnd();
+  void testCancelStreaming();
+  void testCancelStreamingNotStarted();
+  void testCollectorEndPagesTwice();
+  void testCollectorFailure();
+
+  xmlBufferPtr m_buffer;
+  xmlTextWriterPtr m_writer;
+  std::unique_ptr<CountingGenerator> m_painter;
+};
+
+void VSDPagesTest::setUp()
+{
+  m_buffer = xmlBufferCreate();
+  m_writer = xmlNewTextWriterMemory(m_buffer, 0);
+  m_painter.reset(new CountingGenerator(m_writer));
+}
+
+void VSDPagesTest::tearDown()
+{
+  m_painter.reset();
+  xmlFreeTextWriter(m_writer);
+  xmlBufferFree(m_buffer);
+}
+
+void VSDPagesTest::testEndStreamingTwice()
+{
+  libvisio::VSDPages pages;
+  pages.setStreamingPainter(m_painter.get());
+  pages.addBackgroundPage(makePage(1));
+  pages.addPage(makePage(0, 1));
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_pagesStarted);
+
+  pages.endStreaming();
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  // The background page comes after the foreground one
+  CPPUNIT_ASSERT_EQUAL(2u, m_painter->m_pagesStarted);
+
+  pages.endStreaming();
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(2u, m_painter->m_pagesStarted);
+}
+
+void VSDPagesTest::testAddPageAfterEnd()
+{
+  libvisio::VSDPages pages;
+  pages.setStreamingPainter(m_painter.get());
+  pages.addPage(makePage(0));
+  pages.endStreaming();
+  pages.addPage(makePage(1));
+  pages.addBackgroundPage(makePage(2));
+  pages.endStreaming();
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_pagesStarted);
+}
+
+void VSDPagesTest::testCancelStreaming()
+{
+  libvisio::VSDPages pages;
+  pages.setStreamingPainter(m_painter.get());
+  pages.addPage(makePage(0));
+  // Waits for its background page
+  pages.addPage(makePage(1, 2));
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(0u, m_painter->m_documentsEnded);
+
+  pages.cancelStreaming();
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_pagesStarted);
+
+  pages.cancelStreaming();
+  pages.endStreaming();
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_pagesStarted);
+}
+
+void VSDPagesTest::testCancelStreamingNotStarted()
+{
+  libvisio::VSDPages pages;
+  pages.setStreamingPainter(m_painter.get());
+  pages.addPage(makePage(0, 1));
+  pages.cancelStreaming();
+  CPPUNIT_ASSERT_EQUAL(0u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(0u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(0u, m_painter->m_pagesStarted);
+}
+
+void VSDPagesTest::testCollectorEndPagesTwice()
+{
+  std::vector<std::map<unsigned, libvisio::XForm> > groupXFormsSequence;
+  std::vector<std::map<unsigned, unsigned> > groupMembershipsSequence;
+  std::vector<std::list<unsigned> > documentPageShapeOrders;
+  libvisio::VSDStyles styles;
+  libvisio::VSDStencils stencils;
+  {
+    libvisio::VSDContentCollector collector(m_painter.get(), groupXFormsSequence, groupMembershipsSequence,
+                                            documentPageShapeOrders, styles, stencils, std::optional<unsigned>(), std::optional<unsigned>());
+    collector.startPage(0);
+    collector.collectPage(0, 0, 1, false, libvisio::VSDName());
+    collector.endPage();
+    collector.startPage(1);
+    collector.collectPage(1, 0, MINUS_ONE, true, libvisio::VSDName());
+    collector.endPage();
+    collector.endPages();
+    collector.endPages();
+  }
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(2u, m_painter->m_pagesStarted);
+}
+
+void VSDPagesTest::testCollectorFailure()
+{
+  std::vector<std::map<unsigned, libvisio::XForm> > groupXFormsSequence;
+  std::vector<std::map<unsigned, unsigned> > groupMembershipsSequence;
+  std::vector<std::list<unsigned> > documentPageShapeOrders;
+  libvisio::VSDStyles styles;
+  libvisio::VSDStencils stencils;
+  {
+    libvisio::VSDContentCollector collector(m_painter.get(), groupXFormsSequence, groupMembershipsSequence,
+                                            documentPageShapeOrders, styles, stencils, std::optional<unsigned>(), std::optional<unsigned>());
+    collector.startPage(0);
+    collector.endPage();
+    CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsStarted);
+    // The parsing fails before endPages
+  }
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_documentsEnded);
+  CPPUNIT_ASSERT_EQUAL(1u, m_painter->m_pagesStarted);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDPagesTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,335 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <list>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <librevenge-stream/librevenge-stream.h>
+#include <libxml/xmlwriter.h>
+
+#include "VDXParser.h"
+#include "VSD5Parser.h"
+#include "VSD6Parser.h"
+#include "VSDContentCollector.h"
+#include "VSDParser.h"
+#include "VSDRecordingCollector.h"
+#include "VSDStencils.h"
+#include "VSDStyles.h"
+#include "VSDStylesCollector.h"
+#include "VSDXParser.h"
+#include "libvisio_utils.h"
+#include "xmldrawinggenerator.h"
+
+namespace test
+{
+
+namespace
+{
+
+const char *const CORPUS[] =
+{
+  "Visio11FormatLine.vsd",
+  "Visio11PlanWithDimensions.vsd",
+  "Visio11TextFieldsWithAngle.vsd",
+  "Visio11TextFieldsWithCurrency.vsd",
+  "Visio11TextFieldsWithUnits.vsd",
+  "Visio5PlanWithDimensions.vsd",
+  "Visio5TextFieldsWithUnits.vsd",
+  "Visio6PlanWithDimensions.vsd",
+  "Visio6TextFieldsWithUnits.vsd",
+  "bgcolor.vsdx",
+  "bitmaps.vsd",
+  "bitmaps2.vsd",
+  "blue-box.vsdx",
+  "color-boxes.vsdx",
+  "dwg.vsd",
+  "dwg.vsdx",
+  "fdo86664.vsdx",
+  "fdo86729-ms1252.vsd",
+  "fdo86729-utf8.vsd",
+  "groups.vdx",
+  "masters.vdx",
+  "no-bgcolor.vsd",
+  "office_varient4.vsdx",
+  "pages.vdx",
+  "qs-box.vsdx",
+  "recursion-cycle.vsdx",
+  "splines.vdx",
+  "tab-short-prefix.vsdx",
+  "tdf136564-WhiteTextBackground.vsdx",
+  "tdf154379-DrawingUnits-type.vsd",
+  "tdf154379-QuickStyleFillMatrix.vsdx",
+  "tdf76829-datetime-format.vsd",
+  "tdf76829-numeric-format.vsd",
+  "testfile1.vsdx",
+  "testfile3.vsdx",
+  "testfile4.vsdx",
+  "testfile5.vsdx",
+  "testfile6.vsdx"
+};
+
+bool endsWith(const std::string &str, const std::string &suffix)
+{
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+template<typename P>
+bool parseWith(P &parser, bool singlePass, unsigned long maxRecordSize, unsigned threadCount)
+{
+  libvisio::VisioParseOptions options;
+  options.setThreadCount(threadCount);
+  parser.setSinglePass(singlePass);
+  parser.setMaxRecordSize(maxRecordSize);
+  parser.setParseOptions(options);
+  return parser.parseMain();
+}
+
+/// Paints an XML representation of input, using the parser that the file name calls for.
+std::string paint(librevenge::RVNGInputStream &input, const std::string &filename, bool singlePass,
+                  unsigned long maxRecordSize = VSD_RECORDING_DEFAULT_SIZE, unsigned threadCount = 1)
+{
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlTextWriterPtr writer = xmlNewTextWriterMemory(buffer, 0);
+  xmlTextWriterStartDocument(writer, 0, 0, 0);
+  bool result = false;
+  {
+    libvisio::XmlDrawingGenerator painter(writer);
+    if (endsWith(filename, ".vsdx"))
+    {
+      libvisio::VSDXParser parser(&input, &painter);
+      result = parseWith(parser, singlePass, maxRecordSize, threadCount);
+    }
+    else if (endsWith(filename, ".vdx"))
+    {
+      libvisio::VDXParser parser(&input, &painter);
+      result = parseWith(parser, singlePass, maxRecordSize, threadCount);
+    }
+    else
+    {
+      const std::unique_ptr<librevenge::RVNGInputStream> docStream(input.getSubStreamByName("VisioDocument"));
+      if (docStream)
+      {
+        docStream->seek(0x1A, librevenge::RVNG_SEEK_SET);
+        std::unique_ptr<libvisio::VSDParser> parser;
+        const unsigned char version = libvisio::readU8(docStream.get());
+        if (version == 11)
+          parser.reset(new libvisio::VSDParser(docStream.get(), &painter, &input));
+        else if (version == 6)
+          parser.reset(new libvisio::VSD6Parser(docStream.get(), &painter));
+        else if (version >= 1 && version <= 5)
+          parser.reset(new libvisio::VSD5Parser(docStream.get(), &painter));
+        if (parser)
+          result = parseWith(*parser, singlePass, maxRecordSize, threadCount);
+      }
+    }
+  }
+  xmlTextWriterEndDocument(writer);
+  xmlFreeTextWriter(writer);
+  const std::string xml(reinterpret_cast<const char *>(xmlBufferContent(buffer)), xmlBufferLength(buffer));
+  xmlBufferFree(buffer);
+
+  CPPUNIT_ASSERT_MESSAGE(filename, result);
+  return xml;
+}
+
+/// Paints an XML representation of a document of the corpus.
+std::string parse(const std::string &filename, bool singlePass, unsigned long maxRecordSize = VSD_RECORDING_DEFAULT_SIZE,
+                  unsigned threadCount = 1)
+{
+  const std::string path(TDOC "/" + filename);
+  librevenge::RVNGFileStream input(path.c_str());
+  return paint(input, filename, singlePass, maxRecordSize, threadCount);
+}
+
+unsigned countOccurrences(const std::string &str, const std::string &what)
+{
+  unsigned count = 0;
+  for (std::size_t pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + what.size()))
+    ++count;
+  return count;
+}
+
+}
+
+class VSDRecordingCollectorTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDRecordingCollectorTest);
+  CPPUNIT_TEST(testSizeLimit);
+  CPPUNIT_TEST(testSizeAfterRewind);
+  CPPUNIT_TEST(testReplayCorpus);
+  CPPUNIT_TEST(testDiscardedCorpus);
+  CPPUNIT_TEST(testThreadedCorpus);
+  CPPUNIT_TEST(testThreadedFailure);
+  CPPUNIT_TEST(testPagesBeforeMasters);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testSizeLimit();
+  void testSizeAfterRewind();
+  void testReplayCorpus();
+  void testDiscardedCorpus();
+  void testThreadedCorpus();
+  void testThreadedFailure();
+  void testPagesBeforeMasters();
+
+  std::vector<std::map<unsigned, libvisio::XForm> > m_groupXFormsSequence;
+  std::vector<std::map<unsigned, unsigned> > m_groupMembershipsSequence;
+  std::vector<std::list<unsigned> > m_documentPageShapeOrders;
+  std::unique_ptr<libvisio::VSDStylesCollector> m_stylesCollector;
+};
+
+void VSDRecordingCollectorTest::setUp()
+{
+  m_stylesCollector.reset(new libvisio::VSDStylesCollector(m_groupXFormsSequence, m_groupMembershipsSequence, m_documentPageShapeOrders));
+}
+
+void VSDRecordingCollectorTest::tearDown()
+{
+  m_stylesCollector.reset();
+  m_groupXFormsSequence.clear();
+  m_groupMembershipsSequence.clear();
+  m_documentPageShapeOrders.clear();
+}
+
+void VSDRecordingCollectorTest::testSizeLimit()
+{
+  libvisio::VSDRecordingCollector recorder(m_stylesCollector.get(), 4096);
+  recorder.collectText(0, librevenge::RVNGBinaryData(std::vector<unsigned char>(1024).data(), 1024), libvisio::VSD_TEXT_UTF16);
+  CPPUNIT_ASSERT(!recorder.isDiscarded());
+  for (unsigned i = 0; i < 3; ++i)
+    recorder.collectText(0, librevenge::RVNGBinaryData(std::vector<unsigned char>(1024).data(), 1024), libvisio::VSD_TEXT_UTF16);
+  CPPUNIT_ASSERT(recorder.isDiscarded());
+}
+
+void VSDRecordingCollectorTest::testSizeAfterRewind()
+{
+  libvisio::VSDRecordingCollector recorder(m_stylesCollector.get(), 4096);
+  recorder.mark();
+  for (unsigned i = 0; i < 3; ++i)
+  {
+    recorder.collectText(0, librevenge::RVNGBinaryData(std::vector<unsigned char>(1024).data(), 1024), libvisio::VSD_TEXT_UTF16);
+    recorder.rewind();
+  }
+  // The rewound calls no longer count
+  recorder.collectText(0, librevenge::RVNGBinaryData(std::vector<unsigned char>(1024).data(), 1024), libvisio::VSD_TEXT_UTF16);
+  CPPUNIT_ASSERT(!recorder.isDiscarded());
+}
+
+void VSDRecordingCollectorTest::testReplayCorpus()
+{
+  for (const char *filename : CORPUS)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(filename, parse(filename, false), parse(filename, true));
+}
+
+void VSDRecordingCollectorTest::testDiscardedCorpus()
+{
+  // The record overflows at once and the documents are parsed again
+  for (const char *filename : CORPUS)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(filename, parse(filename, false), parse(filename, true, 1));
+}
+
+void VSDRecordingCollectorTest::testThreadedCorpus()
+{
+  for (const char *filename : CORPUS)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(filename, parse(filename, true), parse(filename, true, VSD_RECORDING_DEFAULT_SIZE, 4));
+}
+
+void VSDRecordingCollectorTest::testThreadedFailure()
+{
+  libvisio::VSDRecordingCollector recorder(m_stylesCollector.get());
+  for (unsigned page = 0; page < 2; ++page)
+  {
+    recorder.startPage(page);
+    recorder.collectPage(page, 0, MINUS_ONE, false, libvisio::VSDName());
+    recorder.endPage();
+  }
+  recorder.endPages();
+
+  libvisio::VSDStyles styles;
+  libvisio::VSDStencils stencils;
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlTextWriterPtr writer = xmlNewTextWriterMemory(buffer, 0);
+  {
+    libvisio::XmlDrawingGenerator painter(writer);
+    libvisio::VSDContentCollector collector(&painter, m_groupXFormsSequence, m_groupMembershipsSequence, m_documentPageShapeOrders,
+                                            styles, stencils, std::optional<unsigned>(), std::optional<unsigned>());
+    // The collector of the 2nd page cannot be created
+    unsigned created = 0;
+    const auto createCollector = [&]()
+    {
+      if (created++)
+        throw std::runtime_error("no collector");
+      return std::unique_ptr<libvisio::VSDContentCollector>(
+               new libvisio::VSDContentCollector(nullptr, m_groupXFormsSequence, m_groupMembershipsSequence, m_documentPageShapeOrders,
+                                                 styles, stencils, std::optional<unsigned>(), std::optional<unsigned>()));
+    };
+    CPPUNIT_ASSERT_THROW(recorder.replay(&collector, createCollector, 2), std::runtime_error);
+    xmlTextWriterFlush(writer);
+    // The 1st page was not drawn
+    CPPUNIT_ASSERT_EQUAL(0, xmlBufferLength(buffer));
+  }
+  xmlFreeTextWriter(writer);
+  xmlBufferFree(buffer);
+}
+
+void VSDRecordingCollectorTest::testPagesBeforeMasters()
+{
+  // The page needs the master that comes after it, so the record is
+  // discarded and the rest of the 1st pass only scans the structure
+  const char vdx[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<VisioDocument xmlns=\"http://schemas.microsoft.com/visio/2003/core\">"
+    "<Pages><Page ID=\"0\" NameU=\"Page-1\">"
+    "<PageSheet><PageProps><PageWidth>8.5</PageWidth><PageHeight>11</PageHeight></PageProps></PageSheet>"
+    "<Shapes>"
+    "<Shape ID=\"1\" Type=\"Shape\" Master=\"2\">"
+    "<XForm><PinX>2</PinX><PinY>2</PinY><Width>2</Width><Height>1</Height><LocPinX>1</LocPinX><LocPinY>0.5</LocPinY></XForm>"
+    "</Shape>"
+    "<Shape ID=\"2\" Type=\"Shape\">"
+    "<XForm><PinX>5</PinX><PinY>5</PinY><Width>1</Width><Height>1</Height><LocPinX>0.5</LocPinX><LocPinY>0.5</LocPinY></XForm>"
+    "<Geom IX=\"0\"><NoFill>1</NoFill><NoLine>0</NoLine><NoShow>0</NoShow>"
+    "<MoveTo IX=\"1\"><X>0</X><Y>0</Y></MoveTo><LineTo IX=\"2\"><X>1</X><Y>1</Y></LineTo></Geom>"
+    "</Shape>"
+    "</Shapes></Page></Pages>"
+    "<Masters><Master ID=\"2\" NameU=\"Box\"><Shapes>"
+    "<Shape ID=\"5\" Type=\"Shape\">"
+    "<XForm><PinX>1</PinX><PinY>0.5</PinY><Width>2</Width><Height>1</Height><LocPinX>1</LocPinX><LocPinY>0.5</LocPinY></XForm>"
+    "<Geom IX=\"0\"><NoFill>0</NoFill><NoLine>0</NoLine><NoShow>0</NoShow>"
+    "<MoveTo IX=\"1\"><X>0</X><Y>0</Y></MoveTo><LineTo IX=\"2\"><X>2</X><Y>0</Y></LineTo>"
+    "<LineTo IX=\"3\"><X>2</X><Y>1</Y></LineTo><LineTo IX=\"4\"><X>0</X><Y>1</Y></LineTo></Geom>"
+    "</Shape>"
+    "</Shapes></Master></Masters>"
+    "</VisioDocument>";
+
+  librevenge::RVNGStringStream singlePassInput(reinterpret_cast<const unsigned char *>(vdx), sizeof(vdx) - 1);
+  const std::string singlePass = paint(singlePassInput, "pages-before-masters.vdx", true);
+  librevenge::RVNGStringStream twoPassInput(reinterpret_cast<const unsigned char *>(vdx), sizeof(vdx) - 1);
+  const std::string twoPass = paint(twoPassInput, "pages-before-masters.vdx", false);
+  CPPUNIT_ASSERT_EQUAL(twoPass, singlePass);
+  // The geometry of the master and of the plain shape
+  CPPUNIT_ASSERT_EQUAL(2u, countOccurrences(singlePass, "<drawPath"));
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDRecordingCollectorTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,176 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "VSDStylesCollector.h"
+#include "VSDTypes.h"
+
+namespace test
+{
+
+namespace
+{
+
+// The levels of the shapes on a page and of their content
+#define SHAPE_LEVEL 1
+#define SHAPE_CONTENT_LEVEL 2
+
+libvisio::XForm makeXForm(double pinX)
+{
+  libvisio::XForm xform;
+  xform.pinX = pinX;
+  return xform;
+}
+
+void collectShape(libvisio::VSDStylesCollector &collector, unsigned id, unsigned parent)
+{
+  collector.collectShape(id, SHAPE_LEVEL, parent, MINUS_ONE, MINUS_ONE, MINUS_ONE, MINUS_ONE, MINUS_ONE, libvisio::VSDName());
+}
+
+std::list<unsigned> makeList(const std::vector<unsigned> &ids)
+{
+  return std::list<unsigned>(ids.begin(), ids.end());
+}
+
+}
+
+class VSDStylesCollectorTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDStylesCollectorTest);
+  CPPUNIT_TEST(testGroups);
+  CPPUNIT_TEST(testShapeEndsOnLevelChange);
+  CPPUNIT_TEST(testPagesAreSeparate);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testGroups();
+  void testShapeEndsOnLevelChange();
+  void testPagesAreSeparate();
+
+  std::vector<std::map<unsigned, libvisio::XForm> > m_groupXFormsSequence;
+  std::vector<std::map<unsigned, unsigned> > m_groupMembershipsSequence;
+  std::vector<std::list<unsigned> > m_documentPageShapeOrders;
+};
+
+void VSDStylesCollectorTest::setUp()
+{
+}
+
+void VSDStylesCollectorTest::tearDown()
+{
+  m_groupXFormsSequence.clear();
+  m_groupMembershipsSequence.clear();
+  m_documentPageShapeOrders.clear();
+}
+
+void VSDStylesCollectorTest::testGroups()
+{
+  libvisio::VSDStylesCollector collector(m_groupXFormsSequence, m_groupMembershipsSequence, m_documentPageShapeOrders);
+  collector.startPage(0);
+  collector.collectPageSheet(0, SHAPE_LEVEL);
+  // Group 1 holds shape 2 and group 3, which holds shape 4
+  collectShape(collector, 1, MINUS_ONE);
+  collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(1.0));
+  collector.collectShapesOrder(0, SHAPE_CONTENT_LEVEL, std::vector<unsigned> { 2, 3 });
+  collectShape(collector, 2, 1);
+  collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(2.0));
+  collectShape(collector, 3, 1);
+  collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(3.0));
+  collector.collectShapesOrder(0, SHAPE_CONTENT_LEVEL, std::vector<unsigned> { 4 });
+  collectShape(collector, 4, 3);
+  collectShape(collector, 5, MINUS_ONE);
+  collector.collectUnhandledChunk(0, 0);
+  collector.collectShapesOrder(0, SHAPE_LEVEL, std::vector<unsigned> { 1, 5 });
+  collector.endPage();
+  collector.endPages();
+
+  CPPUNIT_ASSERT_EQUAL(size_t(1), m_documentPageShapeOrders.size());
+  CPPUNIT_ASSERT(makeList({ 1, 2, 3, 4, 5 }) == m_documentPageShapeOrders[0]);
+
+  CPPUNIT_ASSERT_EQUAL(size_t(1), m_groupMembershipsSequence.size());
+  std::map<unsigned, unsigned> memberships;
+  memberships[2] = 1;
+  memberships[3] = 1;
+  memberships[4] = 3;
+  CPPUNIT_ASSERT(memberships == m_groupMembershipsSequence[0]);
+
+  CPPUNIT_ASSERT_EQUAL(size_t(1), m_groupXFormsSequence.size());
+  const std::map<unsigned, libvisio::XForm> &xforms = m_groupXFormsSequence[0];
+  CPPUNIT_ASSERT_EQUAL(size_t(3), xforms.size());
+  for (unsigned id = 1; id <= 3; ++id)
+  {
+    CPPUNIT_ASSERT(xforms.find(id) != xforms.end());
+    CPPUNIT_ASSERT_EQUAL(double(id), xforms.find(id)->second.pinX);
+  }
+}
+
+// Any call at the level of the shapes ends the current shape, also one the styles pass ignores
+void VSDStylesCollectorTest::testShapeEndsOnLevelChange()
+{
+  libvisio::VSDStylesCollector collector(m_groupXFormsSequence, m_groupMembershipsSequence, m_documentPageShapeOrders);
+  collector.startPage(0);
+  collector.collectPageSheet(0, SHAPE_LEVEL);
+  collectShape(collector, 1, MINUS_ONE);
+  collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(1.0));
+  collector.collectLine(SHAPE_LEVEL, std::optional<double>(), std::optional<libvisio::Colour>(), std::optional<unsigned char>(),
+                        std::optional<unsigned char>(), std::optional<unsigned char>(), std::optional<unsigned char>(),
+                        std::optional<double>(), std::optional<long>(), std::optional<long>());
+  // Neither belongs to shape 1
+  collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(2.0));
+  collector.collectShapesOrder(0, SHAPE_CONTENT_LEVEL, std::vector<unsigned> { 1 });
+  collector.endPage();
+
+  CPPUNIT_ASSERT_EQUAL(1.0, m_groupXFormsSequence[0][1].pinX);
+  CPPUNIT_ASSERT(makeList({ 1 }) == m_documentPageShapeOrders[0]);
+}
+
+void VSDStylesCollectorTest::testPagesAreSeparate()
+{
+  libvisio::VSDStylesCollector collector(m_groupXFormsSequence, m_groupMembershipsSequence, m_documentPageShapeOrders);
+  collector.startPage(0);
+  collector.collectPageSheet(0, SHAPE_LEVEL);
+  collectShape(collector, 1, MINUS_ONE);
+  collector.collectXFormData(SHAPE_CONTENT_LEVEL, makeXForm(1.0));
+  collectShape(collector, 2, 1);
+  collector.collectUnhandledChunk(0, 0);
+  collector.collectShapesOrder(0, SHAPE_LEVEL, std::vector<unsigned> { 1 });
+  collector.endPage();
+
+  collector.startPage(1);
+  collector.collectPageSheet(1, SHAPE_LEVEL);
+  collectShape(collector, 3, MINUS_ONE);
+  collector.collectUnhandledChunk(0, 0);
+  collector.collectShapesOrder(0, SHAPE_LEVEL, std::vector<unsigned> { 3 });
+  collector.endPage();
+
+  CPPUNIT_ASSERT_EQUAL(size_t(2), m_documentPageShapeOrders.size());
+  CPPUNIT_ASSERT(makeList({ 1 }) == m_documentPageShapeOrders[0]);
+  CPPUNIT_ASSERT(makeList({ 3 }) == m_documentPageShapeOrders[1]);
+  CPPUNIT_ASSERT_EQUAL(size_t(1), m_groupMembershipsSequence[0].size());
+  CPPUNIT_ASSERT(m_groupMembershipsSequence[1].empty());
+  CPPUNIT_ASSERT_EQUAL(size_t(1), m_groupXFormsSequence[0].size());
+  CPPUNIT_ASSERT(m_groupXFormsSequence[1].empty());
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDStylesCollectorTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
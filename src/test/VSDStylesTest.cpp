@@ -0,0 +1,223 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "VSDInternalStream.h"
+#include "VSDStyles.h"
+#include "VSDXTheme.h"
+
+namespace test
+{
+
+class VSDStylesTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDStylesTest);
+  CPPUNIT_TEST(testMasterChain);
+  CPPUNIT_TEST(testAddAfterLookup);
+  CPPUNIT_TEST(testTextStyleMasterChain);
+  CPPUNIT_TEST(testFillStyleMasterChain);
+  CPPUNIT_TEST(testThemedFillStyle);
+  CPPUNIT_TEST(testCopy);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testMasterChain();
+  void testAddAfterLookup();
+  void testTextStyleMasterChain();
+  void testFillStyleMasterChain();
+  void testThemedFillStyle();
+  void testCopy();
+};
+
+void VSDStylesTest::setUp()
+{
+}
+
+void VSDStylesTest::tearDown()
+{
+}
+
+namespace
+{
+
+libvisio::VSDOptionalLineStyle makeLineStyle(const std::optional<double> &width, const std::optional<unsigned char> &pattern)
+{
+  libvisio::VSDOptionalLineStyle style;
+  style.width = width;
+  style.pattern = pattern;
+  return style;
+}
+
+libvisio::VSDOptionalFillStyle makeFillStyle(const std::optional<unsigned char> &pattern, const std::optional<long> &qsFillColour)
+{
+  libvisio::VSDOptionalFillStyle style;
+  style.pattern = pattern;
+  style.qsFillColour = qsFillColour;
+  return style;
+}
+
+/// Parses a theme whose first accent colour is accent, given as RRGGBB.
+void parseTheme(libvisio::VSDXTheme &theme, const char *accent)
+{
+  const std::string xml = std::string("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                                      "<a:theme xmlns:a=\"http://schemas.openxmlformats.org/drawingml/2006/main\">"
+                                      "<a:themeElements><a:clrScheme name=\"test\"><a:accent1><a:srgbClr val=\"")
+                          + accent + "\"/></a:accent1></a:clrScheme></a:themeElements></a:theme>";
+  VSDInternalStream input(reinterpret_cast<const unsigned char *>(xml.data()), xml.size());
+  CPPUNIT_ASSERT(theme.parse(&input));
+}
+
+}
+
+void VSDStylesTest::testMasterChain()
+{
+  libvisio::VSDStyles styles;
+  styles.addLineStyle(0, makeLineStyle(0.5, 2));
+  styles.addLineStyle(1, makeLineStyle(0.25, std::optional<unsigned char>()));
+  styles.addLineStyleMaster(1, 0);
+  // A cycle must not loop forever
+  styles.addLineStyleMaster(0, 1);
+
+  const libvisio::VSDOptionalLineStyle &style = styles.getOptionalLineStyle(1);
+  CPPUNIT_ASSERT_EQUAL(0.25, style.width.value());
+  CPPUNIT_ASSERT_EQUAL((unsigned char)2, style.pattern.value());
+  CPPUNIT_ASSERT(!styles.getOptionalLineStyle(MINUS_ONE).width);
+}
+
+// Adding a style or a master after a lookup must not return stale results
+void VSDStylesTest::testAddAfterLookup()
+{
+  libvisio::VSDStyles styles;
+  styles.addLineStyle(1, makeLineStyle(std::optional<double>(), 1));
+  CPPUNIT_ASSERT(!styles.getOptionalLineStyle(1).width);
+
+  styles.addLineStyle(0, makeLineStyle(0.5, 2));
+  styles.addLineStyleMaster(1, 0);
+  CPPUNIT_ASSERT_EQUAL(0.5, styles.getOptionalLineStyle(1).width.value());
+
+  styles.addLineStyle(0, makeLineStyle(0.75, 2));
+  CPPUNIT_ASSERT_EQUAL(0.75, styles.getOptionalLineStyle(1).width.value());
+  CPPUNIT_ASSERT_EQUAL((unsigned char)1, styles.getOptionalLineStyle(1).pattern.value());
+
+  libvisio::VSDOptionalFillStyle fillStyle;
+  fillStyle.pattern = 3;
+  styles.addFillStyle(2, fillStyle);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)3, styles.getFillStyle(2, nullptr).pattern);
+  fillStyle.pattern = 4;
+  styles.addFillStyle(2, fillStyle);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)4, styles.getFillStyle(2, nullptr).pattern);
+}
+
+// Text block, char and para styles share one master chain
+void VSDStylesTest::testTextStyleMasterChain()
+{
+  libvisio::VSDStyles styles;
+  libvisio::VSDOptionalCharStyle charStyle;
+  charStyle.size = 12.0;
+  charStyle.bold = true;
+  styles.addCharStyle(0, charStyle);
+  libvisio::VSDOptionalParaStyle paraStyle;
+  paraStyle.indFirst = 0.5;
+  styles.addParaStyle(0, paraStyle);
+  libvisio::VSDOptionalTextBlockStyle textBlockStyle;
+  textBlockStyle.leftMargin = 0.1;
+  styles.addTextBlockStyle(0, textBlockStyle);
+
+  charStyle.size = 10.0;
+  charStyle.bold = std::optional<bool>();
+  styles.addCharStyle(1, charStyle);
+  styles.addTextStyleMaster(1, 0);
+  styles.addTextStyleMaster(2, 1);
+
+  CPPUNIT_ASSERT_EQUAL(10.0, styles.getOptionalCharStyle(2).size.value());
+  CPPUNIT_ASSERT(styles.getOptionalCharStyle(2).bold.value());
+  CPPUNIT_ASSERT_EQUAL(0.5, styles.getOptionalParaStyle(2).indFirst.value());
+  CPPUNIT_ASSERT_EQUAL(0.1, styles.getOptionalTextBlockStyle(2).leftMargin.value());
+
+  // Each kind is cached on its own
+  paraStyle.indFirst = 0.25;
+  styles.addParaStyle(1, paraStyle);
+  CPPUNIT_ASSERT_EQUAL(0.25, styles.getOptionalParaStyle(2).indFirst.value());
+  CPPUNIT_ASSERT_EQUAL(10.0, styles.getOptionalCharStyle(2).size.value());
+  CPPUNIT_ASSERT_EQUAL(0.1, styles.getOptionalTextBlockStyle(2).leftMargin.value());
+
+  // A style without a master stops the chain
+  CPPUNIT_ASSERT_EQUAL(12.0, styles.getOptionalCharStyle(0).size.value());
+  CPPUNIT_ASSERT(!styles.getOptionalParaStyle(3).indFirst);
+}
+
+void VSDStylesTest::testFillStyleMasterChain()
+{
+  libvisio::VSDStyles styles;
+  styles.addFillStyle(0, makeFillStyle(1, std::optional<long>()));
+  styles.addFillStyle(1, makeFillStyle(std::optional<unsigned char>(), 4));
+  styles.addFillStyleMaster(1, 0);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)1, styles.getOptionalFillStyle(1).pattern.value());
+  CPPUNIT_ASSERT_EQUAL(4L, styles.getOptionalFillStyle(1).qsFillColour.value());
+  CPPUNIT_ASSERT_EQUAL((unsigned char)1, styles.getFillStyle(1, nullptr).pattern);
+
+  styles.addFillStyleMaster(1, 2);
+  CPPUNIT_ASSERT(!styles.getOptionalFillStyle(1).pattern);
+  CPPUNIT_ASSERT_EQUAL((unsigned char)0, styles.getFillStyle(1, nullptr).pattern);
+}
+
+// Fill styles are cached with the theme they were resolved with
+void VSDStylesTest::testThemedFillStyle()
+{
+  libvisio::VSDXTheme red;
+  parseTheme(red, "FF0000");
+  libvisio::VSDXTheme green;
+  parseTheme(green, "00FF00");
+  libvisio::VSDStyles styles;
+  // The first accent colour of the theme
+  styles.addFillStyle(1, makeFillStyle(1, 2));
+
+  CPPUNIT_ASSERT(libvisio::Colour() == styles.getFillStyle(1, nullptr).fgColour);
+  CPPUNIT_ASSERT(libvisio::Colour(0xff, 0, 0, 0) == styles.getFillStyle(1, &red).fgColour);
+  CPPUNIT_ASSERT(libvisio::Colour(0, 0xff, 0, 0) == styles.getFillStyle(1, &green).fgColour);
+  CPPUNIT_ASSERT(libvisio::Colour(0xff, 0, 0, 0) == styles.getFillStyle(1, &red).fgColour);
+  CPPUNIT_ASSERT(libvisio::Colour() == styles.getFillStyle(1, nullptr).fgColour);
+
+  // Adding a style drops the styles resolved with the theme too
+  CPPUNIT_ASSERT(libvisio::Colour(0xff, 0, 0, 0) == styles.getFillStyle(1, &red).fgColour);
+  styles.addFillStyle(1, makeFillStyle(1, std::optional<long>()));
+  CPPUNIT_ASSERT(libvisio::Colour() == styles.getFillStyle(1, &red).fgColour);
+}
+
+// A copy keeps its own cache
+void VSDStylesTest::testCopy()
+{
+  libvisio::VSDStyles styles;
+  styles.addLineStyle(0, makeLineStyle(0.5, 2));
+  styles.addLineStyleMaster(1, 0);
+  CPPUNIT_ASSERT_EQUAL(0.5, styles.getOptionalLineStyle(1).width.value());
+
+  libvisio::VSDStyles copy(styles);
+  styles.addLineStyle(0, makeLineStyle(0.75, 2));
+  CPPUNIT_ASSERT_EQUAL(0.75, styles.getOptionalLineStyle(1).width.value());
+  CPPUNIT_ASSERT_EQUAL(0.5, copy.getOptionalLineStyle(1).width.value());
+
+  copy = styles;
+  CPPUNIT_ASSERT_EQUAL(0.75, copy.getOptionalLineStyle(1).width.value());
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDStylesTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -7,12 +7,23 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <librevenge-stream/librevenge-stream.h>
 
 #include "VSDXMLHelper.h"
+#include "VSDXPackage.h"
+#include "VSDXParsedParts.h"
+#include "libvisio_xml.h"
 
 namespace test
 {
@@ -26,10 +37,18 @@ public:
 private:
   CPPUNIT_TEST_SUITE(VSDXMLHelperTest);
   CPPUNIT_TEST(testRebaseTargetOverPop);
+  CPPUNIT_TEST(testRelationshipsByTypeOrder);
+  CPPUNIT_TEST(testConstAttribute);
+  CPPUNIT_TEST(testParsedParts);
+  CPPUNIT_TEST(testPrefetchSelectedPages);
   CPPUNIT_TEST_SUITE_END();
 
 private:
   void testRebaseTargetOverPop();
+  void testRelationshipsByTypeOrder();
+  void testConstAttribute();
+  void testParsedParts();
+  void testPrefetchSelectedPages();
 };
 
 void VSDXMLHelperTest::setUp()
@@ -66,6 +85,235 @@ void VSDXMLHelperTest::testRebaseTargetOverPop()
   CPPUNIT_ASSERT_EQUAL(std::string("trigger"), r->getTarget());
 }
 
+// Relationships of a type come in the order of the relationships part, not of their ids
+void VSDXMLHelperTest::testRelationshipsByTypeOrder()
+{
+  static const char rels[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId10\" Type=\"http://schemas.microsoft.com/visio/2010/relationships/page\" Target=\"page1.xml\"/>"
+    "<Relationship Id=\"rId3\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/image\" Target=\"image1.png\"/>"
+    "<Relationship Id=\"rId2\" Type=\"http://schemas.microsoft.com/visio/2010/relationships/page\" Target=\"page2.xml\"/>"
+    "</Relationships>";
+
+  librevenge::RVNGStringStream input(reinterpret_cast<const unsigned char *>(rels),
+                                     sizeof(rels) - 1);
+  libvisio::VSDXRelationships parsed(&input);
+  parsed.rebaseTargets("visio/pages");
+
+  const std::vector<const libvisio::VSDXRelationship *> pages
+    = parsed.getRelationshipsByType("http://schemas.microsoft.com/visio/2010/relationships/page");
+  CPPUNIT_ASSERT_EQUAL(size_t(2), pages.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("visio/pages/page1.xml"), pages[0]->getTarget());
+  CPPUNIT_ASSERT_EQUAL(std::string("visio/pages/page2.xml"), pages[1]->getTarget());
+  CPPUNIT_ASSERT(parsed.getRelationshipsByType("unknown").empty());
+}
+
+// Attribute values read without a copy are the ones xmlTextReaderGetAttribute gives
+void VSDXMLHelperTest::testConstAttribute()
+{
+  static const char *const xmls[] =
+  {
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<Cells xmlns:x=\"urn:x\"><Cell N=\"PinX\" V=\"1.5\" E=\"a&amp;b&#33;\" x:N=\"other\"/></Cells>",
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<!DOCTYPE Cells [<!ENTITY e \"entity\"><!ATTLIST Cell D CDATA \"default\">]>"
+    "<Cells xmlns:x=\"urn:x\"><Cell N=\"PinX\" V=\"1.5\" E=\"a&amp;b&#33;\" R=\"&e;\" x:N=\"other\"/></Cells>"
+  };
+  const char *const names[] = { "N", "V", "E", "R", "D", "F", "x:N", "xmlns:x" };
+
+  for (const char *xml : xmls)
+  {
+    librevenge::RVNGStringStream input(reinterpret_cast<const unsigned char *>(xml), strlen(xml));
+    auto reader = libvisio::xmlReaderForStream(&input);
+    CPPUNIT_ASSERT(bool(reader));
+    int ret = xmlTextReaderRead(reader.get());
+    while (1 == ret && !xmlStrEqual(xmlTextReaderConstName(reader.get()), BAD_CAST("Cell")))
+      ret = xmlTextReaderRead(reader.get());
+    CPPUNIT_ASSERT_EQUAL(1, ret);
+
+    for (const char *name : names)
+    {
+      const std::unique_ptr<xmlChar, void (*)(void *)> expected(xmlTextReaderGetAttribute(reader.get(), BAD_CAST(name)), xmlFree);
+      std::unique_ptr<xmlChar, void (*)(void *)> copy(nullptr, xmlFree);
+      const xmlChar *const value = libvisio::xmlReaderConstAttribute(reader.get(), name, copy);
+      CPPUNIT_ASSERT_EQUAL(bool(expected), bool(value));
+      if (expected)
+        CPPUNIT_ASSERT(xmlStrEqual(expected.get(), value));
+    }
+  }
+}
+
+namespace
+{
+
+std::string readEvents(xmlTextReaderPtr reader)
+{
+  std::string events;
+  while (1 == xmlTextReaderRead(reader))
+  {
+    events += std::to_string(xmlTextReaderNodeType(reader)) + (xmlTextReaderIsEmptyElement(reader) ? "e " : " ");
+    const xmlChar *const name = xmlTextReaderConstLocalName(reader);
+    if (name)
+      events += reinterpret_cast<const char *>(name);
+    events += ";";
+  }
+  return events;
+}
+
+}
+
+// A part is only handed out parsed if walking its tree reads like the part itself
+void VSDXMLHelperTest::testParsedParts()
+{
+  static const char *const xmls[] =
+  {
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><Page><Shapes><Shape ID=\"1\"/><Shape ID=\"2\" /></Shapes></Page>",
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><Page><Shapes><Shape ID=\"1\"></Shape></Shapes></Page>",
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><Page><Shapes>",
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><Page><x:Shapes/></Page>",
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><!DOCTYPE Page [<!ENTITY e \"entity\">]><Page>&e;</Page>"
+  };
+  const bool isParsed[] = { true, false, false, false, false };
+
+  std::vector<std::pair<std::string, libvisio::VSDXPackage::Buffer_t> > parts;
+  for (const char *xml : xmls)
+    parts.push_back(std::make_pair(std::to_string(parts.size()),
+                                   std::make_shared<const std::vector<unsigned char> >(xml, xml + strlen(xml))));
+  libvisio::VSDXParsedParts parsedParts(parts, 2);
+
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    const libvisio::VSDXParsedParts::Document_t document = parsedParts.take(parts[i].first);
+    CPPUNIT_ASSERT_EQUAL(isParsed[i], bool(document));
+    if (!document)
+      continue;
+    const std::unique_ptr<xmlTextReader, void (*)(xmlTextReaderPtr)> walker(xmlReaderWalker(document.get()), xmlFreeTextReader);
+    librevenge::RVNGStringStream input(parts[i].second->data(), (unsigned)parts[i].second->size());
+    auto reader = libvisio::xmlReaderForStream(&input);
+    CPPUNIT_ASSERT_EQUAL(readEvents(reader.get()), readEvents(walker.get()));
+  }
+  // Every part is handed out once
+  CPPUNIT_ASSERT(!parsedParts.take(parts[0].first));
+}
+
+namespace
+{
+
+// A package whose parts are strings, remembering which parts were opened
+class PartsStream : public librevenge::RVNGInputStream
+{
+public:
+  explicit PartsStream(const std::map<std::string, std::string> &parts) : m_parts(parts), m_mutex(), m_opened() {}
+
+  std::map<std::string, unsigned> getOpened()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_opened;
+  }
+
+  bool isStructured() override
+  {
+    return true;
+  }
+  unsigned subStreamCount() override
+  {
+    return unsigned(m_parts.size());
+  }
+  const char *subStreamName(unsigned) override
+  {
+    return nullptr;
+  }
+  bool existsSubStream(const char *name) override
+  {
+    return m_parts.count(name);
+  }
+  librevenge::RVNGInputStream *getSubStreamByName(const char *name) override
+  {
+    const auto iter = m_parts.find(name);
+    if (iter == m_parts.end())
+      return nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      ++m_opened[name];
+    }
+    return new librevenge::RVNGStringStream(reinterpret_cast<const unsigned char *>(iter->second.data()), unsigned(iter->second.size()));
+  }
+  librevenge::RVNGInputStream *getSubStreamById(unsigned) override
+  {
+    return nullptr;
+  }
+  const unsigned char *read(unsigned long, unsigned long &numBytesRead) override
+  {
+    numBytesRead = 0;
+    return nullptr;
+  }
+  int seek(long, librevenge::RVNG_SEEK_TYPE) override
+  {
+    return 0;
+  }
+  long tell() override
+  {
+    return 0;
+  }
+  bool isEnd() override
+  {
+    return true;
+  }
+
+private:
+  const std::map<std::string, std::string> m_parts;
+  std::mutex m_mutex;
+  std::map<std::string, unsigned> m_opened;
+};
+
+std::string makePageRels(unsigned count)
+{
+  std::string rels =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+  for (unsigned i = 1; i <= count; ++i)
+    rels += "<Relationship Id=\"rId" + std::to_string(i) + "\" Type=\"http://schemas.microsoft.com/visio/2010/relationships/page\""
+            " Target=\"page" + std::to_string(i) + ".xml\"/>";
+  return rels + "</Relationships>";
+}
+
+}
+
+// Pages left out of the prefetch are not read unless asked for
+void VSDXMLHelperTest::testPrefetchSelectedPages()
+{
+  std::map<std::string, std::string> parts;
+  parts["visio/document.xml"] = "<VisioDocument/>";
+  parts["visio/_rels/document.xml.rels"] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId1\" Type=\"http://schemas.microsoft.com/visio/2010/relationships/pages\" Target=\"pages/pages.xml\"/>"
+    "</Relationships>";
+  parts["visio/pages/pages.xml"] = "<Pages/>";
+  parts["visio/pages/_rels/pages.xml.rels"] = makePageRels(3);
+  for (unsigned i = 1; i <= 3; ++i)
+    parts["visio/pages/page" + std::to_string(i) + ".xml"] = "<PageContents/>";
+
+  PartsStream input(parts);
+  {
+    libvisio::VSDXPackage package(&input);
+    package.prefetch("visio/document.xml", false);
+    // Give the prefetching thread the time to get to the pages before it is stopped
+    while (!input.getOpened().count("visio/pages/_rels/pages.xml.rels"))
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CPPUNIT_ASSERT(bool(package.getPartData("visio/pages/pages.xml")));
+    package.prefetchParts(std::vector<std::string>(1, "visio/pages/page2.xml"));
+    CPPUNIT_ASSERT(bool(package.getPartData("visio/pages/page2.xml")));
+  }
+  std::map<std::string, unsigned> opened = input.getOpened();
+  CPPUNIT_ASSERT_EQUAL(0u, opened["visio/pages/page1.xml"]);
+  CPPUNIT_ASSERT_EQUAL(1u, opened["visio/pages/page2.xml"]);
+  CPPUNIT_ASSERT_EQUAL(0u, opened["visio/pages/page3.xml"]);
+  CPPUNIT_ASSERT_EQUAL(1u, opened["visio/pages/pages.xml"]);
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(VSDXMLHelperTest);
 
 }
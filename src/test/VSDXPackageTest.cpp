@@ -0,0 +1,290 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <librevenge-stream/librevenge-stream.h>
+
+#include "VSDXPackage.h"
+
+namespace test
+{
+
+namespace
+{
+
+const char MASTER_TYPE[] = "http://schemas.microsoft.com/visio/2010/relationships/master";
+const char PAGE_TYPE[] = "http://schemas.microsoft.com/visio/2010/relationships/page";
+const char PAGES_TYPE[] = "http://schemas.microsoft.com/visio/2010/relationships/pages";
+
+/// Counts how often each part of the package is opened
+class CountingStream : public librevenge::RVNGInputStream
+{
+  // disable copying
+  CountingStream(const CountingStream &other);
+  CountingStream &operator=(const CountingStream &other);
+
+public:
+  explicit CountingStream(const char *filename)
+    : m_input(filename), m_opened()
+  {
+  }
+
+  bool isStructured() override
+  {
+    return m_input.isStructured();
+  }
+  unsigned subStreamCount() override
+  {
+    return m_input.subStreamCount();
+  }
+  const char *subStreamName(unsigned id) override
+  {
+    return m_input.subStreamName(id);
+  }
+  bool existsSubStream(const char *name) override
+  {
+    return m_input.existsSubStream(name);
+  }
+  librevenge::RVNGInputStream *getSubStreamByName(const char *name) override
+  {
+    ++m_opened[name];
+    return m_input.getSubStreamByName(name);
+  }
+  librevenge::RVNGInputStream *getSubStreamById(unsigned id) override
+  {
+    return m_input.getSubStreamById(id);
+  }
+  const unsigned char *read(unsigned long numBytes, unsigned long &numBytesRead) override
+  {
+    return m_input.read(numBytes, numBytesRead);
+  }
+  int seek(long offset, librevenge::RVNG_SEEK_TYPE seekType) override
+  {
+    return m_input.seek(offset, seekType);
+  }
+  long tell() override
+  {
+    return m_input.tell();
+  }
+  bool isEnd() override
+  {
+    return m_input.isEnd();
+  }
+
+  unsigned getOpenCount(const std::string &name) const
+  {
+    const auto iter = m_opened.find(name);
+    return iter == m_opened.end() ? 0 : iter->second;
+  }
+
+private:
+  librevenge::RVNGFileStream m_input;
+  std::map<std::string, unsigned> m_opened;
+};
+
+}
+
+class VSDXPackageTest : public CPPUNIT_NS::TestFixture
+{
+public:
+  virtual void setUp();
+  virtual void tearDown();
+
+private:
+  CPPUNIT_TEST_SUITE(VSDXPackageTest);
+  CPPUNIT_TEST(testPartReadOnce);
+  CPPUNIT_TEST(testMissingPart);
+  CPPUNIT_TEST(testRelationships);
+  CPPUNIT_TEST(testSizeCeiling);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST(testPrefetch);
+  CPPUNIT_TEST(testNotStructured);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  void testPartReadOnce();
+  void testMissingPart();
+  void testRelationships();
+  void testSizeCeiling();
+  void testClear();
+  void testPrefetch();
+  void testNotStructured();
+};
+
+void VSDXPackageTest::setUp()
+{
+}
+
+void VSDXPackageTest::tearDown()
+{
+}
+
+void VSDXPackageTest::testPartReadOnce()
+{
+  CountingStream input(TDOC "/testfile1.vsdx");
+  libvisio::VSDXPackage package(&input);
+
+  const libvisio::VSDXPackage::Buffer_t data = package.getPartData("visio/pages/page1.xml");
+  CPPUNIT_ASSERT(bool(data));
+  CPPUNIT_ASSERT(!data->empty());
+  CPPUNIT_ASSERT_EQUAL(std::string("<?xml"), std::string(data->begin(), data->begin() + 5));
+  CPPUNIT_ASSERT_EQUAL((unsigned long)data->size(), package.getSize());
+
+  // Each stream is a view of its own over the same data
+  const libvisio::RVNGInputStreamPtr_t first = package.getPart("visio/pages/page1.xml");
+  const libvisio::RVNGInputStreamPtr_t second = package.getPart("visio/pages/page1.xml");
+  CPPUNIT_ASSERT(first && second);
+  unsigned long numBytesRead = 0;
+  first->read(5, numBytesRead);
+  CPPUNIT_ASSERT_EQUAL(5L, first->tell());
+  CPPUNIT_ASSERT_EQUAL(0L, second->tell());
+  CPPUNIT_ASSERT(data == package.getPartData("visio/pages/page1.xml"));
+
+  CPPUNIT_ASSERT_EQUAL(1u, input.getOpenCount("visio/pages/page1.xml"));
+  CPPUNIT_ASSERT_EQUAL((unsigned long)data->size(), package.getSize());
+}
+
+void VSDXPackageTest::testMissingPart()
+{
+  CountingStream input(TDOC "/testfile1.vsdx");
+  libvisio::VSDXPackage package(&input);
+  CPPUNIT_ASSERT(!package.getPartData("visio/pages/page2.xml"));
+  CPPUNIT_ASSERT(!package.getPart("visio/pages/page2.xml"));
+  CPPUNIT_ASSERT_EQUAL(1u, input.getOpenCount("visio/pages/page2.xml"));
+  CPPUNIT_ASSERT_EQUAL(0ul, package.getSize());
+}
+
+void VSDXPackageTest::testRelationships()
+{
+  CountingStream input(TDOC "/testfile1.vsdx");
+  libvisio::VSDXPackage package(&input);
+
+  // Targets are rebased to the directory of the part
+  const libvisio::VSDXRelationships &documentRels = package.getRelationships("visio/document.xml");
+  const libvisio::VSDXRelationship *pages = documentRels.getRelationshipByType(PAGES_TYPE);
+  CPPUNIT_ASSERT(pages);
+  CPPUNIT_ASSERT_EQUAL(std::string("visio/pages/pages.xml"), pages->getTarget());
+  const libvisio::VSDXRelationship *page = package.getRelationships(pages->getTarget()).getRelationshipByType(PAGE_TYPE);
+  CPPUNIT_ASSERT(page);
+  CPPUNIT_ASSERT_EQUAL(std::string("visio/pages/page1.xml"), page->getTarget());
+  const libvisio::VSDXRelationship *master = package.getRelationships(page->getTarget()).getRelationshipById("rId1");
+  CPPUNIT_ASSERT(master);
+  CPPUNIT_ASSERT_EQUAL(std::string(MASTER_TYPE), master->getType());
+  CPPUNIT_ASSERT_EQUAL(std::string("visio/masters/master3.xml"), master->getTarget());
+
+  CPPUNIT_ASSERT(&documentRels == &package.getRelationships("visio/document.xml"));
+  CPPUNIT_ASSERT_EQUAL(1u, input.getOpenCount("visio/_rels/document.xml.rels"));
+  // The .rels parts are not kept
+  CPPUNIT_ASSERT_EQUAL(0ul, package.getSize());
+
+  // A part without relationships has none
+  CPPUNIT_ASSERT(package.getRelationships("visio/windows.xml").getRelationshipsByType(PAGE_TYPE).empty());
+  package.getRelationships("visio/windows.xml");
+  CPPUNIT_ASSERT_EQUAL(1u, input.getOpenCount("visio/_rels/windows.xml.rels"));
+}
+
+void VSDXPackageTest::testSizeCeiling()
+{
+  unsigned long pageSize = 0;
+  {
+    CountingStream input(TDOC "/testfile1.vsdx");
+    libvisio::VSDXPackage package(&input);
+    pageSize = package.getPartData("visio/pages/page1.xml")->size();
+  }
+
+  CountingStream input(TDOC "/testfile1.vsdx");
+  libvisio::VSDXPackage package(&input, pageSize - 1);
+  // A part over the ceiling is read again each time
+  const libvisio::VSDXPackage::Buffer_t first = package.getPartData("visio/pages/page1.xml");
+  const libvisio::VSDXPackage::Buffer_t second = package.getPartData("visio/pages/page1.xml");
+  CPPUNIT_ASSERT(first && second);
+  CPPUNIT_ASSERT(*first == *second);
+  CPPUNIT_ASSERT_EQUAL(2u, input.getOpenCount("visio/pages/page1.xml"));
+  CPPUNIT_ASSERT_EQUAL(0ul, package.getSize());
+
+  // Smaller parts are kept while they fit together
+  unsigned long size = 0;
+  for (const char *name : { "visio/masters/master1.xml", "visio/masters/master2.xml", "visio/masters/master3.xml" })
+  {
+    const libvisio::VSDXPackage::Buffer_t data = package.getPartData(name);
+    CPPUNIT_ASSERT(bool(data));
+    if (size + data->size() <= pageSize - 1)
+      size += data->size();
+    CPPUNIT_ASSERT_EQUAL(size, package.getSize());
+  }
+  CPPUNIT_ASSERT(package.getSize() <= pageSize - 1);
+}
+
+void VSDXPackageTest::testClear()
+{
+  CountingStream input(TDOC "/testfile1.vsdx");
+  libvisio::VSDXPackage package(&input);
+  package.getPartData("visio/pages/page1.xml");
+  package.getPartData("visio/pages/page2.xml");
+  package.getRelationships("visio/document.xml");
+  package.clear();
+  CPPUNIT_ASSERT_EQUAL(0ul, package.getSize());
+
+  package.getPartData("visio/pages/page1.xml");
+  package.getPartData("visio/pages/page2.xml");
+  package.getRelationships("visio/document.xml");
+  CPPUNIT_ASSERT_EQUAL(2u, input.getOpenCount("visio/pages/page1.xml"));
+  CPPUNIT_ASSERT_EQUAL(2u, input.getOpenCount("visio/pages/page2.xml"));
+  CPPUNIT_ASSERT_EQUAL(2u, input.getOpenCount("visio/_rels/document.xml.rels"));
+}
+
+// Whether the parser or the prefetching thread gets to a part first, it is read once
+void VSDXPackageTest::testPrefetch()
+{
+  const char *const parts[] =
+  {
+    "visio/theme/theme1.xml",
+    "visio/masters/masters.xml",
+    "visio/masters/master1.xml",
+    "visio/masters/master3.xml",
+    "visio/pages/pages.xml",
+    "visio/pages/page1.xml"
+  };
+
+  CountingStream input(TDOC "/testfile1.vsdx");
+  libvisio::VSDXPackage package(&input);
+  package.prefetch("visio/document.xml");
+  for (const char *name : parts)
+    CPPUNIT_ASSERT(bool(package.getPartData(name)));
+  package.stopPrefetching();
+
+  for (const char *name : parts)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(name, 1u, input.getOpenCount(name));
+  CPPUNIT_ASSERT_EQUAL(0u, input.getOpenCount("visio/windows.xml"));
+}
+
+void VSDXPackageTest::testNotStructured()
+{
+  const unsigned char data[] = "not a zip";
+  librevenge::RVNGStringStream input(data, sizeof(data));
+  libvisio::VSDXPackage package(&input);
+  package.prefetch("visio/document.xml");
+  CPPUNIT_ASSERT(!package.getPartData("visio/document.xml"));
+  CPPUNIT_ASSERT(package.getRelationships("visio/document.xml").getRelationshipsByType(PAGES_TYPE).empty());
+
+  libvisio::VSDXPackage nullPackage(nullptr);
+  CPPUNIT_ASSERT(!nullPackage.getPart("visio/document.xml"));
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VSDXPackageTest);
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libvisio project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Measures how fast compressed VSD streams are decompressed.
+ *
+ * Usage: decompressbench [iterations]
+ *
+ * The input is generated: runs of literals mixed with back-references of
+ * every length, some closer than the longest match, so that both the block
+ * copies and the overlapping copies are taken.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <librevenge/librevenge.h>
+
+#include "VSDInternalStream.h"
+
+namespace
+{
+
+std::vector<unsigned char> makeInput(unsigned tokens)
+{
+  std::vector<unsigned char> data;
+  unsigned outputSize = 0;
+  unsigned seed = 12345;
+  for (unsigned i = 0; i < tokens; i += 8)
+  {
+    const std::size_t flagPos = data.size();
+    data.push_back(0);
+    for (unsigned bit = 0; bit < 8; ++bit)
+    {
+      seed = seed * 1103515245 + 12345;
+      const unsigned r = seed >> 16;
+      if (outputSize < 32 || r % 3 == 0)
+      {
+        data[flagPos] |= (unsigned char)(1u << bit);
+        data.push_back((unsigned char)('a' + r % 26));
+        ++outputSize;
+      }
+      else
+      {
+        const unsigned length = 3 + r % 16;
+        const unsigned distance = (r & 0x100) ? 1 + r % 17 : 18 + r % 1000;
+        const unsigned position = (outputSize - (distance < outputSize ? distance : outputSize)) & 4095;
+        const unsigned pointer = position >= 18 ? position - 18 : position + 4078;
+        data.push_back((unsigned char)(pointer & 0xff));
+        data.push_back((unsigned char)(((pointer >> 4) & 0xf0) | (length - 3)));
+        outputSize += length;
+      }
+    }
+  }
+  return data;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned iterations = argc > 1 ? (unsigned)std::atoi(argv[1]) : 200;
+  const std::vector<unsigned char> input = makeInput(1 << 20);
+  librevenge::RVNGBinaryData data(input.data(), input.size());
+
+  unsigned long outputSize = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < iterations; ++i)
+  {
+    VSDInternalStream stream(data.getDataStream(), data.size(), true);
+    outputSize += stream.getSize();
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::printf("%u iterations, %lu bytes in, %lu bytes out per iteration\n",
+              iterations, (unsigned long)input.size(), iterations ? outputSize / iterations : 0);
+  std::printf("%.3f s, %.1f MB/s of output\n", elapsed.count(),
+              elapsed.count() > 0 ? double(outputSize) / elapsed.count() / 1e6 : 0.0);
+  return 0;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -7,8 +7,12 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -174,8 +178,64 @@ void assertXPathContent(xmlDocPtr doc, const librevenge::RVNGString &xpath, cons
   CPPUNIT_ASSERT_EQUAL_MESSAGE(message.cstr(), content, getXPathContent(doc, xpath));
 }
 
+/// Returns the number of nodes that xpath finds.
+int countXPath(xmlDocPtr doc, const librevenge::RVNGString &xpath)
+{
+  CPPUNIT_ASSERT(doc);
+  std::unique_ptr<xmlXPathObject, void(*)(xmlXPathObjectPtr)> xpathobject{getXPathNode(doc, xpath), xmlXPathFreeObject};
+  return xmlXPathNodeSetGetLength(xpathobject->nodesetval);
+}
+
+/// Returns the points of the path actions that xpath finds.
+std::vector<std::pair<double, double> > getXPathPoints(xmlDocPtr doc, const librevenge::RVNGString &xpath)
+{
+  CPPUNIT_ASSERT(doc);
+  std::unique_ptr<xmlXPathObject, void(*)(xmlXPathObjectPtr)> xpathobject{getXPathNode(doc, xpath), xmlXPathFreeObject};
+  xmlNodeSetPtr nodeset = xpathobject->nodesetval;
+  std::vector<std::pair<double, double> > points;
+  for (int i = 0; i < xmlXPathNodeSetGetLength(nodeset); ++i)
+  {
+    xmlChar *x = xmlGetProp(nodeset->nodeTab[i], BAD_CAST("x"));
+    xmlChar *y = xmlGetProp(nodeset->nodeTab[i], BAD_CAST("y"));
+    CPPUNIT_ASSERT(x && y);
+    points.push_back(std::make_pair(atof(reinterpret_cast<const char *>(x)), atof(reinterpret_cast<const char *>(y))));
+    xmlFree(x);
+    xmlFree(y);
+  }
+  return points;
+}
+
+/// Asserts that the polyline through points stays within tolerance of the circle,
+/// going around it once, in the same direction.
+void assertCircularArc(const std::vector<std::pair<double, double> > &points, double centreX, double centreY,
+                       double radius, double sweep, double tolerance)
+{
+  CPPUNIT_ASSERT(points.size() > 2);
+  double swept = 0.0;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    // The output is rounded to 0.0001in
+    const double x = points[i].first - centreX;
+    const double y = points[i].second - centreY;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(radius, hypot(x, y), 0.0001);
+    if (i == 0)
+      continue;
+    const double previousX = points[i - 1].first - centreX;
+    const double previousY = points[i - 1].second - centreY;
+    const double midX = (x + previousX) / 2.0;
+    const double midY = (y + previousY) / 2.0;
+    CPPUNIT_ASSERT(radius - hypot(midX, midY) <= tolerance + 0.0001);
+    const double angle = atan2(previousX * y - previousY * x, previousX * x + previousY * y);
+    CPPUNIT_ASSERT(angle * sweep >= 0.0);
+    swept += angle;
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(sweep, swept, 0.001);
+}
+
 /// Paints an XML representation of filename into buffer, then returns the parsed buffer content.
-xmlDocPtr parse(const char *filename, xmlBufferPtr buffer)
+/// Only the pages in pages are painted, unless it is empty.
+xmlDocPtr parse(const char *filename, xmlBufferPtr buffer, const std::vector<unsigned> &pages = std::vector<unsigned>(),
+                const libvisio::VisioParseOptions &options = libvisio::VisioParseOptions())
 {
   librevenge::RVNGString path(TDOC "/");
   path.append(filename);
@@ -187,7 +247,10 @@ xmlDocPtr parse(const char *filename, xmlBufferPtr buffer)
   xmlTextWriterStartDocument(writer, 0, 0, 0);
   libvisio::XmlDrawingGenerator painter(writer);
 
-  CPPUNIT_ASSERT(libvisio::VisioDocument::parse(&input, &painter));
+  if (pages.empty())
+    CPPUNIT_ASSERT(libvisio::VisioDocument::parse(&input, &painter, options));
+  else
+    CPPUNIT_ASSERT(libvisio::VisioDocument::parsePages(&input, &painter, pages, options));
 
   xmlTextWriterEndDocument(writer);
   xmlFreeTextWriter(writer);
@@ -219,6 +282,9 @@ class ImportTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testVsdxTextBkgndColorFromStylesheet);
   CPPUNIT_TEST(testVsdNumericFormat);
   CPPUNIT_TEST(testVsdDateTimeFormatting);
+  CPPUNIT_TEST(testVsdPageSelection);
+  CPPUNIT_TEST(testVsdBackgroundPageSelection);
+  CPPUNIT_TEST(testVsdLoadDrawPage);
   CPPUNIT_TEST(testVsd11FormatLine);
   CPPUNIT_TEST(testVsd11TextfieldsWithAngle);
   CPPUNIT_TEST(testVsd11TextfieldsWithUnits);
@@ -238,6 +304,16 @@ class ImportTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST(testVsdxPageSelfReferenceCycle);
   CPPUNIT_TEST(testVsdxTabRowShortPrefix);
 
+  CPPUNIT_TEST(testVdxCurvesAsBezier);
+  CPPUNIT_TEST(testVdxCurvesAsCubicBezier);
+  CPPUNIT_TEST(testVdxCurvesAsLines);
+  CPPUNIT_TEST(testVdxAbsoluteCurveTolerance);
+  CPPUNIT_TEST(testVdxRelativeCurveTolerance);
+  CPPUNIT_TEST(testVdxRationalCurves);
+
+  CPPUNIT_TEST(testVdxGroupTransforms);
+  CPPUNIT_TEST(testVdxMasterInstances);
+
   CPPUNIT_TEST_SUITE_END();
 
   void testVsd6Textfields();
@@ -253,6 +329,9 @@ class ImportTest : public CPPUNIT_NS::TestFixture
   void testVsdNumericFormat();
   void testVsd11FormatLine();
   void testVsdDateTimeFormatting();
+  void testVsdPageSelection();
+  void testVsdBackgroundPageSelection();
+  void testVsdLoadDrawPage();
   void testVsd11TextfieldsWithAngle();
   void testVsd11TextfieldsWithUnits();
   void testVsd11DrawingUnitsType();
@@ -273,6 +352,16 @@ class ImportTest : public CPPUNIT_NS::TestFixture
   void testVsdxPageSelfReferenceCycle();
   void testVsdxTabRowShortPrefix();
 
+  void testVdxCurvesAsBezier();
+  void testVdxCurvesAsCubicBezier();
+  void testVdxCurvesAsLines();
+  void testVdxAbsoluteCurveTolerance();
+  void testVdxRelativeCurveTolerance();
+  void testVdxRationalCurves();
+
+  void testVdxGroupTransforms();
+  void testVdxMasterInstances();
+
   xmlBufferPtr m_buffer;
   xmlDocPtr m_doc;
 
@@ -446,6 +535,40 @@ void ImportTest::testVsdDateTimeFormatting()
   assertXPathContent(m_doc, "/document/page/textObject/paragraph/span/insertText", "11/30/2005");
 }
 
+void ImportTest::testVsdPageSelection()
+{
+  // The background page is not output on its own
+  m_doc = parse("tdf76829-datetime-format.vsd", m_buffer, std::vector<unsigned>(1, 0));
+  assertXPath(m_doc, "/document/page", "name", "Zeichenblatt-1");
+  assertXPathContent(m_doc, "/document/page/textObject/paragraph/span/insertText", "11/30/2005");
+}
+
+void ImportTest::testVsdBackgroundPageSelection()
+{
+  m_doc = parse("tdf76829-datetime-format.vsd", m_buffer, std::vector<unsigned>(1, 1));
+  assertXPath(m_doc, "/document/page", "name", "VHintergrund");
+}
+
+void ImportTest::testVsdLoadDrawPage()
+{
+  librevenge::RVNGFileStream input(TDOC "/tdf76829-datetime-format.vsd");
+  const std::shared_ptr<const libvisio::VisioDocumentHandle> document = libvisio::VisioDocument::load(&input);
+  CPPUNIT_ASSERT(document);
+  CPPUNIT_ASSERT_EQUAL(2U, document->pageCount());
+
+  xmlTextWriterPtr writer = xmlNewTextWriterMemory(m_buffer, 0);
+  CPPUNIT_ASSERT(writer);
+  xmlTextWriterStartDocument(writer, 0, 0, 0);
+  libvisio::XmlDrawingGenerator painter(writer);
+  CPPUNIT_ASSERT(!document->drawPage(&painter, 2));
+  CPPUNIT_ASSERT(document->drawPage(&painter, 1));
+  xmlTextWriterEndDocument(writer);
+  xmlFreeTextWriter(writer);
+
+  m_doc = xmlParseMemory((const char *)xmlBufferContent(m_buffer), xmlBufferLength(m_buffer));
+  assertXPath(m_doc, "/document/page", "name", "VHintergrund");
+}
+
 
 // tdf#126402
 void ImportTest::testVsd11FormatLine()
@@ -696,6 +819,147 @@ void ImportTest::testVsdxPageSelfReferenceCycle()
   xmlFreeTextWriter(writer);
 }
 
+// splines.vdx has a quadratic spline without weights, then two rational
+// quarter circles, of radius 2in and 4in, then a rational circle of radius 1in
+// that is made of four quarters.
+void ImportTest::testVdxCurvesAsBezier()
+{
+  m_doc = parse("splines.vdx", m_buffer);
+  assertXPath(m_doc, "/document/page/drawPath[1]/pathAction[2]", "path-action", "Q");
+  assertXPath(m_doc, "/document/page/drawPath[1]/pathAction[2]", "x1", "2.0000in");
+  assertXPath(m_doc, "/document/page/drawPath[1]/pathAction[2]", "y1", "8.5000in");
+  CPPUNIT_ASSERT_EQUAL(2, countXPath(m_doc, "/document/page/drawPath[1]/pathAction"));
+  // Weights cannot be kept in Bezier segments
+  CPPUNIT_ASSERT_EQUAL(0, countXPath(m_doc, "/document/page/drawPath[2]/pathAction[@path-action!='M' and @path-action!='L']"));
+}
+
+void ImportTest::testVdxCurvesAsCubicBezier()
+{
+  libvisio::VisioParseOptions options;
+  options.setCurveOutput(libvisio::VisioParseOptions::CURVES_AS_CUBIC_BEZIER);
+  m_doc = parse("splines.vdx", m_buffer, std::vector<unsigned>(), options);
+  assertXPath(m_doc, "/document/page/drawPath[1]/pathAction[2]", "path-action", "C");
+  CPPUNIT_ASSERT_EQUAL(2, countXPath(m_doc, "/document/page/drawPath[1]/pathAction"));
+}
+
+void ImportTest::testVdxCurvesAsLines()
+{
+  libvisio::VisioParseOptions options;
+  options.setCurveOutput(libvisio::VisioParseOptions::CURVES_AS_LINES);
+  m_doc = parse("splines.vdx", m_buffer, std::vector<unsigned>(), options);
+  CPPUNIT_ASSERT(countXPath(m_doc, "/document/page/drawPath[1]/pathAction") > 2);
+  CPPUNIT_ASSERT_EQUAL(0, countXPath(m_doc, "/document/page/drawPath/pathAction[@path-action!='M' and @path-action!='L' and @path-action!='Z']"));
+  assertXPath(m_doc, "/document/page/drawPath[1]/pathAction[last()]", "x", "3.0000in");
+  assertXPath(m_doc, "/document/page/drawPath[1]/pathAction[last()]", "y", "9.5000in");
+}
+
+// The larger circle needs more segments to stay as close
+void ImportTest::testVdxAbsoluteCurveTolerance()
+{
+  libvisio::VisioParseOptions options;
+  options.setCurveTolerance(0.01);
+  m_doc = parse("splines.vdx", m_buffer, std::vector<unsigned>(), options);
+  const int smallCount = countXPath(m_doc, "/document/page/drawPath[2]/pathAction");
+  const int largeCount = countXPath(m_doc, "/document/page/drawPath[3]/pathAction");
+  CPPUNIT_ASSERT(smallCount > 2);
+  CPPUNIT_ASSERT(largeCount > smallCount);
+}
+
+// Relative to the size of the spline, both circles need as many segments
+void ImportTest::testVdxRelativeCurveTolerance()
+{
+  libvisio::VisioParseOptions options;
+  options.setCurveTolerance(0.01, true);
+  CPPUNIT_ASSERT(options.isCurveToleranceRelative());
+  m_doc = parse("splines.vdx", m_buffer, std::vector<unsigned>(), options);
+  const int smallCount = countXPath(m_doc, "/document/page/drawPath[2]/pathAction");
+  CPPUNIT_ASSERT(smallCount > 2);
+  CPPUNIT_ASSERT_EQUAL(smallCount, countXPath(m_doc, "/document/page/drawPath[3]/pathAction"));
+
+  // A coarser tolerance needs fewer segments
+  xmlFreeDoc(m_doc);
+  xmlBufferEmpty(m_buffer);
+  options.setCurveTolerance(0.05, true);
+  m_doc = parse("splines.vdx", m_buffer, std::vector<unsigned>(), options);
+  CPPUNIT_ASSERT(countXPath(m_doc, "/document/page/drawPath[2]/pathAction") < smallCount);
+}
+
+// The flattened rational curves stay on their circles, like the ones sampled at
+// 100 points per knot did, with a fraction of their points
+void ImportTest::testVdxRationalCurves()
+{
+  m_doc = parse("splines.vdx", m_buffer);
+  const double halfPi = atan(1.0) * 2.0;
+  const std::vector<std::pair<double, double> > small = getXPathPoints(m_doc, "/document/page/drawPath[2]/pathAction");
+  assertCircularArc(small, 4.0, 7.0, 2.0, -halfPi, 0.001);
+  CPPUNIT_ASSERT(small.size() < 100);
+  const std::vector<std::pair<double, double> > large = getXPathPoints(m_doc, "/document/page/drawPath[3]/pathAction");
+  assertCircularArc(large, 3.0, 8.0, 4.0, -halfPi, 0.001);
+  CPPUNIT_ASSERT(large.size() < 200);
+  // The four spans join without zero-length segments, and the circle is closed
+  const std::vector<std::pair<double, double> > circle = getXPathPoints(m_doc, "/document/page/drawPath[4]/pathAction[@path-action!='Z']");
+  assertCircularArc(circle, 4.0, 8.0, 1.0, -4.0 * halfPi, 0.001);
+  CPPUNIT_ASSERT(circle.size() < 400);
+  for (size_t i = 1; i < circle.size(); ++i)
+    CPPUNIT_ASSERT(circle[i] != circle[i - 1]);
+  CPPUNIT_ASSERT(circle.front() == circle.back());
+  assertXPath(m_doc, "/document/page/drawPath[4]/pathAction[last()]", "path-action", "Z");
+}
+
+// Shapes in rotated and flipped groups, then shapes that are in no group
+void ImportTest::testVdxGroupTransforms()
+{
+  m_doc = parse("groups.vdx", m_buffer);
+  // In a group rotated by 30 degrees and flipped horizontally
+  assertXPath(m_doc, "/document/page[1]/drawPath[1]/pathAction[1]", "x", "5.5490in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[1]/pathAction[1]", "y", "6.6830in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[1]/pathAction[3]", "x", "4.1830in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[1]/pathAction[3]", "y", "6.3170in");
+  // In a group rotated by 90 degrees and flipped vertically, nested in the first one
+  assertXPath(m_doc, "/document/page[1]/drawPath[2]/pathAction[1]", "x", "3.8170in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[2]/pathAction[1]", "y", "7.6830in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[2]/pathAction[3]", "x", "2.4510in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[2]/pathAction[3]", "y", "7.3170in");
+  // After the groups
+  assertXPath(m_doc, "/document/page[1]/drawPath[3]/pathAction[1]", "x", "5.5000in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[3]/pathAction[1]", "y", "3.5000in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[3]/pathAction[3]", "x", "6.5000in");
+  assertXPath(m_doc, "/document/page[1]/drawPath[3]/pathAction[3]", "y", "2.5000in");
+  // The same shape ID on a page with another height
+  assertXPath(m_doc, "/document/page[2]/drawPath[1]/pathAction[1]", "x", "1.5000in");
+  assertXPath(m_doc, "/document/page[2]/drawPath[1]/pathAction[1]", "y", "7.0000in");
+  assertXPath(m_doc, "/document/page[2]/drawPath[1]/pathAction[3]", "x", "2.5000in");
+  assertXPath(m_doc, "/document/page[2]/drawPath[1]/pathAction[3]", "y", "6.0000in");
+}
+
+// The overrides of one instance of a master must not reach the others
+void ImportTest::testVdxMasterInstances()
+{
+  m_doc = parse("masters.vdx", m_buffer);
+  assertXPath(m_doc, "/document/page/layer[1]/layer/setStyle[1]", "fill-color", "#00ff00");
+  assertXPath(m_doc, "/document/page/layer[1]/layer/setStyle[1]", "stroke-color", "#ff0000");
+  assertXPath(m_doc, "/document/page/layer[1]/layer/setStyle[1]", "stroke-width", "0.0200in");
+  assertXPathContent(m_doc, "/document/page/layer[1]/textObject/paragraph/span/insertText", "Master");
+
+  assertXPath(m_doc, "/document/page/layer[2]/layer/setStyle[1]", "fill-color", "#ffff00");
+  assertXPath(m_doc, "/document/page/layer[2]/layer/setStyle[1]", "stroke-color", "#0000ff");
+  assertXPath(m_doc, "/document/page/layer[2]/layer/setStyle[1]", "stroke-width", "0.0200in");
+  assertXPathContent(m_doc, "/document/page/layer[2]/textObject/paragraph/span/insertText", "Own");
+
+  assertXPath(m_doc, "/document/page/layer[3]/layer/setStyle[1]", "fill-color", "#00ff00");
+  assertXPath(m_doc, "/document/page/layer[3]/layer/setStyle[1]", "stroke-color", "#ff0000");
+  assertXPathContent(m_doc, "/document/page/layer[3]/textObject/paragraph/span/insertText", "Master");
+  assertXPath(m_doc, "/document/page/layer[3]/layer/drawPath[1]/pathAction[1]", "x", "5.5000in");
+
+  // Both instances of the picture get the bitmap with its file header
+  assertXPath(m_doc, "/document/page/drawGraphicObject[1]", "x", "1.5000in");
+  assertBmpDataOffset(m_doc, "/document/page/drawGraphicObject[1]", 54);
+  assertXPath(m_doc, "/document/page/drawGraphicObject[2]", "x", "3.5000in");
+  assertBmpDataOffset(m_doc, "/document/page/drawGraphicObject[2]", 54);
+  CPPUNIT_ASSERT_EQUAL(getXPath(m_doc, "/document/page/drawGraphicObject[1]", "binary-data"),
+                       getXPath(m_doc, "/document/page/drawGraphicObject[2]", "binary-data"));
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(ImportTest);
 
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -206,6 +206,22 @@ void XmlDrawingGenerator::drawPath(const librevenge::RVNGPropertyList &propList)
   librevenge::RVNGPropertyList::Iter i(propList);
   for (i.rewind(); i.next();)
     xmlTextWriterWriteFormatAttribute(m_writer, BAD_CAST(i.key()), "%s", i()->getStr().cstr());
+  const librevenge::RVNGPropertyListVector *path = propList.child("svg:d");
+  if (path)
+  {
+    for (unsigned long j = 0; j < path->count(); ++j)
+    {
+      // Without their prefixes, so that XPath can get at the attributes
+      xmlTextWriterStartElement(m_writer, BAD_CAST("pathAction"));
+      librevenge::RVNGPropertyList::Iter k((*path)[j]);
+      for (k.rewind(); k.next();)
+      {
+        const char *const name = strchr(k.key(), ':');
+        xmlTextWriterWriteFormatAttribute(m_writer, BAD_CAST(name ? name + 1 : k.key()), "%s", k()->getStr().cstr());
+      }
+      xmlTextWriterEndElement(m_writer);
+    }
+  }
   xmlTextWriterEndElement(m_writer);
 }
 